@@ -2622,6 +2622,8 @@ struct JET_THREADSTATS3
 };
 #endif
 
+#define JET_cbOpNameMost            64
+
 #if ( JET_VERSION >= 0x0A01 )
 struct JET_THREADSTATS4
 {
@@ -2654,6 +2656,16 @@ struct JET_THREADSTATS4
     unsigned long       cPageUpdateReleased;
     unsigned long       cPageUniqueModified;
 };
+
+typedef struct
+{
+    unsigned long           cbStruct;
+    char                    szOp[ JET_cbOpNameMost ];
+    long                    err;
+    unsigned __int64        cusecElapsed;
+    unsigned __int64        cCPUCycles;
+    struct JET_THREADSTATS4 threadstats;
+} JET_OPSTATS;
 #endif
 
 #if ( JET_VERSION >= 0x0603 )
@@ -2981,6 +2993,24 @@ typedef struct
     unsigned long long      cbLogicalFileSize;
 } JET_RBSINFOMISC;
 
+typedef struct
+{
+    void *                  pvLock;
+    void *                  pvCallSite;
+    unsigned long           cSamples;
+    unsigned long long      cusecWaitTotal;
+    unsigned long long      cusecWaitMax;
+} JET_LOCKCONTENTION;
+
+typedef struct
+{
+    char                    szOp[ JET_cbOpNameMost ];
+    unsigned long long      cSamples;
+    unsigned long long      cusecP50;
+    unsigned long long      cusecP99;
+    unsigned long long      cusecP999;
+} JET_APILATENCY;
+
 typedef struct
 {
     long                    lGenMinRevertStart;
@@ -3446,10 +3476,18 @@ typedef enum
 #define JET_paramEnableRBS                      215
 #define JET_paramRBSFilePath                    216
 
+#define JET_paramDbExtensionAsyncHeadroom       217
+
+#define JET_paramEnableChangedPageTracking      218
+
+#define JET_paramLockContentionSampleRate       219
+
+#define JET_paramEnableOpStats                  220
+
 #endif
 
 
-#define JET_paramMaxValueInvalid                217
+#define JET_paramMaxValueInvalid                221
 
 #if ( JET_VERSION >= 0x0A01 )
 
@@ -3482,9 +3520,11 @@ typedef enum
 #define JET_sesparamIOPriority              4108
 
 #define JET_sesparamCommitContextContainsCustomerData   4109
+
+#define JET_sesparamOpStats                 4110
 #endif
 
-#define JET_sesparamMaxValueInvalid         4110
+#define JET_sesparamMaxValueInvalid         4111
 
 typedef struct
 {
@@ -3657,6 +3697,9 @@ typedef struct
 #define JET_bitBackupSurrogate          0x00000020
 #endif
 #define JET_bitInternalCopy         0x00000040
+#if ( JET_VERSION >= 0x0A01 )
+#define JET_bitBackupChangedPages       0x00000080
+#endif
 
 
 
@@ -4638,6 +4681,8 @@ typedef JET_ERR (JET_API * JET_PFNEMITLOGDATA)(
 #if ( JET_VERSION >= 0x0A01 )
 
 #define JET_InstanceMiscInfoRBS             2U
+#define JET_InstanceMiscInfoLockContention  3U
+#define JET_InstanceMiscInfoApiLatency      4U
 
 #endif
 
@@ -10287,6 +10332,7 @@ typedef enum
     opTestHookGetTablePgnoFDP,
     opTestHookAlterDatabaseFileHeader,
     opTestHookGetLogTip,
+    opTestHookUnitBenchmarks,
 } TESTHOOK_OP;
 
 
@@ -10321,6 +10367,14 @@ typedef struct tagJET_TESTHOOKUNITTEST2
     JET_DBID            dbidTestOn;
 } JET_TESTHOOKUNITTEST2;
 
+typedef struct tagJET_TESTHOOKUNITBENCHMARK
+{
+    unsigned long       cbStruct;
+    char *              szBenchmarkName;
+    char *              szJsonFile;
+    long                cRuns;
+} JET_TESTHOOKUNITBENCHMARK;
+
 #define bitHangInjectSleep          0x40000000
 #define mskHangInjectOptions        ( bitHangInjectSleep | 0xFFFF0000 )
 
@@ -42,7 +42,10 @@ public:
         m_pTaskInfoGenericStats( pTaskInfoGenericStats ),
         m_dwPostTick(0),
         m_dwDispatchTick(0),
-        m_dwEndTick(0)
+        m_dwEndTick(0),
+        m_hrtPost(0),
+        m_hrtDispatch(0),
+        m_hrtEnd(0)
         {}
 
     ~TaskInfoGeneric() {}
@@ -59,6 +62,10 @@ private:
 
     DWORD   m_dwEndTick;
 
+    HRT     m_hrtPost;
+    HRT     m_hrtDispatch;
+    HRT     m_hrtEnd;
+
     TaskInfoGenericStats * m_pTaskInfoGenericStats;
 };
 
@@ -75,13 +82,28 @@ public:
         m_dwLastReportExecute( 0 ),
         m_dwLastReportEndTick( 0 ),
         m_cLastReportNotReported( 0 ),
-        m_critStats( CLockBasicInfo( CSyncBasicInfo( "TaskInfoStats" ), 0, 0 ) ) {}
+        m_critStats( CLockBasicInfo( CSyncBasicInfo( "TaskInfoStats" ), 0, 0 ) )
+    {
+        memset( (void*)m_rgcDispatch, 0, sizeof( m_rgcDispatch ) );
+        memset( (void*)m_rgcExecute, 0, sizeof( m_rgcExecute ) );
+    }
 
     ~TaskInfoGenericStats() {}
 
 public:
     void ReportTaskInfo(const TaskInfoGeneric & taskInfo);
 
+
+    //  log2 microsecond buckets: bucket 0 is < 1us, bucket i is [ 2^(i-1), 2^i ) us
+
+    enum { cLatencyBucket = 32 };
+
+    static ULONG IBucketFromCusec( const QWORD cusec );
+    static QWORD CusecPercentile( const LONG * const rgcBucket, const ULONG ulPermille );
+
+    QWORD CusecDispatchPercentile( const ULONG ulPermille ) const   { return CusecPercentile( (const LONG *)m_rgcDispatch, ulPermille ); }
+    QWORD CusecExecutePercentile( const ULONG ulPermille ) const    { return CusecPercentile( (const LONG *)m_rgcExecute, ulPermille ); }
+
 private:
     CCriticalSection  m_critStats;
 
@@ -100,6 +122,8 @@ private:
     QWORD   m_qwExecuteTickTotal;
     QWORD   m_qwTotalTickTotal;
 
+    volatile LONG   m_rgcDispatch[ cLatencyBucket ];
+    volatile LONG   m_rgcExecute[ cLatencyBucket ];
 };
 
 
@@ -137,11 +161,57 @@ class CTaskManager
         typedef CInvasiveList< CTaskNode, CTaskNode::OffsetOfILE > TaskList;
 
 
+        struct TASK
+        {
+            PfnCompletion   pfnCompletion;
+            DWORD           dwCompletionKey1;
+            DWORD_PTR       dwCompletionKey2;
+        };
+
+
+        //  bounded lock-free multi-producer / multi-consumer ring of tasks (Vyukov)
+
+        template< ULONG cSlot >
+        class CTaskRing
+        {
+            public:
+
+                CTaskRing();
+                ~CTaskRing() {}
+
+                BOOL FTryPush( const TASK& task );
+                BOOL FTryPop( TASK * const ptask );
+
+            private:
+
+                C_ASSERT( 0 == ( cSlot & ( cSlot - 1 ) ) );
+
+                struct SLOT
+                {
+                    volatile ULONG  ulSeq;
+                    TASK            task;
+                };
+
+                volatile ULONG      m_ulTail;
+                BYTE                m_rgbPadTail[ 64 - sizeof( ULONG ) ];
+                volatile ULONG      m_ulHead;
+                BYTE                m_rgbPadHead[ 64 - sizeof( ULONG ) ];
+                SLOT                m_rgslot[ cSlot ];
+        };
+
+        enum { cTaskRingGlobal = 256 };
+        enum { cTaskRingLocal = 64 };
+
+        typedef CTaskRing< cTaskRingGlobal > TaskRingGlobal;
+        typedef CTaskRing< cTaskRingLocal > TaskRingLocal;
+
+
         struct THREADCONTEXT
         {
             THREAD          thread;
             CTaskManager    *ptm;
             DWORD_PTR       dwThreadContext;
+            TaskRingLocal   *ptaskring;
         };
 
         struct COMPLETIONPACKETINFO
@@ -170,7 +240,8 @@ class CTaskManager
 
         ERR ErrTMInit(  const ULONG                     cThread,
                         const DWORD_PTR *const          rgThreadContext     = NULL,
-                        const BOOL                      fForceMaxThreads    = fFalse );
+                        const BOOL                      fForceMaxThreads    = fFalse,
+                        const BOOL                      fUseIOCP            = fFalse );
         VOID TMTerm();
 
 
@@ -186,7 +257,10 @@ class CTaskManager
     private:
 
         static DWORD TMDispatch( DWORD_PTR dwContext );
-        VOID TMIDispatch( const DWORD_PTR dwThreadContext );
+        VOID TMIDispatch( THREADCONTEXT * const ptc );
+
+        ERR ErrTMIPush( const TASK& task );
+        VOID TMIPop( THREADCONTEXT * const ptc, TASK * const ptask );
 
         BOOL    FTMIFileIOCompletion( CTaskManager::PfnCompletion pfnCompletion );
 
@@ -207,6 +281,10 @@ class CTaskManager
         volatile ULONG                  m_cThread;
         THREADCONTEXT                   *m_rgThreadContext;
 
+        BOOL                            m_fUseIOCP;
+        TaskRingGlobal                  *m_ptaskringGlobal;
+        volatile LONG                   m_cTaskOverflow;
+
         TaskList                        m_ilTask;
         CCriticalSection                m_critTask;
         CSemaphore                      m_semTaskDispatch;
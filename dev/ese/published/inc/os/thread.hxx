@@ -45,6 +45,9 @@ const DWORD UtilThreadEnd( const THREAD Thread );
 const DWORD DwUtilThreadId();
 
 
+const QWORD CcycUtilThreadCPU();
+
+
 void UtilThreadBeginLowIOPriority(void);
 void UtilThreadEndLowIOPriority(void);
 
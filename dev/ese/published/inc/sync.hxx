@@ -217,7 +217,21 @@ void* OSSYNCAPI OSSyncGetProcessorLocalStorage();
 void* OSSYNCAPI OSSyncGetProcessorLocalStorage( const size_t iProc );
 
 
-#ifdef SYNC_ANALYZE_PERFORMANCE
+
+struct OSSYNCLOCKCONTENTION
+{
+    const void*     pvLock;
+    const void*     pvCallSite;
+    DWORD           cSamples;
+    QWORD           cusecWaitTotal;
+    QWORD           cusecWaitMax;
+};
+
+
+void OSSYNCAPI OSSyncSetLockContentionSampleRate( const DWORD cSampleRate );
+
+
+size_t OSSYNCAPI COSSyncGetLockContention( OSSYNCLOCKCONTENTION* const rglc, const size_t clcMax );
 
 
 
@@ -226,8 +240,6 @@ QWORD OSSYNCAPI QwOSSyncIHRTFreq();
 
 QWORD OSSYNCAPI QwOSSyncIHRTCount();
 
-#endif
-
 
 #ifndef RTM
 
@@ -1773,6 +1785,7 @@ class CSemaphore
 
 
         void Acquire();
+        void AcquireForLock( const void* const pvLock, const void* const pvCallSite );
         void Wait();
         const BOOL FTryAcquire();
         const BOOL FAcquire( const INT cmsecTimeout );
@@ -1795,6 +1808,8 @@ class CSemaphore
 
 
         const BOOL _FAcquire( const INT cmsecTimeout );
+        const BOOL _FAcquire( const INT cmsecTimeout, const void* const pvLock, const void* const pvCallSite );
+        const BOOL _FAcquireWait( const INT cmsecTimeout );
         const BOOL _FWait( const INT cmsecTimeout );
         void _Release( const INT cToRelease );
 };
@@ -1808,6 +1823,16 @@ inline void CSemaphore::Acquire()
 }
 
 
+//  used by locks built on a semaphore so that sampled contention is charged to the lock and its caller
+
+inline void CSemaphore::AcquireForLock( const void* const pvLock, const void* const pvCallSite )
+{
+
+    INT fAcquire = FTryAcquire() || _FAcquire( cmsecInfinite, pvLock, pvCallSite );
+    OSSYNCAssert( fAcquire );
+}
+
+
 inline void CSemaphore::Wait()
 {
 
@@ -5264,6 +5289,158 @@ inline void CReaderWriterLock::LeaveAsReader()
 
 
 
+class CBigReaderWriterLock
+    :   private CLockObject
+{
+    public:
+
+
+
+        enum { cStripe = 32 };
+
+
+
+        CBigReaderWriterLock( const CLockBasicInfo& lbi );
+        ~CBigReaderWriterLock();
+
+
+        void EnterAsWriter();
+        const BOOL FTryEnterAsWriter();
+        void LeaveAsWriter();
+
+        INT EnterAsReader();
+        const BOOL FTryEnterAsReader( INT* const piStripe );
+        void LeaveAsReader( const INT iStripe );
+
+
+        const BOOL FWriterActive() const    { return m_fWriter; }
+
+
+        void Dump( const CDumpContext& dc ) const;
+
+    private:
+
+
+
+        CBigReaderWriterLock& operator=( CBigReaderWriterLock& ) = delete;
+
+
+        const BOOL _FReadersDrained() const;
+        void _WaitForReadersToDrain();
+        void _WaitForWriter();
+
+
+
+        //  each stripe owns a whole cache line, the alignment also starts m_rgstripe on a line boundary
+
+        enum { cbStripe = 64 };
+
+        struct __declspec( align( 64 ) ) CReaderStripe
+        {
+            volatile LONG   m_cReader;
+            BYTE            m_rgbPad[ cbStripe - sizeof( LONG ) ];
+        };
+
+
+        CReaderStripe           m_rgstripe[ cStripe ];
+
+
+        volatile LONG           m_fWriter;
+
+
+        CReaderWriterLock       m_rwlWriter;
+
+
+        CAutoResetSignal        m_asigReadersDrained;
+};
+
+
+inline void CBigReaderWriterLock::EnterAsWriter()
+{
+
+    m_rwlWriter.EnterAsWriter();
+
+
+    AtomicExchange( (LONG*)&m_fWriter, fTrue );
+    _WaitForReadersToDrain();
+}
+
+
+inline const BOOL CBigReaderWriterLock::FTryEnterAsWriter()
+{
+    if ( !m_rwlWriter.FTryEnterAsWriter() )
+    {
+        return fFalse;
+    }
+
+    AtomicExchange( (LONG*)&m_fWriter, fTrue );
+    if ( !_FReadersDrained() )
+    {
+        AtomicExchange( (LONG*)&m_fWriter, fFalse );
+        m_rwlWriter.LeaveAsWriter();
+        return fFalse;
+    }
+
+    return fTrue;
+}
+
+
+inline void CBigReaderWriterLock::LeaveAsWriter()
+{
+    OSSYNCAssert( m_fWriter );
+
+    AtomicExchange( (LONG*)&m_fWriter, fFalse );
+    m_rwlWriter.LeaveAsWriter();
+}
+
+
+inline INT CBigReaderWriterLock::EnterAsReader()
+{
+    OSSYNC_FOREVER
+    {
+        INT iStripe;
+        if ( FTryEnterAsReader( &iStripe ) )
+        {
+            return iStripe;
+        }
+
+
+        _WaitForWriter();
+    }
+}
+
+
+inline const BOOL CBigReaderWriterLock::FTryEnterAsReader( INT* const piStripe )
+{
+    const INT iStripe = OSSyncGetCurrentProcessor() % cStripe;
+
+
+    AtomicIncrement( (LONG*)&m_rgstripe[ iStripe ].m_cReader );
+    if ( !m_fWriter )
+    {
+        *piStripe = iStripe;
+        return fTrue;
+    }
+
+    LeaveAsReader( iStripe );
+    return fFalse;
+}
+
+
+inline void CBigReaderWriterLock::LeaveAsReader( const INT iStripe )
+{
+    OSSYNCAssert( iStripe >= 0 && iStripe < cStripe );
+    OSSYNCAssert( m_rgstripe[ iStripe ].m_cReader > 0 );
+
+
+    if ( AtomicDecrement( (LONG*)&m_rgstripe[ iStripe ].m_cReader ) == 0 && m_fWriter )
+    {
+        m_asigReadersDrained.Set();
+    }
+}
+
+
+
 class CMeteredSection
     :   private CSyncObject
 {
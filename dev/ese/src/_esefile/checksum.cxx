@@ -9,7 +9,9 @@
 INT g_cbPage;
 INT g_cpagesPerBlock;
 
-static const INT cblocks            = g_cbBufferTotal / g_cbReadBuffer;
+static const INT cblocksMin         = g_cbBufferTotal / g_cbReadBuffer;
+static const INT cblocksMax         = 64;
+static INT cblocks;
 
 
 struct CHECKSUM_STATS
@@ -22,7 +24,7 @@ struct CHECKSUM_STATS
     DWORD               cpagesWrongPgno;
     unsigned __int64    dbtimeHighest;
     DWORD               pgnoDbtimeHighest;
-    DWORD               dwFiller;
+    DWORD               cpagesBadSiblingLink;
 
 
     LONG                cIOs;
@@ -45,8 +47,29 @@ struct JETPAGE
     DWORD               dwChecksum;
     DWORD               pgno;
     unsigned __int64    dbtime;
+    DWORD               pgnoPrev;
+    DWORD               pgnoNext;
+    DWORD               objidFDP;
+    WORD                cbFree;
+    WORD                cbUncommittedFree;
+    WORD                ibMicFree;
+    WORD                itagMicFree;
+    DWORD               fFlags;
 };
 
+const DWORD fPageEmpty              = 0x0008;
+
+
+struct PAGESUMMARY
+{
+    DWORD               pgnoPrev;
+    DWORD               pgnoNext;
+    DWORD               objidFDP;
+};
+
+const DWORD objidSummaryNone        = 0;
+const DWORD objidSummaryUnknown     = 0xFFFFFFFF;
+
 
 class CChecksumContext
 {
@@ -56,16 +79,19 @@ class CChecksumContext
                             CHECKSUM_STATS* const   pchecksumstatsIn,
                             CSemaphore* const       psemIn,
                             IFileAPI* const         pfapiIn,
-                            BYTE* const             pbDataIn )
+                            BYTE* const             pbDataIn,
+                            PAGESUMMARY* const      rgpagesummaryIn )
             :   ptaskmgr( ptaskmgrIn ),
                 pchecksumstats( pchecksumstatsIn ),
                 psem( psemIn ),
                 pfapi( pfapiIn ),
                 pbData( pbDataIn ),
+                rgpagesummary( rgpagesummaryIn ),
                 ibOffset( 0 ),
                 cbData( 0 ),
                 hrtStart( 0 )
         {
+            memset( &checksumstatsPages, 0, sizeof( checksumstatsPages ) );
         }
 
         ~CChecksumContext()
@@ -82,6 +108,8 @@ class CChecksumContext
         CSemaphore* const       psem;
         IFileAPI* const         pfapi;
         BYTE* const             pbData;
+        PAGESUMMARY* const      rgpagesummary;
+        CHECKSUM_STATS          checksumstatsPages;
         QWORD                   ibOffset;
         DWORD                   cbData;
         QWORD                   hrtStart;
@@ -98,6 +126,7 @@ static void PrintChecksumStats(
     (void)wprintf( L"%d correctable checksums\r\n", pchecksumstats->cpagesCorrectableChecksum );
     (void)wprintf( L"%d uninitialized pages\r\n", pchecksumstats->cpagesUninit );
     (void)wprintf( L"%d wrong page numbers\r\n", pchecksumstats->cpagesWrongPgno );
+    (void)wprintf( L"%d sibling link mismatches\r\n", pchecksumstats->cpagesBadSiblingLink );
     (void)wprintf( L"0x%I64x highest dbtime (pgno 0x%x)\r\n", pchecksumstats->dbtimeHighest, pchecksumstats->pgnoDbtimeHighest );
     (void)wprintf( L"\r\n" );
     (void)wprintf( L"%d reads performed\r\n", pchecksumstats->cIOs );
@@ -157,6 +186,7 @@ static BOOL FIsPageInitialized(
 static void ProcessESEPages(    const QWORD             ibOffset,
                                 const DWORD             cbData,
                                 const BYTE* const       pbData,
+                                PAGESUMMARY* const      rgpagesummary,
                                 CHECKSUM_STATS* const   pchecksumstats )
 {
     const JETPAGE * const       rgpage          = (JETPAGE*)pbData;
@@ -215,6 +245,11 @@ static void ProcessESEPages(    const QWORD             ibOffset,
 
                 (void)fwprintf( stderr, L"ERROR: page %d%s checksum failed\r\n", pgnoDisplay, wszPageTypeDisplay );
                 pchecksumstats->cpagesBadChecksum++;
+
+                if ( rgpagesummary && !fHeaderPage && !fTrailerPage )
+                {
+                    rgpagesummary[ pgnoPhysical - 1 ].objidFDP = objidSummaryUnknown;
+                }
             }
             else
             {
@@ -232,6 +267,14 @@ static void ProcessESEPages(    const QWORD             ibOffset,
                         pchecksumstats->pgnoDbtimeHighest = pgnoReal;
                     }
                 }
+
+                if ( rgpagesummary && !fHeaderPage && !fTrailerPage && !( ppageCurr->fFlags & fPageEmpty ) )
+                {
+                    PAGESUMMARY * const ppagesummary = &rgpagesummary[ pgnoPhysical - 1 ];
+                    ppagesummary->pgnoPrev = ppageCurr->pgnoPrev;
+                    ppagesummary->pgnoNext = ppageCurr->pgnoNext;
+                    ppagesummary->objidFDP = ppageCurr->objidFDP;
+                }
             }
 
         }
@@ -239,6 +282,69 @@ static void ProcessESEPages(    const QWORD             ibOffset,
 }
 
 
+static void MergePageStatistics(
+    CHECKSUM_STATS * const          pchecksumstats,
+    const CHECKSUM_STATS * const    pchecksumstatsPages )
+{
+    pchecksumstats->cpagesSeen                  += pchecksumstatsPages->cpagesSeen;
+    pchecksumstats->cpagesBadChecksum           += pchecksumstatsPages->cpagesBadChecksum;
+    pchecksumstats->cpagesCorrectableChecksum   += pchecksumstatsPages->cpagesCorrectableChecksum;
+    pchecksumstats->cpagesUninit                += pchecksumstatsPages->cpagesUninit;
+    pchecksumstats->cpagesWrongPgno             += pchecksumstatsPages->cpagesWrongPgno;
+
+    if ( pchecksumstatsPages->dbtimeHighest > pchecksumstats->dbtimeHighest )
+    {
+        pchecksumstats->dbtimeHighest = pchecksumstatsPages->dbtimeHighest;
+        pchecksumstats->pgnoDbtimeHighest = pchecksumstatsPages->pgnoDbtimeHighest;
+    }
+}
+
+static BOOL FSiblingLinkMatches(
+    const PAGESUMMARY * const   rgpagesummary,
+    const PAGESUMMARY * const   ppagesummary,
+    const DWORD                 pgnoSibling,
+    const DWORD                 pgnoExpected,
+    const BOOL                  fNext )
+{
+    const DWORD pgnoPhysicalSibling = pgnoSibling + g_cpgDBReserved;
+    if ( 0 == pgnoSibling || pgnoPhysicalSibling > (DWORD)cpageMax )
+    {
+        return TRUE;
+    }
+
+    const PAGESUMMARY * const ppagesummarySibling = &rgpagesummary[ pgnoPhysicalSibling - 1 ];
+    if ( ppagesummarySibling->objidFDP != ppagesummary->objidFDP )
+    {
+        return TRUE;
+    }
+
+    return ( fNext ? ppagesummarySibling->pgnoPrev : ppagesummarySibling->pgnoNext ) == pgnoExpected;
+}
+
+static void CheckSiblingLinks(
+    const PAGESUMMARY * const   rgpagesummary,
+    CHECKSUM_STATS * const      pchecksumstats )
+{
+    for ( DWORD pgnoPhysical = g_cpgDBReserved + 1; pgnoPhysical <= (DWORD)cpageMax; ++pgnoPhysical )
+    {
+        const PAGESUMMARY * const   ppagesummary    = &rgpagesummary[ pgnoPhysical - 1 ];
+        const DWORD                 pgnoReal        = pgnoPhysical - g_cpgDBReserved;
+
+        if ( objidSummaryNone == ppagesummary->objidFDP || objidSummaryUnknown == ppagesummary->objidFDP )
+        {
+            continue;
+        }
+
+        if ( !FSiblingLinkMatches( rgpagesummary, ppagesummary, ppagesummary->pgnoNext, pgnoReal, TRUE ) ||
+            !FSiblingLinkMatches( rgpagesummary, ppagesummary, ppagesummary->pgnoPrev, pgnoReal, FALSE ) )
+        {
+            (void)fwprintf( stderr, L"WARNING: page %d (objid %d) sibling links (prev %d, next %d) are not reciprocated\r\n",
+                            pgnoReal, ppagesummary->objidFDP, ppagesummary->pgnoPrev, ppagesummary->pgnoNext );
+            pchecksumstats->cpagesBadSiblingLink++;
+        }
+    }
+}
+
 static void CollectStatistics(
     const QWORD                 hrtCompleted,
     const ERR                   err,
@@ -302,7 +408,7 @@ static VOID ProcessPages(   const DWORD             dwError,
 {
     ERR err = JET_errSuccess;
 
-    ProcessESEPages( pchecksumcontext->ibOffset, pchecksumcontext->cbData, pchecksumcontext->pbData, pchecksumcontext->pchecksumstats );
+    ProcessESEPages( pchecksumcontext->ibOffset, pchecksumcontext->cbData, pchecksumcontext->pbData, pchecksumcontext->rgpagesummary, &pchecksumcontext->checksumstatsPages );
     Call( ErrIssueNextIO( pchecksumcontext ) );
     CallS( pchecksumcontext->pfapi->ErrIOIssue() );
 
@@ -379,6 +485,7 @@ BOOL FChecksumFile(
     IFileAPI*           pfapi               = NULL;
     BYTE*               pbBlock             = NULL;
     CChecksumContext**  rgpchecksumcontext  = NULL;
+    PAGESUMMARY*        rgpagesummary       = NULL;
 
     CHECKSUM_STATS      checksumstats       = { 0 };
     CSemaphore          sem( CSyncBasicInfo( "FChecksumFile" ) );
@@ -400,6 +507,7 @@ BOOL FChecksumFile(
     cpageMax                = 0;
     cblockMax               = 0;
     cblockCurr              = 0;
+    cblocks                 = max( cblocksMin, min( 2 * (INT)CUtilProcessProcessor(), cblocksMax ) );
 
 
     class CFileSystemConfiguration : public CDefaultFileSystemConfiguration
@@ -418,7 +526,7 @@ BOOL FChecksumFile(
     Call( ErrOSFSCreate( &fsconfig, &pfsapi ) );
 
 
-    Call( taskmgr.ErrTMInit( cblocks, NULL, fTrue ) );
+    Call( taskmgr.ErrTMInit( min( (INT)CUtilProcessProcessor(), cblocks ), NULL, fTrue ) );
 
 
     Call( pfsapi->ErrFileOpen( szFile, IFileAPI::fmfReadOnlyPermissive, &pfapi ) );
@@ -433,13 +541,20 @@ BOOL FChecksumFile(
     cblockMax   = ( cpageMax + g_cpagesPerBlock - 1 ) / g_cpagesPerBlock;
 
 
+    rgpagesummary = (PAGESUMMARY*)PvOSMemoryPageAlloc( max( (size_t)cpageMax, (size_t)1 ) * sizeof( PAGESUMMARY ), NULL );
+    if ( NULL == rgpagesummary )
+    {
+        (void)fwprintf( stderr, L"WARNING: not enough memory to summarize pages, sibling links will not be checked\r\n" );
+    }
+
+
     hrtFirstIO = HrtHRTCount();
 
     Alloc( rgpchecksumcontext = new CChecksumContext*[ cblocks ] );
     for ( iblockio = 0; iblockio < cblocks; ++iblockio )
     {
         Alloc( pbBlock = (BYTE*)PvOSMemoryPageAlloc( g_cbReadBuffer, NULL ) );
-        Alloc( rgpchecksumcontext[ iblockio ] = new CChecksumContext( &taskmgr, &checksumstats, &sem, pfapi, pbBlock ) );
+        Alloc( rgpchecksumcontext[ iblockio ] = new CChecksumContext( &taskmgr, &checksumstats, &sem, pfapi, pbBlock, rgpagesummary ) );
         pbBlock = NULL;
 
         err = ErrIssueNextIO( rgpchecksumcontext[ iblockio ] );
@@ -470,6 +585,16 @@ BOOL FChecksumFile(
         }
     }
 
+    for ( INT iblockT = 0; iblockT < cblocks; ++iblockT )
+    {
+        MergePageStatistics( &checksumstats, &rgpchecksumcontext[ iblockT ]->checksumstatsPages );
+    }
+
+    if ( rgpagesummary )
+    {
+        CheckSiblingLinks( rgpagesummary, &checksumstats );
+    }
+
     hrtLastIO = HrtHRTCount();
 
     TermStatus();
@@ -503,6 +628,7 @@ HandleError:
         }
         delete[] rgpchecksumcontext;
     }
+    OSMemoryPageFree( rgpagesummary );
     delete pfapi;
     delete pfsapi;
 
@@ -86,6 +86,9 @@ void PrintHelpEmbeddedUnitTest( _In_ const char* szExecutable )
             "   <wildcard>           Executes specified non-persisted tests\n"
             "   -database <blank>    Executes all tests requiring a database.\n"
             "   -database <wildcard> Executes specified tests requiring a database.\n"
+            "   -benchmark <wildcard> [<json file>]\n"
+            "                        Executes specified benchmarks, optionally appending\n"
+            "                        one JSON result per line to the given file.\n"
             "   -?|/?|-h|/h          Prints out all tests (and this message).\n"
             "\n"
             );
@@ -208,6 +211,15 @@ INT __cdecl main( INT argc, __in_ecount(argc) char * argv[] )
     {
         err = ErrExecutePersistedDatabaseUnitTests( ( 3 == argc ) ? argv[ 2 ] : NULL );
     }
+    else if ( 0 == strcmp( "-benchmark", argv[ 1 ] ) )
+    {
+        JET_TESTHOOKUNITBENCHMARK jetbench;
+        jetbench.cbStruct = sizeof(jetbench);
+        jetbench.szBenchmarkName = ( argc > 2 ) ? argv[ 2 ] : "*";
+        jetbench.szJsonFile = ( argc > 3 ) ? argv[ 3 ] : NULL;
+        jetbench.cRuns = 0;
+        err = JetTestHook( opTestHookUnitBenchmarks, &jetbench );
+    }
     else
     {
         for( INT i = 1; i < argc; ++i )
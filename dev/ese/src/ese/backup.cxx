@@ -10,6 +10,24 @@
 
 extern VOID ITDBGSetConstants( INST * pinst = NULL);
 
+#ifdef PERFMON_SUPPORT
+
+PERFInstanceDelayedTotal<>          cBKReadAheadPages;
+LONG LBKReadAheadPagesCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cBKReadAheadPages.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<>          cBKChangedPagesSkipped;
+LONG LBKChangedPagesSkippedCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cBKChangedPagesSkipped.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+#endif
+
 BACKUP_CONTEXT::BACKUP_CONTEXT( INST * pinst )
     : CZeroInit( sizeof( BACKUP_CONTEXT ) ),
       m_pinst( pinst ),
@@ -131,6 +149,229 @@ HandleError:
 
 #define DISABLE_EXTENSIVE_CHECKS_DURING_STREAMING_BACKUP 1
 
+const INT   cBKReadAheadDepthMax    = 8;
+const ULONG cbBKReadAheadMax        = 64 * 1024 * 1024;
+const TICK  dtickBKReadAheadSlow    = 200;
+
+VOID BACKUP_CONTEXT::BKIReadAheadComplete()
+{
+    if ( !m_fReadAheadPending )
+    {
+        return;
+    }
+
+    const BOOL  fWaited = ( 0 == m_preaddataReadAhead->tickCompleted );
+    const ERR   err     = ErrIOReadDbPagesWait( m_preaddataReadAhead );
+
+    Assert( !m_preaddataReadAhead->fRangeLocked );
+    m_fReadAheadPending = fFalse;
+
+    if ( err < JET_errSuccess )
+    {
+        m_pgnoReadAheadNext = m_pgnoReadAheadLast + 1;
+        m_cReadAheadDepth = 1;
+        return;
+    }
+
+    if ( DtickDelta( m_tickReadAheadIssued, m_preaddataReadAhead->tickCompleted ) > (LONG)dtickBKReadAheadSlow )
+    {
+        m_cReadAheadDepth = max( 1, m_cReadAheadDepth / 2 );
+    }
+    else if ( fWaited )
+    {
+        m_cReadAheadDepth = min( cBKReadAheadDepthMax, m_cReadAheadDepth * 2 );
+    }
+}
+
+BOOL BACKUP_CONTEXT::FBKIReadAheadConsume( const IFMP ifmp, const PGNO pgnoStart, const PGNO pgnoEnd, BYTE * const pbDest )
+{
+    if ( NULL == m_preaddataReadAhead || m_ifmpReadAhead != ifmp )
+    {
+        return fFalse;
+    }
+
+    BKIReadAheadComplete();
+
+    if ( pgnoStart != m_pgnoReadAheadNext || pgnoEnd > m_pgnoReadAheadLast )
+    {
+        m_pgnoReadAheadNext = m_pgnoReadAheadLast + 1;
+        return fFalse;
+    }
+
+    Assert( pgnoStart >= m_pgnoReadAheadBase );
+    UtilMemCpy( pbDest, m_pbReadAhead + ( pgnoStart - m_pgnoReadAheadBase ) * g_cbPage, ( pgnoEnd - pgnoStart + 1 ) * g_cbPage );
+    m_pgnoReadAheadNext = pgnoEnd + 1;
+
+    PERFOpt( cBKReadAheadPages.Add( m_pinst, pgnoEnd - pgnoStart + 1 ) );
+
+    return fTrue;
+}
+
+VOID BACKUP_CONTEXT::BKIReadAheadIssue( const IFMP ifmp, const PGNO pgnoFirst, const INT cpage )
+{
+    FMP * const pfmp = &g_rgfmp[ ifmp ];
+
+    Assert( cpage > 0 );
+
+    if ( m_fReadAheadPending ||
+        ( NULL != m_preaddataReadAhead && m_ifmpReadAhead == ifmp && m_pgnoReadAheadNext <= m_pgnoReadAheadLast ) )
+    {
+        return;
+    }
+
+    if ( pgnoFirst > pfmp->PgnoBackupMost() )
+    {
+        return;
+    }
+
+    if ( NULL == m_preaddataReadAhead )
+    {
+        m_preaddataReadAhead = new READPAGE_DATA;
+        if ( NULL == m_preaddataReadAhead )
+        {
+            return;
+        }
+        m_cReadAheadDepth = 1;
+    }
+
+    if ( m_cpgReadAheadBuffer < cpage )
+    {
+        if ( m_pbReadAhead )
+        {
+            OSMemoryPageFree( m_pbReadAhead );
+            m_pbReadAhead = NULL;
+            m_cpgReadAheadBuffer = 0;
+        }
+
+        const CPG cpgBuffer = max( cpage, min( cpage * cBKReadAheadDepthMax, (CPG)( cbBKReadAheadMax / g_cbPage ) ) );
+        m_pbReadAhead = (BYTE *)PvOSMemoryPageAlloc( cpgBuffer * g_cbPage, NULL );
+        if ( NULL == m_pbReadAhead )
+        {
+            return;
+        }
+        m_cpgReadAheadBuffer = cpgBuffer;
+    }
+
+    const CPG   cpgReadAhead    = max( cpage, min( cpage * m_cReadAheadDepth, m_cpgReadAheadBuffer ) );
+    const PGNO  pgnoLast        = min( pgnoFirst + cpgReadAhead - 1, pfmp->PgnoBackupMost() );
+
+    if ( pfmp->ErrRangeLock( pgnoFirst, pgnoLast ) < JET_errSuccess )
+    {
+        return;
+    }
+
+    m_ifmpReadAhead         = ifmp;
+    m_pgnoReadAheadBase     = pgnoFirst;
+    m_pgnoReadAheadNext     = pgnoFirst;
+    m_pgnoReadAheadLast     = pgnoLast;
+    m_tickReadAheadIssued   = TickOSTimeCurrent();
+    m_fReadAheadPending     = fTrue;
+
+    m_preaddataReadAhead->fRangeLocked          = fTrue;
+    m_preaddataReadAhead->pgnoRangeLockFirst    = pgnoFirst;
+    m_preaddataReadAhead->pgnoRangeLockLast     = pgnoLast;
+
+    TraceContextScope tcBackup( iorpBackup, iorsNone, iortBackupRestore );
+    IOReadDbPagesIssue( ifmp,
+                        pfmp->Pfapi(),
+                        m_pbReadAhead,
+                        pgnoFirst,
+                        pgnoLast,
+                        fTrue,
+                        0,
+                        *tcBackup,
+                        !!( UlParam( m_pinst, JET_paramDisableVerifications ) & DISABLE_EXTENSIVE_CHECKS_DURING_STREAMING_BACKUP ),
+                        QosAsyncReadDefault( m_pinst ),
+                        m_preaddataReadAhead );
+}
+
+VOID BACKUP_CONTEXT::BKIReadAheadTerm()
+{
+    if ( m_preaddataReadAhead )
+    {
+        BKIReadAheadComplete();
+        delete m_preaddataReadAhead;
+        m_preaddataReadAhead = NULL;
+    }
+
+    if ( m_pbReadAhead )
+    {
+        OSMemoryPageFree( m_pbReadAhead );
+        m_pbReadAhead = NULL;
+    }
+
+    m_cpgReadAheadBuffer = 0;
+    m_cReadAheadDepth = 0;
+}
+
+ERR BACKUP_CONTEXT::ErrBKIBeginChangedPageEpochs()
+{
+    ERR err = JET_errSuccess;
+
+    for ( DBID dbid = dbidUserLeast; dbid < dbidMax; dbid++ )
+    {
+        const IFMP ifmp = m_pinst->m_mpdbidifmp[ dbid ];
+        if ( ifmp >= g_ifmpMax )
+            continue;
+
+        FMP * const pfmp = &g_rgfmp[ ifmp ];
+
+        if ( pfmp->FInUse()
+            && pfmp->FLogOn()
+            && pfmp->FAttached()
+            && !pfmp->FAttachingDB() )
+        {
+            Call( pfmp->ChangedPageMap().ErrBeginEpoch( pfmp->PgnoLast() ) );
+        }
+    }
+
+HandleError:
+    if ( err < JET_errSuccess )
+    {
+        BKIEndChangedPageEpochs( fFalse );
+    }
+    return err;
+}
+
+VOID BACKUP_CONTEXT::BKIEndChangedPageEpochs( const BOOL fNormal )
+{
+    for ( DBID dbid = dbidUserLeast; dbid < dbidMax; dbid++ )
+    {
+        const IFMP ifmp = m_pinst->m_mpdbidifmp[ dbid ];
+        if ( ifmp >= g_ifmpMax )
+            continue;
+
+        FMP * const pfmp = &g_rgfmp[ ifmp ];
+
+        if ( pfmp->FInUse() && pfmp->ChangedPageMap().FInEpoch() )
+        {
+            pfmp->ChangedPageMap().EndEpoch( fNormal && pfmp->FBackupFileCopyDone() );
+        }
+    }
+}
+
+VOID BACKUP_CONTEXT::BKIZeroUnchangedPages( const IFMP ifmp, const PGNO pgnoStart, const PGNO pgnoEnd, BYTE * const pbPages )
+{
+    const CChangedPageMap&  cpm         = g_rgfmp[ ifmp ].ChangedPageMap();
+    CPG                     cpgSkipped  = 0;
+
+    for ( PGNO pgno = pgnoStart; pgno <= pgnoEnd; )
+    {
+        const PGNO  pgnoChunkLast   = min( pgnoEnd, ( pgno / CChangedPageMap::s_cpgChunk + 1 ) * CChangedPageMap::s_cpgChunk - 1 );
+        const CPG   cpg             = pgnoChunkLast - pgno + 1;
+
+        if ( !cpm.FEpochRangeChanged( pgno, cpg ) )
+        {
+            memset( pbPages + ( pgno - pgnoStart ) * g_cbPage, 0, cpg * g_cbPage );
+            cpgSkipped += cpg;
+        }
+
+        pgno = pgnoChunkLast + 1;
+    }
+
+    PERFOpt( cBKChangedPagesSkipped.Add( m_pinst, cpgSkipped ) );
+}
+
 ERR BACKUP_CONTEXT::ErrBKIReadPages(
     RHF *prhf,
     VOID *pvPageMin,
@@ -197,6 +438,14 @@ ERR BACKUP_CONTEXT::ErrBKIReadPages(
 
 #endif
 
+#ifdef MINIMAL_FUNCTIONALITY
+    const BOOL fScrubbing = fFalse;
+#else
+    const BOOL fScrubbing = fScrub;
+#endif
+    const BOOL fSkipUnchanged   = m_fBackupChangedPages && !fScrubbing;
+    const BOOL fReadAhead       = !fScrubbing && !m_fBackupChangedPages;
+
     Assert( cpage > 0 );
 
     
@@ -259,70 +508,87 @@ ERR BACKUP_CONTEXT::ErrBKIReadPages(
         goto CopyFinalHeaderPage;
     }
 
-    do
+    if ( fSkipUnchanged && !pfmp->ChangedPageMap().FEpochRangeChanged( pgnoStart, pgnoEnd - pgnoStart + 1 ) )
+    {
+        BKIZeroUnchangedPages( ifmp, pgnoStart, pgnoEnd, (BYTE *) pvPageMin + ipageT * g_cbPage );
+        err = JET_errSuccess;
+    }
+    else if ( fReadAhead && FBKIReadAheadConsume( ifmp, pgnoStart, pgnoEnd, (BYTE *) pvPageMin + ipageT * g_cbPage ) )
+    {
+        err = JET_errSuccess;
+    }
+    else
     {
-        TraceContextScope tcBackupT( iorpBackup );
+        do
+        {
+            TraceContextScope tcBackupT( iorpBackup );
 
-        err = ErrIOReadDbPages( ifmp, pfmp->Pfapi(), (BYTE *) pvPageMin + ipageT * g_cbPage, pgnoStart, pgnoEnd, fTrue, 0, *tcBackupT, !!( UlParam( m_pinst, JET_paramDisableVerifications ) & DISABLE_EXTENSIVE_CHECKS_DURING_STREAMING_BACKUP ) );
+            err = ErrIOReadDbPages( ifmp, pfmp->Pfapi(), (BYTE *) pvPageMin + ipageT * g_cbPage, pgnoStart, pgnoEnd, fTrue, 0, *tcBackupT, !!( UlParam( m_pinst, JET_paramDisableVerifications ) & DISABLE_EXTENSIVE_CHECKS_DURING_STREAMING_BACKUP ) );
 
-        if ( err < JET_errSuccess )
-        {
-            if ( iRetry < cRetry )
+            if ( err < JET_errSuccess )
             {
-                BOOL fIsPatchable = BoolParam( m_pinst, JET_paramEnableExternalAutoHealing ) && PagePatching::FIsPatchableError( err );
-                if ( fIsPatchable )
+                if ( iRetry < cRetry )
                 {
-                    pfmp->RangeUnlock( pgnoStart, pgnoEnd );
-                }
+                    BOOL fIsPatchable = BoolParam( m_pinst, JET_paramEnableExternalAutoHealing ) && PagePatching::FIsPatchableError( err );
+                    if ( fIsPatchable )
+                    {
+                        pfmp->RangeUnlock( pgnoStart, pgnoEnd );
+                    }
 
-                UtilSleep( ( iRetry + 1 ) * tickBackoff );
+                    UtilSleep( ( iRetry + 1 ) * tickBackoff );
 
-                if ( fIsPatchable )
-                {
-                    ERR errLock = pfmp->ErrRangeLock( pgnoStart, pgnoEnd );
-                    if ( errLock < JET_errSuccess )
+                    if ( fIsPatchable )
                     {
-                        return errLock;
+                        ERR errLock = pfmp->ErrRangeLock( pgnoStart, pgnoEnd );
+                        if ( errLock < JET_errSuccess )
+                        {
+                            return errLock;
+                        }
                     }
                 }
             }
-        }
-        else
-        {
-            if ( iRetry > 0 )
+            else
             {
-                const WCHAR*    rgpsz[ 5 ];
-                DWORD           irgpsz      = 0;
-                WCHAR           szAbsPath[ IFileSystemAPI::cchPathMax ];
-                WCHAR           szOffset[ 64 ];
-                WCHAR           szLength[ 64 ];
-                WCHAR           szFailures[ 64 ];
-                WCHAR           szElapsed[ 64 ];
-
-                CallS( pfmp->Pfapi()->ErrPath( szAbsPath ) );
-                OSStrCbFormatW( szOffset, sizeof( szOffset ), L"%I64i (0x%016I64x)", OffsetOfPgno( pgnoStart ), OffsetOfPgno( pgnoStart ) );
-                OSStrCbFormatW( szLength, sizeof( szLength ), L"%u (0x%08x)", ( pgnoEnd - pgnoStart + 1 ) * g_cbPage, ( pgnoEnd - pgnoStart + 1 ) * g_cbPage );
-                OSStrCbFormatW( szFailures, sizeof( szFailures ), L"%i", iRetry );
-                OSStrCbFormatW( szElapsed, sizeof( szElapsed ), L"%g", ( TickOSTimeCurrent() - tickStart ) / 1000.0 );
-
-                rgpsz[ irgpsz++ ]   = szAbsPath;
-                rgpsz[ irgpsz++ ]   = szOffset;
-                rgpsz[ irgpsz++ ]   = szLength;
-                rgpsz[ irgpsz++ ]   = szFailures;
-                rgpsz[ irgpsz++ ]   = szElapsed;
-
-                UtilReportEvent(    eventError,
-                                    LOGGING_RECOVERY_CATEGORY,
-                                    TRANSIENT_READ_ERROR_DETECTED_ID,
-                                    irgpsz,
-                                    rgpsz,
-                                    0,
-                                    NULL,
-                                    m_pinst );
+                if ( iRetry > 0 )
+                {
+                    const WCHAR*    rgpsz[ 5 ];
+                    DWORD           irgpsz      = 0;
+                    WCHAR           szAbsPath[ IFileSystemAPI::cchPathMax ];
+                    WCHAR           szOffset[ 64 ];
+                    WCHAR           szLength[ 64 ];
+                    WCHAR           szFailures[ 64 ];
+                    WCHAR           szElapsed[ 64 ];
+
+                    CallS( pfmp->Pfapi()->ErrPath( szAbsPath ) );
+                    OSStrCbFormatW( szOffset, sizeof( szOffset ), L"%I64i (0x%016I64x)", OffsetOfPgno( pgnoStart ), OffsetOfPgno( pgnoStart ) );
+                    OSStrCbFormatW( szLength, sizeof( szLength ), L"%u (0x%08x)", ( pgnoEnd - pgnoStart + 1 ) * g_cbPage, ( pgnoEnd - pgnoStart + 1 ) * g_cbPage );
+                    OSStrCbFormatW( szFailures, sizeof( szFailures ), L"%i", iRetry );
+                    OSStrCbFormatW( szElapsed, sizeof( szElapsed ), L"%g", ( TickOSTimeCurrent() - tickStart ) / 1000.0 );
+
+                    rgpsz[ irgpsz++ ]   = szAbsPath;
+                    rgpsz[ irgpsz++ ]   = szOffset;
+                    rgpsz[ irgpsz++ ]   = szLength;
+                    rgpsz[ irgpsz++ ]   = szFailures;
+                    rgpsz[ irgpsz++ ]   = szElapsed;
+
+                    UtilReportEvent(    eventError,
+                                        LOGGING_RECOVERY_CATEGORY,
+                                        TRANSIENT_READ_ERROR_DETECTED_ID,
+                                        irgpsz,
+                                        rgpsz,
+                                        0,
+                                        NULL,
+                                        m_pinst );
+                }
             }
         }
+        while ( iRetry++ < cRetry && err < JET_errSuccess );
+
+        if ( fSkipUnchanged && err >= JET_errSuccess )
+        {
+            BKIZeroUnchangedPages( ifmp, pgnoStart, pgnoEnd, (BYTE *) pvPageMin + ipageT * g_cbPage );
+        }
     }
-    while ( iRetry++ < cRetry && err < JET_errSuccess );
 
 #ifdef MINIMAL_FUNCTIONALITY
 #else
@@ -402,6 +668,11 @@ ERR BACKUP_CONTEXT::ErrBKIReadPages(
     
     *pcbActual += g_cbPage * ( cpageT - ipageT );
 
+    if ( fReadAhead )
+    {
+        BKIReadAheadIssue( ifmp, pgnoEnd + 1, cpage );
+    }
+
 CopyFinalHeaderPage:
     if ( fRoomForFinalHeaderPage )
     {
@@ -1440,6 +1711,9 @@ ERR BACKUP_CONTEXT::ErrBKBeginExternalBackup( JET_GRBIT grbit, ULONG lgenFirst,
     const BOOL  fIncrementalBackup = ( JET_bitBackupIncremental == ( JET_bitBackupIncremental & grbit ) );
     const BOOL  fSurrogateBackup = ( JET_bitBackupSurrogate == ( JET_bitBackupSurrogate & grbit ) );
     const BOOL  fInternalCopyBackup = ( JET_bitInternalCopy == ( JET_bitInternalCopy & grbit ) );
+    const BOOL  fChangedPagesBackup = ( JET_bitBackupChangedPages == ( JET_bitBackupChangedPages & grbit ) );
+    const BOOL  fTrackChangedPages  = !fIncrementalBackup && !fSurrogateBackup && !fInternalCopyBackup &&
+                                        BoolParam( m_pinst, JET_paramEnableChangedPageTracking );
 
 #ifdef DEBUG
     if ( m_fDBGTraceBR )
@@ -1465,11 +1739,22 @@ ERR BACKUP_CONTEXT::ErrBKBeginExternalBackup( JET_GRBIT grbit, ULONG lgenFirst,
     }
 
     
-    if ( ( grbit & ~(JET_bitBackupSurrogate | JET_bitBackupIncremental | JET_bitInternalCopy) ) != 0 )
+    if ( ( grbit & ~(JET_bitBackupSurrogate | JET_bitBackupIncremental | JET_bitInternalCopy | JET_bitBackupChangedPages) ) != 0 )
+    {
+        return ErrERRCheck( JET_errInvalidGrbit );
+    }
+
+    if ( fChangedPagesBackup &&
+            ( grbit & (JET_bitBackupSurrogate | JET_bitBackupIncremental | JET_bitInternalCopy) ) )
     {
         return ErrERRCheck( JET_errInvalidGrbit );
     }
 
+    if ( fChangedPagesBackup && !BoolParam( m_pinst, JET_paramEnableChangedPageTracking ) )
+    {
+        return ErrERRCheck( JET_errInvalidParameter );
+    }
+
     Assert( m_ppibBackup != ppibNil );
 
     if ( fIncrementalBackup && BoolParam( m_pinst, JET_paramCircularLog ) )
@@ -1524,6 +1809,7 @@ ERR BACKUP_CONTEXT::ErrBKBeginExternalBackup( JET_GRBIT grbit, ULONG lgenFirst,
     m_fBackupInProgressAny = fTrue;
     m_fBackupInProgressLocal = !fSurrogateBackup;
     m_fBackupIsInternal = fInternalCopyBackup;
+    m_fBackupChangedPages = fChangedPagesBackup;
     m_critBackupInProgress.Leave();
 
 #if DEBUG
@@ -1566,6 +1852,11 @@ ERR BACKUP_CONTEXT::ErrBKBeginExternalBackup( JET_GRBIT grbit, ULONG lgenFirst,
         }
     }
 
+    if ( fTrackChangedPages )
+    {
+        Call( ErrBKIBeginChangedPageEpochs() );
+    }
+
     if ( fIncrementalBackup )
     {
 
@@ -1683,8 +1974,13 @@ HandleError:
 
     if ( err < 0 )
     {
+        if ( fTrackChangedPages )
+        {
+            BKIEndChangedPageEpochs( fFalse );
+        }
         m_fBackupInProgressAny = fFalse;
         m_fBackupInProgressLocal = fFalse;
+        m_fBackupChangedPages = fFalse;
         m_fStopBackup = fFalse;
         m_fBackupStatus = backupStateNotStarted;
     }
@@ -2644,6 +2940,8 @@ ERR BACKUP_CONTEXT::ErrBKCloseFile( JET_HANDLE hfFile )
 
         ifmpT = m_rgrhf[irhf].ifmp;
 
+        BKIReadAheadTerm();
+
         g_rgfmp[ifmpT].CritLatch().Enter();
         g_rgfmp[ifmpT].SetPgnoBackupMost( 0 );
         g_rgfmp[ifmpT].SetPgnoBackupCopyMost( 0 );
@@ -3163,6 +3461,14 @@ ERR BACKUP_CONTEXT::ErrBKTruncateLog()
         return ErrERRCheck( JET_errLogFileNotCopied );
     }
 
+    //  a changed-pages backup is only usable on top of the previous copy and there is no restore
+    //  path that merges the two yet, so the logs it covers must outlive it
+
+    if ( m_fBackupChangedPages )
+    {
+        return JET_errSuccess;
+    }
+
     BKSetLogsTruncated( fTrue );
 
     return m_pinst->m_plog->ErrLGTruncateLog( m_lgenDeleteMic, m_lgenDeleteMac, fFalse, m_fBackupFull );
@@ -3672,7 +3978,8 @@ ERR BACKUP_CONTEXT::ErrBKExternalBackupCleanUp( ERR error, const JET_GRBIT grbit
     }
 
 
-    
+    BKIReadAheadTerm();
+
     for ( INT irhf = 0; irhf < crhfMax; ++irhf )
     {
         if ( m_rgrhf[irhf].fInUse && m_rgrhf[irhf].pfapi )
@@ -3711,7 +4018,10 @@ ERR BACKUP_CONTEXT::ErrBKExternalBackupCleanUp( ERR error, const JET_GRBIT grbit
         }
     }
 
+    //  a changed-pages backup is not a restorable full backup by itself, so it is not recorded as one
+
     if ( fNormal &&
+        !m_fBackupChangedPages &&
         !( JET_bitBackupNoDbHeaderUpdate & grbit ) )
     {
 
@@ -3789,6 +4099,9 @@ ERR BACKUP_CONTEXT::ErrBKExternalBackupCleanUp( ERR error, const JET_GRBIT grbit
                     !m_fBackupFull, &lgposRecT );
     }
 
+    BKIEndChangedPageEpochs( fNormal );
+    m_fBackupChangedPages = fFalse;
+
     for ( dbid = dbidUserLeast; dbid < dbidMax; dbid++ )
     {
         IFMP    ifmp = m_pinst->m_mpdbidifmp[ dbid ];
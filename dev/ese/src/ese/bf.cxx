@@ -3016,6 +3016,8 @@ ERR ErrBFLockPageRangeForExternalZeroing( const IFMP ifmp, const PGNO pgnoFirst,
     Assert( pgnoFirst >= PgnoOfOffset( cpgDBReserved * g_rgcbPageSize[ g_icbCacheMax ] ) );
     Assert( cpg > 0 );
 
+    pfmp->ChangedPageMap().SetRangeChanged( pgnoFirst, cpg );
+
     if ( pfmp->FLogOn() )
     {
         const BOOL fWaypointLatency = UlParam( pfmp->Pinst(), JET_paramWaypointLatency ) > 0;
@@ -19802,6 +19804,8 @@ void BFISyncWriteComplete(  const ERR           err,
 
     if ( FBFIDatabasePage( pbf ) )
     {
+        g_rgfmp[ pbf->ifmp ].ChangedPageMap().SetRangeChanged( pbf->pgno, 1 );
+
         if ( err >= JET_errSuccess )
         {
             CPAGE::PageFlushType pgft = CPAGE::pgftUnknown;
@@ -20444,6 +20448,8 @@ void BFIAsyncWriteComplete( const ERR           err,
 
     if ( FBFIDatabasePage( pbf ) )
     {
+        g_rgfmp[ pbf->ifmp ].ChangedPageMap().SetRangeChanged( pbf->pgno, 1 );
+
         if ( err >= JET_errSuccess )
         {
             CPAGE::PageFlushType pgft = CPAGE::pgftUnknown;
@@ -10,7 +10,7 @@
 
 
 ERR ErrBTIIRefresh( FUCB *pfucb, LATCH latch );
-ERR ErrBTDelete( FUCB *pfucb, const BOOKMARK& bm );
+ERR ErrBTDelete( FUCB *pfucb, const BOOKMARK& bm, const BOOKMARK * const rgbmNext, const INT cbmNext, INT * const pcbmNextCleaned );
 INT CbBTIFreeDensity( const FUCB *pfucb );
 VOID BTIComputePrefix( FUCB *pfucb, CSR *pcsr, const KEY& key, KEYDATAFLAGS *pkdf );
 BOOL FBTIAppend( const FUCB *pfucb, CSR *pcsr, ULONG cbReq, const BOOL fUpdateUncFree = fTrue );
@@ -159,7 +159,13 @@ VOID BTICheckMergeInternal( FUCB        *pfucb,
                             MERGEPATH   *pmergePath,
                             MERGE       *pmergeLeaf );
 
-LOCAL ERR ErrBTISinglePageCleanup( FUCB *pfucb, const BOOKMARK& bm );
+LOCAL ERR ErrBTISinglePageCleanup(
+    FUCB            *pfucb,
+    const BOOKMARK& bm,
+    const BOOKMARK  * const rgbmNext,
+    const INT       cbmNext,
+    INT             * const pcbmNextCleaned );
+LOCAL INT CbmBTISPCBookmarksOnPage( FUCB *pfucb, CSR *pcsr, const BOOKMARK * const rgbm, const INT cbm );
 LOCAL ERR ErrBTISPCCollectLeafPageInfo(
     FUCB        *pfucb,
     CSR         *pcsr,
@@ -6461,7 +6467,12 @@ HandleError:
     return err;
 }
     
-INLINE ERR ErrBTIDelete( FUCB *pfucb, const BOOKMARK& bm )
+INLINE ERR ErrBTIDelete(
+    FUCB            *pfucb,
+    const BOOKMARK& bm,
+    const BOOKMARK  * const rgbmNext,
+    const INT       cbmNext,
+    INT             * const pcbmNextCleaned )
 {
     ERR     err;
 
@@ -6473,7 +6484,7 @@ INLINE ERR ErrBTIDelete( FUCB *pfucb, const BOOKMARK& bm )
     auto tc = TcCurr();
     PERFOpt( PERFIncCounterTable( cBTDelete, PinstFromPfucb( pfucb ), (TCE)tc.nParentObjectClass ) );
 
-    CallR( ErrBTISinglePageCleanup( pfucb, bm ) );
+    CallR( ErrBTISinglePageCleanup( pfucb, bm, rgbmNext, cbmNext, pcbmNextCleaned ) );
     Assert( !Pcsr( pfucb )->FLatched() );
 
     if ( wrnBTMultipageOLC == err )
@@ -6498,13 +6509,26 @@ INLINE ERR ErrBTIDelete( FUCB *pfucb, const BOOKMARK& bm )
     return err;
 }
 
-ERR ErrBTDelete( FUCB *pfucb, const BOOKMARK& bm )
+ERR ErrBTDelete(
+    FUCB            *pfucb,
+    const BOOKMARK& bm,
+    const BOOKMARK  * const rgbmNext,
+    const INT       cbmNext,
+    INT             * const pcbmNextCleaned )
 {
     ERR     err;
     PIB *   ppib            = pfucb->ppib;
     BOOL    fInTransaction  = fFalse;
     PIBTraceContextScope tcScope = TcBTICreateCtxScope( pfucb, iorsBTDelete );
 
+    Assert( cbmNext >= 0 );
+    Assert( NULL != rgbmNext || 0 == cbmNext );
+
+    if ( NULL != pcbmNextCleaned )
+    {
+        *pcbmNextCleaned = 0;
+    }
+
     Assert( !PinstFromPpib( ppib )->FRecovering() || fRecoveringUndo == PinstFromPpib( ppib )->m_plog->FRecoveringMode() );
 
     if ( ppib->Level() == 0 )
@@ -6513,7 +6537,7 @@ ERR ErrBTDelete( FUCB *pfucb, const BOOKMARK& bm )
         fInTransaction = fTrue;
     }
 
-    err = ErrBTIDelete( pfucb, bm );
+    err = ErrBTIDelete( pfucb, bm, rgbmNext, cbmNext, pcbmNextCleaned );
 
     switch ( err )
     {
@@ -6540,6 +6564,11 @@ HandleError:
         CallSx( ErrDIRRollback( ppib ), JET_errRollbackError );
     }
 
+    if ( err < JET_errSuccess && NULL != pcbmNextCleaned )
+    {
+        *pcbmNextCleaned = 0;
+    }
+
     return err;
 }
 
@@ -8892,6 +8921,11 @@ LOCAL ERR ErrBTIGetNewPages( FUCB *pfucb, SPLITPATH *psplitPathLeaf, DIRFLAG dir
             {
                 fSPAllocFlags |= pfucb->u.pfcb->FContiguousAppend() ? fSPContinuous : 0;
             }
+            if ( psplit->fAppend &&
+                 CpgDIRActiveSpaceRequestReserve( pfucb ) == cpgDIRReserveConsumed )
+            {
+                fSPAllocFlags |= fSPContinuous;
+            }
             if ( psplit->fHotpoint )
             {
                 fSPAllocFlags |= pfucb->u.pfcb->FContiguousHotpoint() ? fSPContinuous : 0;
@@ -10985,7 +11019,36 @@ HandleError:
     return err;
 }
 
-LOCAL ERR ErrBTISinglePageCleanup( FUCB *pfucb, const BOOKMARK& bm )
+LOCAL INT CbmBTISPCBookmarksOnPage( FUCB *pfucb, CSR *pcsr, const BOOKMARK * const rgbm, const INT cbm )
+{
+    Assert( pcsr->Cpage().FLeafPage() );
+
+    if ( 0 == cbm || 0 == pcsr->Cpage().Clines() )
+    {
+        return 0;
+    }
+
+    KEYDATAFLAGS    kdf;
+    BOOKMARK        bmLast;
+    NDIGetKeydataflags( pcsr->Cpage(), pcsr->Cpage().Clines() - 1, &kdf );
+    NDGetBookmarkFromKDF( pfucb, kdf, &bmLast );
+
+    INT ibm = 0;
+    while ( ibm < cbm && CmpBM( rgbm[ibm], bmLast ) <= 0 )
+    {
+        Assert( 0 == ibm || CmpBM( rgbm[ibm-1], rgbm[ibm] ) <= 0 );
+        ibm++;
+    }
+
+    return ibm;
+}
+
+LOCAL ERR ErrBTISinglePageCleanup(
+    FUCB            *pfucb,
+    const BOOKMARK& bm,
+    const BOOKMARK  * const rgbmNext,
+    const INT       cbmNext,
+    INT             * const pcbmNextCleaned )
 {
     Assert( !Pcsr( pfucb )->FLatched() );
 
@@ -11015,6 +11078,11 @@ LOCAL ERR ErrBTISinglePageCleanup( FUCB *pfucb, const BOOKMARK& bm )
     Assert( latchWrite == Pcsr( pfucb )->Latch() );
     Call( ErrBTISPCDeleteNodes( pfucb, Pcsr( pfucb ) ) );
 
+    if ( NULL != pcbmNextCleaned )
+    {
+        *pcbmNextCleaned = CbmBTISPCBookmarksOnPage( pfucb, Pcsr( pfucb ), rgbmNext, cbmNext );
+    }
+
     Call( ErrBTISPCCollectLeafPageInfo(
                 pfucb,
                 Pcsr( pfucb ),
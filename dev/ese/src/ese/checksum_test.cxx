@@ -1126,3 +1126,56 @@ JETUNITTESTEX( CHECKSUM, Perf, JetSimpleUnitTest::dwDontRunByDefault )
     }
 }
 
+
+JETUNITBENCHMARK( CHECKSUM, ChecksumNewFormat4KB )
+{
+    const ULONG cbPageTest = 4 * 1024;
+    BYTE * const pb = (BYTE *)PvOSMemoryPageAlloc( cbPageTest, NULL );
+    CHECK( NULL != pb );
+    if ( NULL == pb )
+    {
+        return;
+    }
+
+    for ( ULONG ib = 0; ib < cbPageTest; ib++ )
+    {
+        pb[ ib ] = (BYTE)rand();
+    }
+
+    volatile XECHECKSUM checksum = 0;
+    BENCHMARK_ITERATE()
+    {
+        checksum ^= ChecksumNewFormat( pb, cbPageTest, 1, fTrue );
+    }
+
+    OSMemoryPageFree( pb );
+}
+
+JETUNITBENCHMARK( CHECKSUM, ChecksumNewFormat32KB )
+{
+    const ULONG cbPageTest = 32 * 1024;
+    const ULONG cbBlock = cbPageTest / cxeChecksumPerPage;
+    BYTE * const pb = (BYTE *)PvOSMemoryPageAlloc( cbPageTest, NULL );
+    CHECK( NULL != pb );
+    if ( NULL == pb )
+    {
+        return;
+    }
+
+    for ( ULONG ib = 0; ib < cbPageTest; ib++ )
+    {
+        pb[ ib ] = (BYTE)rand();
+    }
+
+    volatile XECHECKSUM checksum = 0;
+    BENCHMARK_ITERATE()
+    {
+        checksum ^= ChecksumNewFormat( pb, cbBlock, 1, fTrue );
+        for ( ULONG iBlock = 1; iBlock < cxeChecksumPerPage; iBlock++ )
+        {
+            checksum ^= ChecksumNewFormat( pb + iBlock * cbBlock, cbBlock, 1, fFalse );
+        }
+    }
+
+    OSMemoryPageFree( pb );
+}
@@ -2872,5 +2872,128 @@ JETUNITTEST( CCompressionBufferCache, Basic )
     cache.Term();
 }
 
+class CDataCompressorBenchmarkBody
+{
+    public:
+        CDataCompressorBenchmarkBody( const CompressFlags compressFlags ) :
+            m_compressFlags( compressFlags ),
+            m_cbCompressed( 0 )
+        {
+            for ( INT ib = 0; ib < cbBuf; ib++ )
+            {
+                m_rgbOrig[ ib ] = BYTE( 'a' + ( ( ib * 7 + ib / 64 ) % 26 ) );
+            }
+        }
+
+        ERR ErrInit()
+        {
+            ERR err = JET_errSuccess;
+            DATA data;
+
+            Call( m_compressor.ErrInit( 64, 2 * cbBuf ) );
+
+            data.SetPv( m_rgbOrig );
+            data.SetCb( cbBuf );
+            Call( m_compressor.ErrCompress( data, m_compressFlags, &m_stats, m_rgbCompressed, cbBuf, &m_cbCompressed ) );
+
+        HandleError:
+            return err;
+        }
+
+        ERR ErrCompress()
+        {
+            DATA data;
+            INT cbDataActual;
+            data.SetPv( m_rgbOrig );
+            data.SetCb( cbBuf );
+            return m_compressor.ErrCompress( data, m_compressFlags, &m_stats, m_rgbCompressed, cbBuf, &cbDataActual );
+        }
+
+        ERR ErrDecompress()
+        {
+            DATA data;
+            INT cbDataActual;
+            data.SetPv( m_rgbCompressed );
+            data.SetCb( m_cbCompressed );
+            return m_compressor.ErrDecompress( data, &m_stats, m_rgbDecompressed, cbBuf, &cbDataActual );
+        }
+
+        VOID Term()
+        {
+            m_compressor.Term();
+        }
+
+    private:
+        enum { cbBuf = 4096 };
+
+        const CompressFlags     m_compressFlags;
+        CDataCompressor         m_compressor;
+        TestCompressorStats     m_stats;
+        BYTE                    m_rgbOrig[ cbBuf ];
+        BYTE                    m_rgbCompressed[ cbBuf ];
+        BYTE                    m_rgbDecompressed[ cbBuf ];
+        INT                     m_cbCompressed;
+};
+
+JETUNITBENCHMARK( CDataCompressor, XpressCompress4KB )
+{
+    CDataCompressorBenchmarkBody body( compressXpress );
+    CHECK( JET_errSuccess == body.ErrInit() );
+
+    ERR err = JET_errSuccess;
+    BENCHMARK_ITERATE()
+    {
+        err = body.ErrCompress();
+    }
+
+    CHECK( JET_errSuccess == err );
+    body.Term();
+}
+
+JETUNITBENCHMARK( CDataCompressor, XpressDecompress4KB )
+{
+    CDataCompressorBenchmarkBody body( compressXpress );
+    CHECK( JET_errSuccess == body.ErrInit() );
+
+    ERR err = JET_errSuccess;
+    BENCHMARK_ITERATE()
+    {
+        err = body.ErrDecompress();
+    }
+
+    CHECK( JET_errSuccess == err );
+    body.Term();
+}
+
+JETUNITBENCHMARK( CDataCompressor, 7BitAsciiCompress4KB )
+{
+    CDataCompressorBenchmarkBody body( compress7Bit );
+    CHECK( JET_errSuccess == body.ErrInit() );
+
+    ERR err = JET_errSuccess;
+    BENCHMARK_ITERATE()
+    {
+        err = body.ErrCompress();
+    }
+
+    CHECK( JET_errSuccess == err );
+    body.Term();
+}
+
+JETUNITBENCHMARK( CDataCompressor, 7BitAsciiDecompress4KB )
+{
+    CDataCompressorBenchmarkBody body( compress7Bit );
+    CHECK( JET_errSuccess == body.ErrInit() );
+
+    ERR err = JET_errSuccess;
+    BENCHMARK_ITERATE()
+    {
+        err = body.ErrDecompress();
+    }
+
+    CHECK( JET_errSuccess == err );
+    body.Term();
+}
+
 #endif
 
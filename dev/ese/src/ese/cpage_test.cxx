@@ -2699,3 +2699,36 @@ void CPageTestFixture::TearDown_()
 }
 
 
+
+JETUNITBENCHMARK( CPAGE, InsertDelete )
+{
+    const INT cbPage = 32 * 1024;
+    const INT clines = 200;
+
+    CPAGE cpage;
+    cpage.LoadNewTestPage( cbPage );
+    CHECK( cpage.FLoadedPage() );
+
+    BYTE rgbData[ 25 ];
+    memset( rgbData, 'a', sizeof( rgbData ) );
+    DATA data;
+    data.SetPv( rgbData );
+    data.SetCb( sizeof( rgbData ) );
+
+    for ( INT iline = 0; iline < clines; iline++ )
+    {
+        cpage.Insert( iline, &data, 1, 0 );
+    }
+
+    INT iline = 0;
+    BENCHMARK_ITERATE()
+    {
+        cpage.Insert( iline, &data, 1, 0 );
+        cpage.Delete( iline );
+        iline = ( iline + 37 ) % clines;
+    }
+
+    CHECK( clines == cpage.Clines() );
+    cpage.UnloadPage();
+}
+
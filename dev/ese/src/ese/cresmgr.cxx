@@ -412,7 +412,16 @@ CResourceManager::CResourceManager( JET_RESID resid ) :
         m_resid( resid ),
         m_ulFlags( 0 ),
         m_critInitTerm( CLockBasicInfo( CSyncBasicInfo( "CResourceManager::m_critInitTerm" ), 0, 10 ) ),
-        m_critLARefiller( CLockBasicInfo( CSyncBasicInfo( "CResourceManager::m_critLARefiller" ), 0, 5 ) )
+        m_critLARefiller( CLockBasicInfo( CSyncBasicInfo( "CResourceManager::m_critLARefiller" ), 0, 5 ) ),
+        m_rgbMagazineCache( NULL ),
+        m_cMagazineCache( 0 ),
+        m_cbMagazineCache( 0 ),
+        m_pMagazineFullList( NULL ),
+        m_pMagazineEmptyList( NULL ),
+        m_cMagazineFull( 0 ),
+        m_cMagazineFullMax( 0 ),
+        m_critMagazineDepot( CLockBasicInfo( CSyncBasicInfo( "CResourceManager::m_critMagazineDepot" ), 0, 1 ) ),
+        m_iMagazineCacheFixed( -1 )
 {
     Assert( 0 < cbSectionSize );
     Assert( cbChunkDefault >= cbSectionSize );
@@ -763,6 +772,8 @@ ERR CResourceManager::ErrInit()
             Call( ErrERRCheck( JET_errOutOfMemory ) );
         }
         m_cAvgCount = 0;
+
+        Call( ErrMagazineInit_() );
     }
     else
     {
@@ -790,7 +801,7 @@ VOID CResourceManager::Term( BOOL fDuringInit )
         VOID *pv = NULL;
         CResourceChunkInfo *pRCI = NULL;
 
-        while ( NULL != ( pv = m_lookaside.PvFlush() ) )
+        while ( NULL != ( pv = PvMagazineFlush_() ) || NULL != ( pv = m_lookaside.PvFlush() ) )
         {
             CResourceSection    *pRS            = NULL;
 
@@ -924,6 +935,7 @@ VOID CResourceManager::Term( BOOL fDuringInit )
         }
         m_pRCIFreeList = NULL;
         m_pRCINotFullList = NULL;
+        MagazineTerm_();
         m_lookaside.Term();
     }
     Assert( NULL == m_pRCIList );
@@ -1002,6 +1014,11 @@ VOID CResourceManager::Free( VOID * const pv )
     else
     {
 #ifndef RM_DEFERRED_FREE
+        if ( FMagazineFree_( pv ) )
+        {
+            return;
+        }
+
         BOOL fResult = fFalse;
         fResult = m_lookaside.FReturn( DwUtilThreadId(), pv );
         if ( fResult )
@@ -1010,75 +1027,432 @@ VOID CResourceManager::Free( VOID * const pv )
         }
 #endif
 
-        CResourceChunkInfo  *pRCI           = NULL;
-        LONG                cUsedInChunk    = 0;
+        FreeToChunk_( pv );
+    }
+}
+
 
-        MarkAsFreed_( pv, RCI_Free );
-        pRCI = ((CResourceSection *)((DWORD_PTR)pv & maskSection ))->m_pRCI;
+VOID CResourceManager::FreeToChunk_( VOID * const pv )
+{
+    CResourceChunkInfo  *pRCI           = NULL;
+    LONG                cUsedInChunk    = 0;
+
+    MarkAsFreed_( pv, RCI_Free );
+    pRCI = ((CResourceSection *)((DWORD_PTR)pv & maskSection ))->m_pRCI;
 
 #ifdef RM_DEFERRED_FREE
-        pRCI->m_critAlloc.Enter();
+    pRCI->m_critAlloc.Enter();
 
-        CResourceFreeObjectList::RFOLAddObject(
-            &pRCI->m_pRFOLHead,
-            &pRCI->m_pRFOLTail,
-            (CHAR *)pv + m_cbRFOLOffset );
+    CResourceFreeObjectList::RFOLAddObject(
+        &pRCI->m_pRFOLHead,
+        &pRCI->m_pRFOLTail,
+        (CHAR *)pv + m_cbRFOLOffset );
 
-        pRCI->m_cDeferredFrees++;
+    pRCI->m_cDeferredFrees++;
 
-        pRCI->m_critAlloc.Leave();
+    pRCI->m_critAlloc.Leave();
 #else
-        CResourceFreeObjectList::RFOLAddObject( &pRCI->m_pRFOL, (CHAR *)pv + m_cbRFOLOffset );
+    CResourceFreeObjectList::RFOLAddObject( &pRCI->m_pRFOL, (CHAR *)pv + m_cbRFOLOffset );
 #endif
-        
-        cUsedInChunk = AtomicDecrement( const_cast<LONG *>( &pRCI->m_cUsed ) );
+    
+    cUsedInChunk = AtomicDecrement( const_cast<LONG *>( &pRCI->m_cUsed ) );
 
-        Assert( 0 <= cUsedInChunk );
-        Assert( cUsedInChunk < cChunkProtect + m_cObjectsPerChunk );
-        Assert( cChunkProtect <= cUsedInChunk || m_cObjectsPerChunk > cUsedInChunk );
-        if ( m_cObjectsPerChunk-1 == cUsedInChunk )
+    Assert( 0 <= cUsedInChunk );
+    Assert( cUsedInChunk < cChunkProtect + m_cObjectsPerChunk );
+    Assert( cChunkProtect <= cUsedInChunk || m_cObjectsPerChunk > cUsedInChunk );
+    if ( m_cObjectsPerChunk-1 == cUsedInChunk )
+    {
+        Assert( NULL == pRCI->m_pRCINextNotFull );
+        OSSYNC_FOREVER
         {
-            Assert( NULL == pRCI->m_pRCINextNotFull );
-            OSSYNC_FOREVER
+            CResourceChunkInfo *pRCINotFull;
+            pRCINotFull = m_pRCINotFullList;
+            pRCI->m_pRCINextNotFull = pRCINotFull;
+            if ( AtomicCompareExchangePointer( (void **)&m_pRCINotFullList, pRCINotFull, pRCI ) == pRCINotFull )
             {
-                CResourceChunkInfo *pRCINotFull;
-                pRCINotFull = m_pRCINotFullList;
-                pRCI->m_pRCINextNotFull = pRCINotFull;
-                if ( AtomicCompareExchangePointer( (void **)&m_pRCINotFullList, pRCINotFull, pRCI ) == pRCINotFull )
-                {
-                    break;
-                }
+                break;
             }
         }
+    }
 
-        if ( 0 == cUsedInChunk && !m_fPreserveFreed )
+    if ( 0 == cUsedInChunk && !m_fPreserveFreed )
+    {
+        LONG cFreeRCI;
+        OSSYNC_FOREVER
         {
-            LONG cFreeRCI;
-            OSSYNC_FOREVER
+            cFreeRCI = m_cFreeRCI;
+            Assert( m_cAllocatedRCI - cFreeRCI >= m_cAllocatedChunksMin );
+            if ( m_cAllocatedRCI - cFreeRCI <= m_cAllocatedChunksMin )
             {
-                cFreeRCI = m_cFreeRCI;
-                Assert( m_cAllocatedRCI - cFreeRCI >= m_cAllocatedChunksMin );
-                if ( m_cAllocatedRCI - cFreeRCI <= m_cAllocatedChunksMin )
-                {
-                    return;
-                }
-                if ( AtomicCompareExchange( const_cast<LONG *>( &m_cFreeRCI ), cFreeRCI, cFreeRCI+1 ) == cFreeRCI )
-                {
-                    break;
-                }
+                return;
             }
-            VOID *pvData;
-            pvData = pRCI->m_pvData;
-            if ( 0 != AtomicCompareExchange( const_cast<LONG *>( &pRCI->m_cUsed ), 0, cRCIIsFree ) )
+            if ( AtomicCompareExchange( const_cast<LONG *>( &m_cFreeRCI ), cFreeRCI, cFreeRCI+1 ) == cFreeRCI )
             {
-                AtomicDecrement( const_cast<LONG *>( &m_cFreeRCI ) );
+                break;
             }
-            else
+        }
+        VOID *pvData;
+        pvData = pRCI->m_pvData;
+        if ( 0 != AtomicCompareExchange( const_cast<LONG *>( &pRCI->m_cUsed ), 0, cRCIIsFree ) )
+        {
+            AtomicDecrement( const_cast<LONG *>( &m_cFreeRCI ) );
+        }
+        else
+        {
+            OSMemoryPageFree( pvData );
+        }
+    }
+}
+
+
+ERR CResourceManager::ErrMagazineInit_()
+{
+    Assert( NULL == m_rgbMagazineCache );
+    Assert( 0 == m_cMagazineCache );
+
+#ifdef RM_DEFERRED_FREE
+    return JET_errSuccess;
+#else
+    if ( m_fAllocFromHeap || 0 == m_lookaside.CSize() )
+    {
+        return JET_errSuccess;
+    }
+
+    const INT cMagazineCache = OSSyncGetProcessorCountMax();
+    m_cbMagazineCache = AlignUpMask( (INT)sizeof( CResourceMagazineCache ), cbCacheLine );
+    AllocR( m_rgbMagazineCache = (BYTE *)PvOSMemoryHeapAllocAlign( cMagazineCache * m_cbMagazineCache, cbCacheLine ) );
+
+    for ( INT iMagazineCache = 0; iMagazineCache < cMagazineCache; iMagazineCache++ )
+    {
+        CResourceMagazineCache * const pmc = new( m_rgbMagazineCache + iMagazineCache * m_cbMagazineCache ) CResourceMagazineCache;
+        m_cMagazineCache++;
+
+        AllocR( pmc->m_pMagazineLoaded = new CResourceMagazine );
+        AllocR( pmc->m_pMagazinePrevious = new CResourceMagazine );
+    }
+
+    m_cMagazineFullMax = cMagazineCache;
+
+    return JET_errSuccess;
+#endif
+}
+
+
+VOID CResourceManager::MagazineTerm_()
+{
+    for ( INT iMagazineCache = 0; iMagazineCache < m_cMagazineCache; iMagazineCache++ )
+    {
+        CResourceMagazineCache * const pmc = PMagazineCache_( iMagazineCache );
+        Assert( NULL == pmc->m_pMagazineLoaded || pmc->m_pMagazineLoaded->FEmpty() || FUtilProcessAbort() );
+        Assert( NULL == pmc->m_pMagazinePrevious || pmc->m_pMagazinePrevious->FEmpty() || FUtilProcessAbort() );
+
+        delete pmc->m_pMagazineLoaded;
+        delete pmc->m_pMagazinePrevious;
+        pmc->~CResourceMagazineCache();
+    }
+
+    while ( NULL != m_pMagazineEmptyList )
+    {
+        CResourceMagazine * const pMagazine = m_pMagazineEmptyList;
+        m_pMagazineEmptyList = pMagazine->m_pMagazineNext;
+        delete pMagazine;
+    }
+
+    Assert( NULL == m_pMagazineFullList || FUtilProcessAbort() );
+    while ( NULL != m_pMagazineFullList )
+    {
+        CResourceMagazine * const pMagazine = m_pMagazineFullList;
+        m_pMagazineFullList = pMagazine->m_pMagazineNext;
+        delete pMagazine;
+    }
+
+    OSMemoryHeapFreeAlign( m_rgbMagazineCache );
+    m_rgbMagazineCache = NULL;
+    m_cMagazineCache = 0;
+    m_cMagazineFull = 0;
+}
+
+
+INLINE CResourceMagazineCache *CResourceManager::PMagazineCache_( const INT iMagazineCache ) const
+{
+    Assert( 0 <= iMagazineCache && iMagazineCache < m_cMagazineCache );
+    return (CResourceMagazineCache *)( m_rgbMagazineCache + iMagazineCache * m_cbMagazineCache );
+}
+
+
+INLINE CResourceMagazineCache *CResourceManager::PMagazineCacheCurrent_() const
+{
+    if ( m_iMagazineCacheFixed >= 0 )
+    {
+        return PMagazineCache_( m_iMagazineCacheFixed % m_cMagazineCache );
+    }
+    return PMagazineCache_( OSSyncGetCurrentProcessor() % m_cMagazineCache );
+}
+
+
+CResourceMagazine *CResourceManager::PMagazineDepotGet_( const BOOL fFull )
+{
+    ENTERCRITICALSECTION enter( &m_critMagazineDepot );
+
+    CResourceMagazine ** const ppMagazineList = fFull ? &m_pMagazineFullList : &m_pMagazineEmptyList;
+    CResourceMagazine * const pMagazine = *ppMagazineList;
+    if ( NULL != pMagazine )
+    {
+        *ppMagazineList = pMagazine->m_pMagazineNext;
+        pMagazine->m_pMagazineNext = NULL;
+        if ( fFull )
+        {
+            m_cMagazineFull--;
+        }
+    }
+
+    return pMagazine;
+}
+
+
+CResourceMagazine *CResourceManager::PMagazineDepotPut_( CResourceMagazine * const pMagazine, const BOOL fFull )
+{
+    Assert( fFull ? pMagazine->FFull() : pMagazine->FEmpty() );
+    Assert( NULL == pMagazine->m_pMagazineNext );
+
+    ENTERCRITICALSECTION enter( &m_critMagazineDepot );
+
+    if ( fFull )
+    {
+        if ( m_cMagazineFull >= m_cMagazineFullMax )
+        {
+            return pMagazine;
+        }
+        pMagazine->m_pMagazineNext = m_pMagazineFullList;
+        m_pMagazineFullList = pMagazine;
+        m_cMagazineFull++;
+    }
+    else
+    {
+        pMagazine->m_pMagazineNext = m_pMagazineEmptyList;
+        m_pMagazineEmptyList = pMagazine;
+    }
+
+    return NULL;
+}
+
+
+VOID *CResourceManager::PvMagazineAlloc_()
+{
+    if ( 0 == m_cMagazineCache )
+    {
+        return NULL;
+    }
+
+    CResourceMagazineCache * const pmc = PMagazineCacheCurrent_();
+    if ( !pmc->m_crit.FTryEnter() )
+    {
+        return NULL;
+    }
+
+    if ( pmc->m_pMagazineLoaded->FEmpty() )
+    {
+        if ( !pmc->m_pMagazinePrevious->FEmpty() )
+        {
+            CResourceMagazine * const pMagazine = pmc->m_pMagazineLoaded;
+            pmc->m_pMagazineLoaded = pmc->m_pMagazinePrevious;
+            pmc->m_pMagazinePrevious = pMagazine;
+        }
+        else
+        {
+            CResourceMagazine * const pMagazineFull = PMagazineDepotGet_( fTrue );
+            if ( NULL == pMagazineFull )
+            {
+                pmc->m_crit.Leave();
+                return NULL;
+            }
+            CResourceMagazine * const pMagazineOverflow = PMagazineDepotPut_( pmc->m_pMagazinePrevious, fFalse );
+            Assert( NULL == pMagazineOverflow );
+            pmc->m_pMagazinePrevious = pmc->m_pMagazineLoaded;
+            pmc->m_pMagazineLoaded = pMagazineFull;
+        }
+    }
+
+    CResourceMagazine * const pMagazine = pmc->m_pMagazineLoaded;
+    Assert( !pMagazine->FEmpty() );
+    VOID * const pv = pMagazine->m_rgpv[ --pMagazine->m_cRounds ];
+
+    pmc->m_crit.Leave();
+    return pv;
+}
+
+
+BOOL CResourceManager::FMagazineFree_( VOID * const pv )
+{
+    if ( 0 == m_cMagazineCache )
+    {
+        return fFalse;
+    }
+
+    CResourceMagazineCache * const pmc = PMagazineCacheCurrent_();
+    if ( !pmc->m_crit.FTryEnter() )
+    {
+        return fFalse;
+    }
+
+    CResourceMagazine *pMagazineOverflow = NULL;
+
+    if ( pmc->m_pMagazineLoaded->FFull() )
+    {
+        if ( pmc->m_pMagazinePrevious->FEmpty() )
+        {
+            CResourceMagazine * const pMagazine = pmc->m_pMagazineLoaded;
+            pmc->m_pMagazineLoaded = pmc->m_pMagazinePrevious;
+            pmc->m_pMagazinePrevious = pMagazine;
+        }
+        else
+        {
+            CResourceMagazine *pMagazineEmpty = PMagazineDepotGet_( fFalse );
+            if ( NULL == pMagazineEmpty )
             {
-                OSMemoryPageFree( pvData );
+                pMagazineEmpty = new CResourceMagazine;
+                if ( NULL == pMagazineEmpty )
+                {
+                    pmc->m_crit.Leave();
+                    return fFalse;
+                }
             }
+            pMagazineOverflow = PMagazineDepotPut_( pmc->m_pMagazinePrevious, fTrue );
+            pmc->m_pMagazinePrevious = pmc->m_pMagazineLoaded;
+            pmc->m_pMagazineLoaded = pMagazineEmpty;
+        }
+    }
+
+    CResourceMagazine * const pMagazine = pmc->m_pMagazineLoaded;
+    Assert( !pMagazine->FFull() );
+    pMagazine->m_rgpv[ pMagazine->m_cRounds++ ] = pv;
+
+    pmc->m_crit.Leave();
+
+    if ( NULL != pMagazineOverflow )
+    {
+        while ( !pMagazineOverflow->FEmpty() )
+        {
+            FreeToChunk_( pMagazineOverflow->m_rgpv[ --pMagazineOverflow->m_cRounds ] );
+        }
+        pMagazineOverflow = PMagazineDepotPut_( pMagazineOverflow, fFalse );
+        Assert( NULL == pMagazineOverflow );
+    }
+
+    return fTrue;
+}
+
+
+VOID *CResourceManager::PvMagazineFlush_()
+{
+    for ( INT iMagazineCache = 0; iMagazineCache < m_cMagazineCache; iMagazineCache++ )
+    {
+        CResourceMagazineCache * const pmc = PMagazineCache_( iMagazineCache );
+        if ( NULL != pmc->m_pMagazineLoaded && !pmc->m_pMagazineLoaded->FEmpty() )
+        {
+            return pmc->m_pMagazineLoaded->m_rgpv[ --pmc->m_pMagazineLoaded->m_cRounds ];
+        }
+        if ( NULL != pmc->m_pMagazinePrevious && !pmc->m_pMagazinePrevious->FEmpty() )
+        {
+            return pmc->m_pMagazinePrevious->m_rgpv[ --pmc->m_pMagazinePrevious->m_cRounds ];
+        }
+    }
+
+    while ( NULL != m_pMagazineFullList )
+    {
+        CResourceMagazine * const pMagazine = m_pMagazineFullList;
+        if ( !pMagazine->FEmpty() )
+        {
+            return pMagazine->m_rgpv[ --pMagazine->m_cRounds ];
+        }
+        m_pMagazineFullList = pMagazine->m_pMagazineNext;
+        m_cMagazineFull--;
+        pMagazine->m_pMagazineNext = m_pMagazineEmptyList;
+        m_pMagazineEmptyList = pMagazine;
+    }
+
+    return NULL;
+}
+
+
+VOID CResourceManager::MagazineDrain()
+{
+    for ( INT iMagazineCache = 0; iMagazineCache < m_cMagazineCache; iMagazineCache++ )
+    {
+        CResourceMagazineCache * const pmc = PMagazineCache_( iMagazineCache );
+        VOID    *rgpv[ 2 * CResourceMagazine::cRoundsMax ];
+        INT     cpv     = 0;
+
+        pmc->m_crit.Enter();
+        while ( !pmc->m_pMagazineLoaded->FEmpty() )
+        {
+            rgpv[ cpv++ ] = pmc->m_pMagazineLoaded->m_rgpv[ --pmc->m_pMagazineLoaded->m_cRounds ];
+        }
+        while ( !pmc->m_pMagazinePrevious->FEmpty() )
+        {
+            rgpv[ cpv++ ] = pmc->m_pMagazinePrevious->m_rgpv[ --pmc->m_pMagazinePrevious->m_cRounds ];
+        }
+        pmc->m_crit.Leave();
+
+        while ( cpv > 0 )
+        {
+            FreeToChunk_( rgpv[ --cpv ] );
+        }
+    }
+
+    CResourceMagazine *pMagazineFullList = NULL;
+    {
+    ENTERCRITICALSECTION enter( &m_critMagazineDepot );
+    pMagazineFullList = m_pMagazineFullList;
+    m_pMagazineFullList = NULL;
+    m_cMagazineFull = 0;
+    }
+
+    while ( NULL != pMagazineFullList )
+    {
+        CResourceMagazine * const pMagazine = pMagazineFullList;
+        pMagazineFullList = pMagazine->m_pMagazineNext;
+        pMagazine->m_pMagazineNext = NULL;
+
+        while ( !pMagazine->FEmpty() )
+        {
+            FreeToChunk_( pMagazine->m_rgpv[ --pMagazine->m_cRounds ] );
         }
+        CResourceMagazine * const pMagazineOverflow = PMagazineDepotPut_( pMagazine, fFalse );
+        Assert( NULL == pMagazineOverflow );
+    }
+}
+
+
+LONG CResourceManager::CMagazineObjects() const
+{
+    LONG cObjects = 0;
+
+    for ( INT iMagazineCache = 0; iMagazineCache < m_cMagazineCache; iMagazineCache++ )
+    {
+        const CResourceMagazineCache * const pmc = PMagazineCache_( iMagazineCache );
+        cObjects += pmc->m_pMagazineLoaded->m_cRounds + pmc->m_pMagazinePrevious->m_cRounds;
+    }
+
+    for ( const CResourceMagazine *pMagazine = m_pMagazineFullList; NULL != pMagazine; pMagazine = pMagazine->m_pMagazineNext )
+    {
+        cObjects += pMagazine->m_cRounds;
+    }
+
+    return cObjects;
+}
+
+
+LONG CResourceManager::CChunkObjectsUsed() const
+{
+    LONG cObjects = 0;
+
+    for ( const CResourceChunkInfo *pRCI = m_pRCIList; NULL != pRCI; pRCI = pRCI->m_pRCINext )
+    {
+        cObjects += pRCI->m_cUsed >= cChunkProtect ? pRCI->m_cUsed - cChunkProtect : pRCI->m_cUsed;
     }
+
+    return cObjects;
 }
 
 
@@ -1377,7 +1751,11 @@ VOID *CResourceManager::PvAlloc_(
 #ifdef RM_DEFERRED_FREE
         AssertSz( NULL == m_lookaside.PvGet( DwUtilThreadId() ), "Lookaside should be always empty with deferred frees on." );
 #else
-        pvResult = m_lookaside.PvGet( DwUtilThreadId() );
+        pvResult = PvMagazineAlloc_();
+        if ( NULL == pvResult )
+        {
+            pvResult = m_lookaside.PvGet( DwUtilThreadId() );
+        }
 #endif
 
         if ( NULL == pvResult )
@@ -2317,6 +2695,50 @@ class CResourceTestFixture : public JetTestFixture
 
         }
 
+        void TestMagazineDepotOverflow()
+        {
+            CHECK( JET_errSuccess == m_resource.ErrInit( m_resid ) );
+
+            CResourceManager * const prm = CRMContainer::PRMFind( m_resid );
+            CHECK( NULL != prm );
+            CHECK( 0 == prm->CMagazineObjects() );
+            prm->SetMagazineCacheFixed( 0 );
+
+
+            void * const pv = m_resource.PvRESAlloc();
+            CHECK( NULL != pv );
+            m_resource.Free( pv );
+            CHECK( 1 == prm->CMagazineObjects() );
+            CHECK( 1 == prm->CChunkObjectsUsed() );
+            CHECK( pv == m_resource.PvRESAlloc() );
+            CHECK( 0 == prm->CMagazineObjects() );
+            m_resource.Free( pv );
+
+
+            for ( INT i = 0; i < _countof(m_rgpv); i++ )
+            {
+                m_rgpv[i] = m_resource.PvRESAlloc();
+                CHECK( NULL != m_rgpv[i] );
+            }
+            CHECK( _countof(m_rgpv) == prm->CChunkObjectsUsed() );
+
+            for ( INT i = 0; i < _countof(m_rgpv); i++ )
+            {
+                m_resource.Free( m_rgpv[i] );
+                m_rgpv[i] = NULL;
+            }
+            CHECK( 0 < prm->CMagazineDepotFull() );
+            CHECK( 2 * CResourceMagazine::cRoundsMax < prm->CMagazineObjects() );
+            CHECK( prm->CMagazineObjects() == prm->CChunkObjectsUsed() );
+
+
+            prm->MagazineDrain();
+            CHECK( 0 == prm->CMagazineObjects() );
+            CHECK( 0 == prm->CMagazineDepotFull() );
+            CHECK( 0 == prm->CChunkObjectsUsed() );
+            prm->SetMagazineCacheFixed( -1 );
+        }
+
         void TestDoubleFree()
         {
             CHECK( JET_errSuccess == m_resource.ErrInit( m_resid ) );
@@ -2343,6 +2765,7 @@ static const JetTestCaller<CResourceTestFixtureDefault> crtf3("CResource.CreateF
 static const JetTestCaller<CResourceTestFixtureDefault> crtf4("CResource.MultithreadedCreateFree", &CResourceTestFixtureDefault::TestMultithreadedCreateFree);
 static const JetTestCaller<CResourceTestFixtureNoLookaside> crtf5("CResource.CreateFreeWithNoLookaside", &CResourceTestFixtureNoLookaside::TestCreateFree);
 static const JetTestCaller<CResourceTestFixtureNoLookaside> crtf6("CResource.MultithreadedCreateFreeWithNoLookaside", &CResourceTestFixtureNoLookaside::TestMultithreadedCreateFree);
+static const JetTestCaller<CResourceTestFixtureDefault> crtf7("CResource.MagazineDepotOverflow", &CResourceTestFixtureDefault::TestMagazineDepotOverflow);
 
 #endif
 
@@ -17,6 +17,8 @@ PERFInstanceDelayedTotal< LONG, INST, fFalse > perfctrDBMThrottleSetting;
 PERFInstanceDelayedTotal<> perfctrDBMIOReReads;
 PERFInstanceDelayedTotal<> perfctrDBMFollowerSkips;
 PERFInstanceDelayedTotal<> perfctrDBMFollowerDivChecked;
+PERFInstanceDelayedTotal< LONG, INST, fFalse > perfctrDBMScanRate;
+PERFInstanceDelayedTotal< LONG, INST, fFalse > perfctrDBMEstimatedSecondsRemaining;
 
 
 LONG LDBMaintDurationCEFLPv( LONG iInstance, VOID * pvBuf )
@@ -85,6 +87,18 @@ LONG LDBMaintFollowerDivergentCheckedCEFLPv( LONG iInstance, VOID * pvBuf )
     return 0;
 }
 
+LONG LDBMaintScanRateCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    perfctrDBMScanRate.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+LONG LDBMaintEstimatedSecondsRemainingCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    perfctrDBMEstimatedSecondsRemaining.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
 #endif
 
 
@@ -99,6 +113,8 @@ public:
     
     virtual INT     CSecMinScanTime() = 0;
 
+    virtual INT     CSecPassTarget() = 0;
+
     virtual CPG CpgBatch() = 0;
 
     virtual DWORD   DwThrottleSleep() = 0;
@@ -221,6 +237,27 @@ private:
 class IDBMScanSerializer;
 
 
+class DBMScanPacer
+{
+public:
+    DBMScanPacer();
+
+    void StartPacing( const DWORD dwThrottleSleep, const bool fAllowSpeedup );
+    void BatchRead( const CPG cpg, const QWORD cusecRead, const bool fBehindSchedule );
+
+    DWORD DwThrottleSleep() const       { return m_dwSleep; }
+    QWORD CusecPerPageBaseline() const  { return m_cusecPerPageBaseline; }
+
+    static const QWORD s_cusecPerPageElevatedMin = 250;
+
+private:
+    DWORD   m_dwSleepBase;
+    DWORD   m_dwSleepMin;
+    DWORD   m_dwSleepMax;
+    DWORD   m_dwSleep;
+    QWORD   m_cusecPerPageBaseline;
+};
+
 class DBMScan : public IDBMScan
 {
 public:
@@ -271,6 +308,8 @@ private:
     bool FTimeLimitReached_() const;
     INT CMSecBeforeTimeLimit_() const;
     bool FMaxScansReached_() const;
+    bool FBehindSchedule_( const __int64 ftNow ) const;
+    void ReportProgress_( const CPG cpgScannedSinceStart, const DWORD dtickElapsed ) const;
     
 private:
     unique_ptr<IDBMScanConfig>    m_pscanconfig;
@@ -288,6 +327,8 @@ private:
 
     IDBMScanSerializer *    m_pidbmScanSerializationObj;
 
+    DBMScanPacer m_pacer;
+
     INT m_cscansFinished;
     __int64 m_ftTimeLimit;
 
@@ -625,6 +666,7 @@ public:
     virtual INT CScansMax() { return INT_MAX; }
     virtual INT CSecMax() { return INT_MAX; }
     virtual INT CSecMinScanTime();
+    virtual INT CSecPassTarget();
     virtual CPG CpgBatch();
     virtual DWORD DwThrottleSleep();
     virtual bool FSerializeScan();
@@ -647,6 +689,7 @@ public:
     virtual INT CScansMax()         { return 1; }
     virtual INT CSecMax()           { return m_csecMax; }
     virtual INT CSecMinScanTime()   { return 0; }
+    virtual INT CSecPassTarget()    { return 0; }
     virtual DWORD DwThrottleSleep() { return m_dwThrottleSleep; }
     virtual INST * Pinst()          { return NULL; }
 
@@ -2037,6 +2080,11 @@ INT DBMScanConfig::CSecMinScanTime()
     return ( INT )UlParam( m_pinst, JET_paramDbScanIntervalMinSec );
 }
 
+INT DBMScanConfig::CSecPassTarget()
+{
+    return ( INT )UlParam( m_pinst, JET_paramDbScanIntervalMaxSec );
+}
+
 CPG DBMScanConfig::CpgBatch()
 {
     size_t  cbScanBuffer    = ( size_t )UlParam( JET_paramMaxCoalesceReadSize );
@@ -3652,6 +3700,65 @@ void DBMObjectCache::CloseObjectAt_( const INT index )
 }
 
 
+
+DBMScanPacer::DBMScanPacer() :
+    m_dwSleepBase( 0 ),
+    m_dwSleepMin( 0 ),
+    m_dwSleepMax( 0 ),
+    m_dwSleep( 0 ),
+    m_cusecPerPageBaseline( 0 )
+{
+}
+
+void DBMScanPacer::StartPacing( const DWORD dwThrottleSleep, const bool fAllowSpeedup )
+{
+    m_dwSleepBase = dwThrottleSleep;
+    m_dwSleepMin = fAllowSpeedup ? ( dwThrottleSleep / 4 ) : dwThrottleSleep;
+    m_dwSleepMax = max( dwThrottleSleep, min( max( 16 * dwThrottleSleep, (DWORD)100 ), (DWORD)10000 ) );
+    m_dwSleep = dwThrottleSleep;
+    m_cusecPerPageBaseline = 0;
+}
+
+void DBMScanPacer::BatchRead( const CPG cpg, const QWORD cusecRead, const bool fBehindSchedule )
+{
+    Assert( cpg > 0 );
+    const QWORD cusecPerPage = cusecRead / cpg;
+
+    if ( 0 == m_cusecPerPageBaseline )
+    {
+        m_cusecPerPageBaseline = max( cusecPerPage, (QWORD)1 );
+        return;
+    }
+
+    if ( cusecPerPage > 2 * m_cusecPerPageBaseline && cusecPerPage > s_cusecPerPageElevatedMin )
+    {
+        m_dwSleep = min( max( 2 * m_dwSleep, (DWORD)1 ), m_dwSleepMax );
+        m_cusecPerPageBaseline += ( cusecPerPage - m_cusecPerPageBaseline ) / 64;
+        return;
+    }
+
+    if ( cusecPerPage >= m_cusecPerPageBaseline )
+    {
+        m_cusecPerPageBaseline += ( cusecPerPage - m_cusecPerPageBaseline ) / 8;
+    }
+    else
+    {
+        m_cusecPerPageBaseline -= ( m_cusecPerPageBaseline - cusecPerPage ) / 8;
+    }
+    m_cusecPerPageBaseline = max( m_cusecPerPageBaseline, (QWORD)1 );
+
+    const bool fIdle = cusecPerPage <= m_cusecPerPageBaseline;
+    const DWORD dwSleepTarget = ( fBehindSchedule || fIdle ) ? m_dwSleepMin : m_dwSleepBase;
+    if ( m_dwSleep > dwSleepTarget )
+    {
+        m_dwSleep -= max( ( m_dwSleep - dwSleepTarget ) / 4, (DWORD)1 );
+    }
+    else
+    {
+        m_dwSleep = dwSleepTarget;
+    }
+}
+
     
 DBMScan::DBMScan(
         IDBMScanState * const pscanstate,
@@ -3667,6 +3774,7 @@ DBMScan::DBMScan(
     m_msigDBScanStop( CSyncBasicInfo( _T("DBMScan::m_msigDBScanStop" ) ) ),
     m_msigDBScanGo( CSyncBasicInfo( _T("DBMScan::m_msigDBScanGo" ) ) ),
     m_pidbmScanSerializationObj( NULL ),
+    m_pacer(),
     m_cscansFinished( 0 ),
     m_fNeedToSuspendPass( false ),
     m_fSerializeScan( false )
@@ -3864,6 +3972,8 @@ DWORD DBMScan::DwDBMScan_()
     if ( m_pscanconfig->Pinst() )
     {
         PERFOpt( perfctrDBMThrottleSetting.Set( m_pscanconfig->Pinst(), 0 ) );
+        PERFOpt( perfctrDBMScanRate.Set( m_pscanconfig->Pinst(), 0 ) );
+        PERFOpt( perfctrDBMEstimatedSecondsRemaining.Set( m_pscanconfig->Pinst(), 0 ) );
     }
 
     if ( m_fNeedToSuspendPass )
@@ -3881,9 +3991,13 @@ void DBMScan::DoOnePass_()
     DWORD tickStart = 0;
     DWORD dtickTimeSlice = 0;
     __int64 iSecNotifyStart = UtilGetCurrentFileTime();
+    const DWORD tickPacingStart = TickOSTimeCurrent();
+    const CPG cpgScannedAtStart = m_pscanstate->CpgScannedCurrPass();
     cpgBatch = min( cpgBatch, m_pscanreader->cpgPrereadMax );
 
-    while ( !m_msigDBScanStop.FWait( m_pscanconfig->DwThrottleSleep() ) && !FTimeLimitReached_() )
+    m_pacer.StartPacing( m_pscanconfig->DwThrottleSleep(), m_pscanconfig->CSecPassTarget() > 0 );
+
+    while ( !m_msigDBScanStop.FWait( m_pacer.DwThrottleSleep() ) && !FTimeLimitReached_() )
         {
             if ( !fRunnable )
             {
@@ -3909,10 +4023,15 @@ void DBMScan::DoOnePass_()
 
                 if ( cpgScan > 0 )
                 {
+                    HRT dhrtRead = 0;
+                    HRT hrtStart = HrtHRTCount();
                     m_pscanreader->PrereadPages( pgnoFirst, cpgScan );
+                    dhrtRead += HrtHRTCount() - hrtStart;
                     for ( PGNO pgno = pgnoFirst; pgno < pgnoFirst + cpgScan; ++pgno )
                     {
+                        hrtStart = HrtHRTCount();
                         const ERR err = m_pscanreader->ErrReadPage( pgno );
+                        dhrtRead += HrtHRTCount() - hrtStart;
                         switch ( err )
                         {
                             case JET_errFileIOBeyondEOF:
@@ -3931,6 +4050,14 @@ void DBMScan::DoOnePass_()
                         PassReadPage_( pgno );
                         m_pscanreader->DoneWithPreread( pgno );
                     }
+
+                    const DWORD dwSleepPrev = m_pacer.DwThrottleSleep();
+                    m_pacer.BatchRead( cpgScan, CusecHRTFromDhrt( dhrtRead ), FBehindSchedule_( UtilGetCurrentFileTime() ) );
+                    if ( m_pscanconfig->Pinst() && m_pacer.DwThrottleSleep() != dwSleepPrev )
+                    {
+                        PERFOpt( perfctrDBMThrottleSetting.Set( m_pscanconfig->Pinst(), m_pacer.DwThrottleSleep() ) );
+                    }
+                    ReportProgress_( m_pscanstate->CpgScannedCurrPass() - cpgScannedAtStart, TickOSTimeCurrent() - tickPacingStart );
                 }
                 else
                 {
@@ -4064,6 +4191,36 @@ bool DBMScan::FTimeLimitReached_() const
     return UtilGetCurrentFileTime() >= m_ftTimeLimit;
 }
 
+bool DBMScan::FBehindSchedule_( const __int64 ftNow ) const
+{
+    const INT csecPassTarget = m_pscanconfig->CSecPassTarget();
+    const __int64 ftPassStart = m_pscanstate->FtCurrPassStartTime();
+    if ( csecPassTarget <= 0 || 0 == ftPassStart || ftNow <= ftPassStart )
+    {
+        return false;
+    }
+
+    const QWORD csecElapsed = ( QWORD )UtilConvertFileTimeToSeconds( ftNow - ftPassStart );
+    const QWORD cpgScanned = ( QWORD )m_pscanstate->CpgScannedCurrPass();
+    const QWORD cpgTotal = ( QWORD )m_pscanreader->PgnoLast();
+
+    return cpgScanned * ( QWORD )csecPassTarget < cpgTotal * csecElapsed;
+}
+
+void DBMScan::ReportProgress_( const CPG cpgScannedSinceStart, const DWORD dtickElapsed ) const
+{
+    INST * const pinst = m_pscanconfig->Pinst();
+    if ( NULL == pinst || 0 == dtickElapsed || cpgScannedSinceStart <= 0 )
+    {
+        return;
+    }
+
+    const __int64 cpgPerSec = max( ( 1000 * ( __int64 )cpgScannedSinceStart ) / ( __int64 )dtickElapsed, 1LL );
+    const __int64 cpgRemaining = max( ( __int64 )m_pscanreader->PgnoLast() - ( __int64 )m_pscanstate->CpgScannedCurrPass(), 0LL );
+    PERFOpt( perfctrDBMScanRate.Set( pinst, ( LONG )min( cpgPerSec, ( __int64 )lMax ) ) );
+    PERFOpt( perfctrDBMEstimatedSecondsRemaining.Set( pinst, ( LONG )min( cpgRemaining / cpgPerSec, ( __int64 )lMax ) ) );
+}
+
 INT DBMScan::CMSecBeforeTimeLimit_() const
 {
     __int64 cmsecBeforeTimeLimit = 1000 * UtilConvertFileTimeToSeconds( m_ftTimeLimit - UtilGetCurrentFileTime() );
@@ -5391,6 +5548,7 @@ public:
     virtual INT CScansMax() { return m_cscansMax; }
     virtual INT CSecMax() { return m_csecMax; }
     virtual INT     CSecMinScanTime() { return m_csecMinScanTime; }
+    virtual INT     CSecPassTarget() { return 0; }
     virtual CPG     CpgBatch() { return m_cpgBatch; }
     virtual DWORD   DwThrottleSleep() { return m_dwThrottleSleep; }
     virtual bool    FSerializeScan() { return m_fSerializeScan; }
@@ -5426,6 +5584,62 @@ TestDBMScanConfig::TestDBMScanConfig() :
 {
 }
 
+JETUNITTEST( DBMScanPacer, BacksOffWhenLatencyRises )
+{
+    DBMScanPacer pacer;
+    pacer.StartPacing( 20, false );
+    CHECK( 20 == pacer.DwThrottleSleep() );
+
+    pacer.BatchRead( 16, 16 * 100, false );
+    CHECK( 100 == pacer.CusecPerPageBaseline() );
+    CHECK( 20 == pacer.DwThrottleSleep() );
+
+    pacer.BatchRead( 16, 16 * 1000, false );
+    CHECK( 40 == pacer.DwThrottleSleep() );
+    pacer.BatchRead( 16, 16 * 1000, false );
+    CHECK( 80 == pacer.DwThrottleSleep() );
+    for ( INT i = 0; i < 20; i++ )
+    {
+        pacer.BatchRead( 16, 16 * 1000, false );
+    }
+    CHECK( 320 == pacer.DwThrottleSleep() );
+
+    for ( INT i = 0; i < 100; i++ )
+    {
+        pacer.BatchRead( 16, 16 * 50, false );
+    }
+    CHECK( 20 == pacer.DwThrottleSleep() );
+}
+
+JETUNITTEST( DBMScanPacer, SpeedsUpOnlyWhenAllowed )
+{
+    DBMScanPacer pacer;
+    pacer.StartPacing( 20, false );
+    pacer.BatchRead( 16, 16 * 100, false );
+    for ( INT i = 0; i < 100; i++ )
+    {
+        pacer.BatchRead( 16, 16 * 100, true );
+    }
+    CHECK( 20 == pacer.DwThrottleSleep() );
+
+    pacer.StartPacing( 20, true );
+    pacer.BatchRead( 16, 16 * 100, false );
+    for ( INT i = 0; i < 100; i++ )
+    {
+        pacer.BatchRead( 16, 16 * 100, true );
+    }
+    CHECK( 5 == pacer.DwThrottleSleep() );
+}
+
+JETUNITTEST( DBMScanPacer, SmallLatencyIsNotContention )
+{
+    DBMScanPacer pacer;
+    pacer.StartPacing( 0, false );
+    pacer.BatchRead( 16, 16, false );
+    pacer.BatchRead( 16, 16 * DBMScanPacer::s_cusecPerPageElevatedMin, false );
+    CHECK( 0 == pacer.DwThrottleSleep() );
+}
+
 JETUNITTEST( TestDBMScanConfig, ConstructorSetsMembers )
 {
     TestDBMScanConfig config;
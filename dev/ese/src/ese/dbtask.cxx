@@ -309,10 +309,24 @@ bool RECTASK::FBookmarkIsLessThan( const RECTASK * ptask1, const RECTASK * ptask
 
 
 DELETERECTASK::DELETERECTASK( const PGNO pgnoFDP, FCB * const pfcb, const IFMP ifmp, const BOOKMARK& bm ) :
-    RECTASK( pgnoFDP, pfcb, ifmp, bm )
+    RECTASK( pgnoFDP, pfcb, ifmp, bm ),
+    m_rgbmNext( NULL ),
+    m_cbmNext( 0 ),
+    m_pcbmNextCleaned( NULL )
 {
 }
 
+VOID DELETERECTASK::SetPageBatch( const BOOKMARK * const rgbmNext, const INT cbmNext, INT * const pcbmNextCleaned )
+{
+    Assert( NULL != rgbmNext || 0 == cbmNext );
+    Assert( NULL != pcbmNextCleaned );
+
+    m_rgbmNext = rgbmNext;
+    m_cbmNext = cbmNext;
+    m_pcbmNextCleaned = pcbmNextCleaned;
+    *m_pcbmNextCleaned = 0;
+}
+
 ERR DELETERECTASK::ErrExecuteDbTask( PIB * const ppib )
 {
     ERR         err;
@@ -328,7 +342,7 @@ ERR DELETERECTASK::ErrExecuteDbTask( PIB * const ppib )
 
     GetBookmark( &bookmark );
 
-    Call( ErrBTDelete( pfucb, bookmark ) );
+    Call( ErrBTDelete( pfucb, bookmark, m_rgbmNext, m_cbmNext, m_pcbmNextCleaned ) );
 
 HandleError:
     DIRClose( pfucb );
@@ -776,6 +790,10 @@ BATCHRECTASK::~BATCHRECTASK()
         {
             RECTASK * const prectaskT = m_rgprectask[iptask];
             m_rgprectask[iptask] = NULL;
+            if ( prectaskT )
+            {
+                PinstFromIfmp( m_ifmp )->m_pver->DecrementCCleanupPending();
+            }
             delete prectaskT;
         }
     }
@@ -841,13 +859,13 @@ ERR BATCHRECTASK::ErrExecuteDbTask( PIB * const ppib )
             return ErrERRCheck( JET_errLogWriteFail );
         }
 
-        RECTASK * const prectaskT = m_rgprectask[iptask];
-        m_rgprectask[iptask] = NULL;
-        TASK::Dispatch( ppib, (ULONG_PTR)prectaskT );
+        const INT ctasksDispatched = CtasksDispatchNext( ppib, iptask );
+        Assert( ctasksDispatched >= 1 );
+        iptask += ctasksDispatched - 1;
 
         if( ctasksPreread > 0 )
         {
-            --ctasksPreread;
+            ctasksPreread = max( ctasksPreread - ctasksDispatched, 0 );
             if( 0 == ctasksPreread )
             {
                 PrereadTaskBookmarks( ppib, iptask+1, &ctasksPreread );
@@ -857,6 +875,50 @@ ERR BATCHRECTASK::ErrExecuteDbTask( PIB * const ppib )
     return JET_errSuccess;
 }
 
+INT BATCHRECTASK::CtasksDispatchNext( PIB * const ppib, const INT iptask )
+{
+    Assert( iptask < m_iptaskCurr );
+
+    VER * const pver = PinstFromIfmp( m_ifmp )->m_pver;
+    RECTASK * const prectaskT = m_rgprectask[iptask];
+    m_rgprectask[iptask] = NULL;
+    pver->DecrementCCleanupPending();
+
+    if ( !prectaskT->FPageBatchable() )
+    {
+        TASK::Dispatch( ppib, (ULONG_PTR)prectaskT );
+        return 1;
+    }
+
+    BOOKMARK    rgbmNext[cbmPageBatchMax];
+    INT         cbmNext         = 0;
+    INT         cbmNextCleaned  = 0;
+
+    while ( cbmNext < cbmPageBatchMax
+        && iptask + 1 + cbmNext < m_iptaskCurr
+        && m_rgprectask[iptask + 1 + cbmNext]->FPageBatchable() )
+    {
+        m_rgprectask[iptask + 1 + cbmNext]->GetBookmark( &rgbmNext[cbmNext] );
+        cbmNext++;
+    }
+
+    static_cast<DELETERECTASK *>( prectaskT )->SetPageBatch( rgbmNext, cbmNext, &cbmNextCleaned );
+    TASK::Dispatch( ppib, (ULONG_PTR)prectaskT );
+    Assert( cbmNextCleaned >= 0 );
+    Assert( cbmNextCleaned <= cbmNext );
+
+    for ( INT ibm = 0; ibm < cbmNextCleaned; ++ibm )
+    {
+        RECTASK * const prectaskCleaned = m_rgprectask[iptask + 1 + ibm];
+        m_rgprectask[iptask + 1 + ibm] = NULL;
+        pver->DecrementCCleanupPending();
+        pver->IncrementCCleanupCoalesced();
+        delete prectaskCleaned;
+    }
+
+    return 1 + cbmNextCleaned;
+}
+
 
 VOID BATCHRECTASK::HandleError( const ERR err )
 {
@@ -990,6 +1052,7 @@ ERR RECTASKBATCHER::ErrPost( RECTASK * prectask )
                 Call( pbatchrectask->ErrAddTask( prectask ) );
                 fTaskAdded = true;
                 fFoundBatchTask = true;
+                m_pinst->m_pver->IncrementCCleanupPending();
                 m_ctasksBatched++;
                 Assert( m_ctasksBatched > 0 );
                 if( pbatchrectask->CTasks() >= m_ctasksPerBatchMax )
@@ -1016,6 +1079,7 @@ ERR RECTASKBATCHER::ErrPost( RECTASK * prectask )
             Alloc( m_rgpbatchtask[ipbatchtaskFree] = new BATCHRECTASK( prectask->PgnoFDP(), prectask->Ifmp() ) );
             Call( m_rgpbatchtask[ipbatchtaskFree]->ErrAddTask( prectask ) );
             fTaskAdded = true;
+            m_pinst->m_pver->IncrementCCleanupPending();
             Assert( 1 == m_rgpbatchtask[ipbatchtaskFree]->CTasks() );
             m_ctasksBatched++;
             Assert( m_ctasksBatched > 0 );
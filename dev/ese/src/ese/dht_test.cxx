@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "std.hxx"
+
+#ifndef ENABLE_JET_UNIT_TEST
+#error This file should only be compiled with the unit tests!
+#endif
+
+
+struct DHTBENCHKEY
+{
+    ULONG_PTR   m_key;
+};
+
+struct DHTBENCHENTRY
+{
+    ULONG_PTR   m_key;
+    ULONG_PTR   m_value;
+};
+
+typedef CDynamicHashTable< DHTBENCHKEY, DHTBENCHENTRY > DHTBENCHHASH;
+
+INLINE DHTBENCHHASH::NativeCounter DHTBENCHHASH::CKeyEntry::Hash( const DHTBENCHKEY& key )
+{
+    return DHTBENCHHASH::NativeCounter( key.m_key * 0x9E3779B1 );
+}
+
+INLINE DHTBENCHHASH::NativeCounter DHTBENCHHASH::CKeyEntry::Hash() const
+{
+    return DHTBENCHHASH::NativeCounter( m_entry.m_key * 0x9E3779B1 );
+}
+
+INLINE BOOL DHTBENCHHASH::CKeyEntry::FEntryMatchesKey( const DHTBENCHKEY& key ) const
+{
+    return m_entry.m_key == key.m_key;
+}
+
+INLINE void DHTBENCHHASH::CKeyEntry::SetEntry( const DHTBENCHENTRY& entry )
+{
+    m_entry = entry;
+}
+
+INLINE void DHTBENCHHASH::CKeyEntry::GetEntry( DHTBENCHENTRY* const pentry ) const
+{
+    *pentry = m_entry;
+}
+
+
+JETUNITBENCHMARK( DHT, RetrieveEntry )
+{
+    const ULONG_PTR cEntry = 64 * 1024;
+
+    DHTBENCHHASH hash( 0 );
+    CHECK( DHTBENCHHASH::ERR::errSuccess == hash.ErrInit( 5.0, 1.0 ) );
+
+    for ( ULONG_PTR iEntry = 0; iEntry < cEntry; iEntry++ )
+    {
+        DHTBENCHKEY         key     = { iEntry };
+        DHTBENCHENTRY       entry   = { iEntry, ~iEntry };
+        DHTBENCHHASH::CLock lock;
+
+        hash.WriteLockKey( key, &lock );
+        CHECK( DHTBENCHHASH::ERR::errSuccess == hash.ErrInsertEntry( &lock, entry ) );
+        hash.WriteUnlockKey( &lock );
+    }
+
+    ULONG_PTR iEntry = 0;
+    ULONG_PTR cMiss = 0;
+    BENCHMARK_ITERATE()
+    {
+        DHTBENCHKEY         key     = { iEntry };
+        DHTBENCHENTRY       entry;
+        DHTBENCHHASH::CLock lock;
+
+        hash.ReadLockKey( key, &lock );
+        if ( DHTBENCHHASH::ERR::errSuccess != hash.ErrRetrieveEntry( &lock, &entry ) )
+        {
+            cMiss++;
+        }
+        hash.ReadUnlockKey( &lock );
+
+        iEntry = ( iEntry + 7919 ) % cEntry;
+    }
+
+    CHECK( 0 == cMiss );
+
+    for ( ULONG_PTR iEntryDelete = 0; iEntryDelete < cEntry; iEntryDelete++ )
+    {
+        DHTBENCHKEY         key     = { iEntryDelete };
+        DHTBENCHHASH::CLock lock;
+
+        hash.WriteLockKey( key, &lock );
+        CHECK( DHTBENCHHASH::ERR::errSuccess == hash.ErrDeleteEntry( &lock ) );
+        hash.WriteUnlockKey( &lock );
+    }
+
+    hash.Term();
+}
@@ -7,6 +7,39 @@
 const JET_TRACETAG  tracetagIndexPerf   = JET_tracetagBtree;
 #endif
 
+#ifdef PERFMON_SUPPORT
+
+PERFInstanceDelayedTotal<> cFILEIndexBuildRecordsScanned;
+PERFInstanceDelayedTotal<> cFILEIndexBuildKeysExtracted;
+PERFInstanceDelayedTotal<> cFILEIndexBuildKeysLoaded;
+PERFInstanceDelayedTotal<> cFILEIndexBuildIndexesCompleted;
+
+LONG LFILEIndexBuildRecordsScannedCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cFILEIndexBuildRecordsScanned.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+LONG LFILEIndexBuildKeysExtractedCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cFILEIndexBuildKeysExtracted.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+LONG LFILEIndexBuildKeysLoadedCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cFILEIndexBuildKeysLoaded.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+LONG LFILEIndexBuildIndexesCompletedCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cFILEIndexBuildIndexesCompleted.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+#endif
+
 
 CCriticalSection    g_critUnverCol( CLockBasicInfo( CSyncBasicInfo( szFILEUnverCol ), rankFILEUnverCol, 0 ) );
 CCriticalSection    g_critUnverIndex( CLockBasicInfo( CSyncBasicInfo( szFILEUnverIndex ), rankFILEUnverIndex, 0 ) );
@@ -3725,6 +3758,22 @@ ERR ErrFILEIndexBatchAddEntry(
 }
 
 
+LOCAL VOID FILEISetAppendSpaceReserve( FUCB * const pfucbSort, FUCB * const pfucbIndex )
+{
+    const LONG  cbPageAvail = CbNDPageAvailMostNoInsert( g_rgfmp[ pfucbIndex->ifmp ].CbPage() )
+                                - (LONG)pfucbIndex->u.pfcb->CbDensityFree();
+    const QWORD cpgEstimate = CbSORTRecords( pfucbSort ) / max( cbPageAvail, 1 );
+    const CPG   cpgReserve  = (CPG)min( cpgEstimate, (QWORD)cpgFILEIndexAppendReserveMax );
+
+    Assert( 0 == CpgDIRActiveSpaceRequestReserve( pfucbIndex ) );
+
+    if ( cpgReserve > 1 )
+    {
+        DIRSetActiveSpaceRequestReserve( pfucbIndex, cpgReserve - 1 );
+    }
+}
+
+
 INLINE ERR ErrFILEIAppendToIndex(
     FUCB        * const pfucbSort,
     FUCB        * const pfucbIndex,
@@ -3736,13 +3785,14 @@ INLINE ERR ErrFILEIAppendToIndex(
     INST * const    pinst       = PinstFromPfucb( pfucbIndex );
 
     CallR( ErrDIRInitAppend( pfucbIndex ) );
+    FILEISetAppendSpaceReserve( pfucbSort, pfucbIndex );
     do
     {
-        CallR( pinst->ErrCheckForTermination() );
+        Call( pinst->ErrCheckForTermination() );
 
-        CallR( pinst->m_plog->ErrLGCheckState() );
+        Call( pinst->m_plog->ErrLGCheckState() );
 
-        CallR( ErrDIRAppend(
+        Call( ErrDIRAppend(
                     pfucbIndex,
                     pfucbSort->kdfCurr.key,
                     pfucbSort->kdfCurr.data,
@@ -3757,6 +3807,8 @@ INLINE ERR ErrFILEIAppendToIndex(
     if ( JET_errNoCurrentRecord == err )
         err = ErrDIRTermAppend( pfucbIndex );
 
+HandleError:
+    DIRResetActiveSpaceRequestReserve( pfucbIndex );
     return err;
 }
 
@@ -4006,6 +4058,8 @@ LOCAL ERR ErrFILESingleIndexTerm(
                         &cRecOutput,
                         fLogged ) );
 
+            PERFOpt( cFILEIndexBuildKeysLoaded.Add( PinstFromPpib( ppib ), cRecOutput ) );
+
 #ifdef SHOW_INDEX_PERF
             OSTraceIndent( tracetagIndexPerf, +1 );
             OSTrace( tracetagIndexPerf, OSFormat(   "Appended %d keys for index %d in %d msecs.\n",
@@ -4072,6 +4126,8 @@ LOCAL ERR ErrFILESingleIndexTerm(
         }
     }
 
+    PERFOpt( cFILEIndexBuildIndexesCompleted.Inc( PinstFromPpib( ppib ) ) );
+
 HandleError:
     if ( pfucbNil != pfucbIndex )
     {
@@ -4165,6 +4221,7 @@ LOCAL VOID ErrFILEIndexDispatchAddEntries(
     CSR * const                 pcsr            = (CSR *)dwParam3;
     KEYDATAFLAGS                kdf;
     LONG                        cEntriesAdded;
+    LONG                        cEntriesAddedTotal  = 0;
 
     Assert( PutcTLSGetUserContext() == NULL );
     pidxcontext->pfucbTable->ppib->SetUserTraceContextInTls();
@@ -4213,8 +4270,11 @@ LOCAL VOID ErrFILEIndexDispatchAddEntries(
 
                 Assert( cEntriesAdded >= 0 );
                 pidxcontext->rgcRecInput[iindex] += cEntriesAdded;
+                cEntriesAddedTotal += cEntriesAdded;
             }
         }
+
+        PERFOpt( cFILEIndexBuildKeysExtracted.Add( PinstFromPfucb( pidxcontext->pfucbTable ), cEntriesAddedTotal ) );
     }
 
     CLockDeadlockDetectionInfo::DisableOwnershipTracking();
@@ -4312,6 +4372,30 @@ HandleError:
     return err;
 }
 
+LOCAL ULONG UlFILEIIndexBuildWeight( const FCB * const pfcbIndex )
+{
+    const IDB * const   pidb        = pfcbIndex->Pidb();
+    Assert( pidbNil != pidb );
+
+    ULONG               ulWeight    = 1 + pidb->Cidxseg();
+
+    if ( pidb->FTuples() )
+    {
+        ulWeight *= 8;
+    }
+    else if ( pidb->FMultivalued() )
+    {
+        ulWeight *= 2;
+    }
+
+    if ( pidb->FLocalizedText() )
+    {
+        ulWeight *= 2;
+    }
+
+    return ulWeight;
+}
+
 INLINE VOID FILEIPossiblyWaitForDispatchedTasks( const CREATEINDEXCONTEXT * const pidxcontext, const ULONG iProc )
 {
     ULONG_PTR   cbfCacheT       = 0;
@@ -4604,33 +4688,51 @@ NextBuild:
     ULONG   iindexNext;
     FCB *   pfcbIndexesRemaining;
 
+    ULONG   ulWeightRemaining;
+
     cProcsCurrBatch = min( cProcs, cIndexesToBuild );
     iindexNext = 0;
     pfcbIndexesRemaining = pfcbIndexesToBuild;
 
+    ulWeightRemaining = 0;
+    for ( ULONG iindex = 0; iindex < cIndexesToBuild; iindex++, pfcbIndexesRemaining = pfcbIndexesRemaining->PfcbNextIndex() )
+    {
+        ulWeightRemaining += UlFILEIIndexBuildWeight( pfcbIndexesRemaining );
+    }
+    pfcbIndexesRemaining = pfcbIndexesToBuild;
+
     for ( iProc = 0; iProc < cProcsCurrBatch; iProc++ )
     {
         Assert( iindexNext < cIndexesToBuild );
 
         const ULONG             cIndexesRemaining   = cIndexesToBuild - iindexNext;
         const ULONG             cProcsRemaining     = cProcsCurrBatch - iProc;
-        ULONG                   cIndexesThisProc    = ( cIndexesRemaining + cProcsRemaining - 1 ) / cProcsRemaining;
+        const ULONG             ulWeightTarget      = ( ulWeightRemaining + cProcsRemaining - 1 ) / cProcsRemaining;
+        ULONG                   cIndexesThisProc    = 0;
+        ULONG                   ulWeightThisProc    = 0;
         CREATEINDEXCONTEXT *    pidxcontext         = rgidxcontext + iProc;
 
-        Assert( cIndexesThisProc > 0 );
-
         Call( pidxcontext->taskmgrCreateIndex.ErrTMInit( 1, (DWORD_PTR *)( rgpidxcontext + iProc ) ) );
 
         pidxcontext->iindexStart = iindexNext;
-        pidxcontext->cIndexesToBuild = cIndexesThisProc;
         pidxcontext->pfcbIndexesToBuild = pfcbIndexesRemaining;
 
-        iindexNext += cIndexesThisProc;
-
-        for ( ULONG iindex = 0; iindex < cIndexesThisProc; iindex++ )
+        do
         {
+            ulWeightThisProc += UlFILEIIndexBuildWeight( pfcbIndexesRemaining );
             pfcbIndexesRemaining = pfcbIndexesRemaining->PfcbNextIndex();
+            cIndexesThisProc++;
         }
+        while ( cIndexesRemaining - cIndexesThisProc > cProcsRemaining - 1
+            && ulWeightThisProc < ulWeightTarget );
+
+        Assert( cIndexesThisProc > 0 );
+        Assert( ulWeightThisProc <= ulWeightRemaining );
+
+        pidxcontext->cIndexesToBuild = cIndexesThisProc;
+
+        iindexNext += cIndexesThisProc;
+        ulWeightRemaining -= ulWeightThisProc;
 
         DIRUp( pidxcontext->pfucbTable );
         pidxcontext->err = JET_errSuccess;
@@ -4670,16 +4772,18 @@ NextBuild:
         Assert( pcsrTable->FLatched() );
         Assert( locOnCurBM == pfucbTable->locLogical );
 
+        Call( pinst->ErrCheckForTermination() );
+
+        Call( pinst->m_plog->ErrLGCheckState() );
+
+        PERFOpt( cFILEIndexBuildRecordsScanned.Add( pinst, pcsrTable->Cpage().Clines() ) );
+
         for ( iProc = 0; iProc < cProcsCurrBatch; iProc++ )
         {
             CREATEINDEXCONTEXT * const  pidxcontext     = rgidxcontext + iProc;
 
             Call( pidxcontext->err );
 
-            Call( pinst->ErrCheckForTermination() );
-
-            Call( pinst->m_plog->ErrLGCheckState() );
-
             Alloc( pcsrT = new CSR );
 
             CLockDeadlockDetectionInfo::DisableOwnershipTracking();
@@ -5490,6 +5594,7 @@ LOCAL ERR ErrFILEIBuildIndex(
 
     DIRGotoRoot( pfucbIndex );
     Call( ErrDIRInitAppend( pfucbIndex ) );
+    FILEISetAppendSpaceReserve( pfucbSort, pfucbIndex );
 
 #ifdef SHOW_INDEX_PERF
     tickStart = TickOSTimeCurrent();
@@ -5585,6 +5690,8 @@ HandleError:
         BTUp( pfucbTable );
     }
 
+    DIRResetActiveSpaceRequestReserve( pfucbIndex );
+
     Assert( NULL == pfucbIndex->pvWorkBuf );
 
     RESKEY.Free( pbKey );
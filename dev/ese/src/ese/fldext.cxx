@@ -1344,17 +1344,16 @@ LOCAL ERR ErrRECIDecompressDataForRetrieve(
         {
             const INT cbToCopy      = min(cbDataMax, *pcbDataActual);
             const INT cbToRetrieve  = cbToCopy + ibOffset;
+            CArena::CScope arenascope( pfucb->ppib->Parena() );
             BYTE * pbT = NULL;
-            Alloc( pbT = new BYTE[cbToRetrieve] );
-            err = ErrPKDecompressData(
+            Alloc( pbT = (BYTE *)arenascope.PvAlloc( cbToRetrieve ) );
+            Call( ErrPKDecompressData(
                     dataCompressed,
                     pfucb,
                     pbT,
                     cbToRetrieve,
-                    &cbDataActualT );
+                    &cbDataActualT ) );
             UtilMemCpy( pbData, pbT+ibOffset, cbToCopy );
-            delete[] pbT;
-            Call( err );
 
             if( *pcbDataActual > cbDataMax )
             {
@@ -1503,6 +1502,8 @@ ERR VTAPI ErrIsamRetrieveColumn(
     CheckFUCB( ppib, pfucb );
     AssertDIRNoLatch( ppib );
 
+    CArena::CScope  arenascope( ppib->Parena() );
+
     Assert( pfucb->u.pfcb->Ptdb() == pfucb->u.pscb->fcb.Ptdb() );
     Assert( pfucb->u.pfcb->Ptdb() != ptdbNil );
 
@@ -1735,11 +1736,7 @@ ERR VTAPI ErrIsamRetrieveColumn(
          dataRetrieved.Cb() > 0 )
     {
 
-        pbDataDecrypted = new BYTE[ dataRetrieved.Cb() ];
-        if ( pbDataDecrypted == NULL )
-        {
-            Error( ErrERRCheck( JET_errOutOfMemory ) );
-        }
+        Alloc( pbDataDecrypted = (BYTE *)arenascope.PvAlloc( dataRetrieved.Cb() ) );
         ULONG cbDataDecryptedActual = dataRetrieved.Cb();
         ERR errT = ErrOSUDecrypt(
                 (BYTE*)dataRetrieved.Pv(),
@@ -1989,11 +1986,6 @@ ERR VTAPI ErrIsamRetrieveColumn(
     }
 
 HandleError:
-    if ( pbDataDecrypted )
-    {
-        delete[] pbDataDecrypted;
-        pbDataDecrypted = NULL;
-    }
     if ( pbRef )
     {
         delete[] pbRef;
@@ -773,13 +773,12 @@ LOCAL ERR ErrRECIIRetrieveKey(
     const BOOL          fRetrieveBasedOnRCE         = ( prceNil != prce );
     const size_t        cbLVStack                   = 256;
     BYTE                rgbLVStack[ cbLVStack ];
-    BYTE                *pbAllocated                    = NULL;
     BYTE                *pbLV                       = NULL;
     const size_t        cbSegStack                  = 256;
     BYTE                rgbSegStack[ cbSegStack ];
-    BYTE                *pbSegRes                   = NULL;
     BYTE                *pbSeg                      = NULL;
     const BOOL          fDisallowTruncation         = pidb->FDisallowTruncation();
+    CArena::CScope      arenascope( pfucb->ppib->Parena() );
 
     Assert( pkey != NULL );
     Assert( !pkey->FNull() );
@@ -814,8 +813,7 @@ LOCAL ERR ErrRECIIRetrieveKey(
 
     if ( cbDataMost > cbLVStack )
     {
-        Alloc( pbAllocated = new BYTE[cbDataMost] );
-        pbLV = pbAllocated;
+        Alloc( pbLV = (BYTE *)arenascope.PvAlloc( cbDataMost ) );
     }
     else
     {
@@ -823,8 +821,7 @@ LOCAL ERR ErrRECIIRetrieveKey(
     }
     if ( cbKeyMost > cbSegStack )
     {
-        Alloc( pbSegRes = (BYTE *)RESKEY.PvRESAlloc() );
-        pbSeg = pbSegRes;
+        Alloc( pbSeg = (BYTE *)arenascope.PvAlloc( cbKeyMost ) );
     }
     else
     {
@@ -1578,9 +1575,6 @@ HandleError:
         CallS( ErrDIRCommitTransaction( pfucb->ppib, NO_GRBIT ) );
     }
 
-    RESKEY.Free( pbSegRes );
-    delete [] pbAllocated;
-
     return err;
 }
 
@@ -2055,7 +2049,6 @@ ERR VTAPI ErrIsamMakeKey(
     INT             iidxsegCur;
     const size_t    cbSegStack      = 256;
     BYTE            rgbSegStack[ cbSegStack ];
-    BYTE            *pbSegRes       = NULL;
     DATA            lineNormSeg;
     BYTE            rgbFixedColumnKeyPadded[ JET_cbColumnMost ];
     BOOL            fFixedField;
@@ -2073,6 +2066,8 @@ ERR VTAPI ErrIsamMakeKey(
     CheckFUCB( ppib, pfucbTable );
     AssertDIRNoLatch( ppib );
 
+    CArena::CScope  arenascope( ppib->Parena() );
+
     if ( pfucbNil != pfucbTable->pfucbCurIndex )
     {
         pfucb = pfucbTable->pfucbCurIndex;
@@ -2180,8 +2175,9 @@ ERR VTAPI ErrIsamMakeKey(
     }
     if ( cbKeyMost > cbSegStack )
     {
-        Alloc( pbSegRes = (BYTE *)RESKEY.PvRESAlloc() );
-        lineNormSeg.SetPv( pbSegRes );
+        BYTE * pbSeg = NULL;
+        Alloc( pbSeg = (BYTE *)arenascope.PvAlloc( cbKeyMost ) );
+        lineNormSeg.SetPv( pbSeg );
     }
     else
     {
@@ -2438,7 +2434,6 @@ ERR VTAPI ErrIsamMakeKey(
     CallS( err );
 
 HandleError:
-    RESKEY.Free( pbSegRes );
     return err;
 }
 
@@ -271,6 +271,187 @@ JETUNITTEST( DbfilehdrLock, ExplicitRW )
 
 
 
+CChangedPageMap::CChangedPageMap() :
+    m_rwl( CLockBasicInfo( CSyncBasicInfo( szChangedPageMap ), rankChangedPageMap, 0 ) ),
+    m_rgulActive( NULL ),
+    m_pgnoMaxActive( pgnoNull ),
+    m_fActiveValid( fFalse ),
+    m_rgulEpoch( NULL ),
+    m_pgnoMaxEpoch( pgnoNull ),
+    m_fEpochValid( fFalse ),
+    m_fInEpoch( fFalse )
+{
+}
+
+CChangedPageMap::~CChangedPageMap()
+{
+    Term();
+}
+
+ERR CChangedPageMap::ErrBeginEpoch( const PGNO pgnoLast )
+{
+    Assert( !m_fInEpoch );
+
+    const PGNO  pgnoMax = max( pgnoLast, (PGNO)s_cpgChunk );
+    const size_t cul    = CulForPgnoMax_( pgnoMax );
+    ULONG * const rgul  = (ULONG *)PvOSMemoryPageAlloc( cul * sizeof( ULONG ), NULL );
+
+    if ( NULL == rgul )
+    {
+        return ErrERRCheck( JET_errOutOfMemory );
+    }
+
+    m_rwl.EnterAsWriter();
+
+    Assert( NULL == m_rgulEpoch );
+    m_rgulEpoch         = m_rgulActive;
+    m_pgnoMaxEpoch      = m_pgnoMaxActive;
+    m_fEpochValid       = ( NULL != m_rgulActive ) && m_fActiveValid;
+
+    m_rgulActive        = rgul;
+    m_pgnoMaxActive     = pgnoMax;
+    m_fActiveValid      = fTrue;
+    m_fInEpoch          = fTrue;
+
+    m_rwl.LeaveAsWriter();
+
+    return JET_errSuccess;
+}
+
+VOID CChangedPageMap::EndEpoch( const BOOL fSucceeded )
+{
+    if ( !m_fInEpoch )
+    {
+        return;
+    }
+
+    m_rwl.EnterAsWriter();
+
+    if ( !fSucceeded && NULL != m_rgulActive )
+    {
+        if ( !m_fEpochValid )
+        {
+            m_fActiveValid = fFalse;
+        }
+        else
+        {
+            const size_t cchunkEpoch    = m_pgnoMaxEpoch / s_cpgChunk + 1;
+            const size_t cchunkActive   = m_pgnoMaxActive / s_cpgChunk + 1;
+
+            for ( size_t ichunk = 0; ichunk < cchunkActive; ichunk++ )
+            {
+                if ( ichunk >= cchunkEpoch || FChunkSet_( m_rgulEpoch, ichunk ) )
+                {
+                    m_rgulActive[ ichunk / 32 ] |= ( 1 << ( ichunk % 32 ) );
+                }
+            }
+        }
+    }
+
+    if ( m_rgulEpoch )
+    {
+        OSMemoryPageFree( m_rgulEpoch );
+        m_rgulEpoch = NULL;
+    }
+    m_pgnoMaxEpoch  = pgnoNull;
+    m_fEpochValid   = fFalse;
+    m_fInEpoch      = fFalse;
+
+    m_rwl.LeaveAsWriter();
+}
+
+VOID CChangedPageMap::Term()
+{
+    m_rwl.EnterAsWriter();
+
+    if ( m_rgulEpoch )
+    {
+        OSMemoryPageFree( m_rgulEpoch );
+        m_rgulEpoch = NULL;
+    }
+    if ( m_rgulActive )
+    {
+        OSMemoryPageFree( m_rgulActive );
+        m_rgulActive = NULL;
+    }
+    m_pgnoMaxActive = pgnoNull;
+    m_pgnoMaxEpoch  = pgnoNull;
+    m_fActiveValid  = fFalse;
+    m_fEpochValid   = fFalse;
+    m_fInEpoch      = fFalse;
+
+    m_rwl.LeaveAsWriter();
+}
+
+VOID CChangedPageMap::SetRangeChanged( const PGNO pgnoFirst, const CPG cpg )
+{
+    Assert( cpg > 0 );
+
+    if ( NULL == m_rgulActive )
+    {
+        return;
+    }
+
+    m_rwl.EnterAsReader();
+
+    if ( NULL != m_rgulActive && pgnoFirst <= m_pgnoMaxActive )
+    {
+        const PGNO pgnoLast = min( pgnoFirst + cpg - 1, m_pgnoMaxActive );
+        for ( size_t ichunk = pgnoFirst / s_cpgChunk; ichunk <= pgnoLast / s_cpgChunk; ichunk++ )
+        {
+            const ULONG ulBit = 1 << ( ichunk % 32 );
+            if ( !( m_rgulActive[ ichunk / 32 ] & ulBit ) )
+            {
+                AtomicExchangeSet( &m_rgulActive[ ichunk / 32 ], ulBit );
+            }
+        }
+    }
+
+    m_rwl.LeaveAsReader();
+}
+
+//  pages dropped by a shrink or added by a growth hold different contents when they are next backed up,
+//  even if they come back inside the tracked range and are never written again
+
+VOID CChangedPageMap::SetResized( const PGNO pgnoLastOld, const PGNO pgnoLastNew )
+{
+    if ( pgnoLastOld == pgnoLastNew )
+    {
+        return;
+    }
+
+    const PGNO pgnoFirst = min( pgnoLastOld, pgnoLastNew ) + 1;
+    const PGNO pgnoLast  = max( pgnoLastOld, pgnoLastNew );
+    SetRangeChanged( pgnoFirst, pgnoLast - pgnoFirst + 1 );
+}
+
+BOOL CChangedPageMap::FEpochRangeChanged( const PGNO pgnoFirst, const CPG cpg ) const
+{
+    Assert( cpg > 0 );
+
+    if ( !m_fInEpoch || !m_fEpochValid )
+    {
+        return fTrue;
+    }
+
+    const PGNO pgnoLast = pgnoFirst + cpg - 1;
+    if ( pgnoLast > m_pgnoMaxEpoch )
+    {
+        return fTrue;
+    }
+
+    for ( size_t ichunk = pgnoFirst / s_cpgChunk; ichunk <= pgnoLast / s_cpgChunk; ichunk++ )
+    {
+        if ( FChunkSet_( m_rgulEpoch, ichunk ) )
+        {
+            return fTrue;
+        }
+    }
+
+    return fFalse;
+}
+
+
 FMP::FMP()
     :   CZeroInit( sizeof( FMP ) ),
         m_critLatch( CLockBasicInfo( CSyncBasicInfo( szFMP ), rankFMP, 0 ) ),
@@ -1292,6 +1473,7 @@ ERR FMP::ErrInitializeOneFmp(
     pfmp->ResetTrimSupported();
     pfmp->ResetContainsDataFromFutureLogs();
     pfmp->ResetOlderDemandExtendDb();
+    pfmp->ResetDbExtensionLead();
     OnDebug( pfmp->m_dbhus = dbhusNoUpdate );
     pfmp->ResetEventThrottles();
     pfmp->ResetPctCachePriorityFmp();
@@ -1340,6 +1522,8 @@ VOID FMP::ReleaseWriteLatchAndFree( PIB *ppib )
     m_isdlAttach.TermSequence();
     m_isdlDetach.TermSequence();
 
+    m_cpm.Term();
+
     Assert( m_msRangeLock.FEmpty() );
 
     SetPinst( NULL );
@@ -476,3 +476,71 @@ JETUNITTEST( FMP, NewAndWriteLatch )
     return;
 }
 
+
+JETUNITTEST( FMP, ChangedPageMapEpochs )
+{
+    CChangedPageMap cpm;
+
+    CHECK( !cpm.FTracking() );
+    cpm.SetRangeChanged( 1, 1 );
+    CHECK( cpm.FEpochRangeChanged( 1, 1 ) );
+
+    CHECK( JET_errSuccess == cpm.ErrBeginEpoch( 1000 ) );
+    CHECK( cpm.FTracking() );
+    CHECK( cpm.FEpochRangeChanged( 300, 1 ) );
+    cpm.SetRangeChanged( 100, 1 );
+    cpm.EndEpoch( fTrue );
+
+    CHECK( JET_errSuccess == cpm.ErrBeginEpoch( 1000 ) );
+    CHECK( cpm.FEpochRangeChanged( 100, 1 ) );
+    CHECK( cpm.FEpochRangeChanged( 96, CChangedPageMap::s_cpgChunk ) );
+    CHECK( !cpm.FEpochRangeChanged( 200, 50 ) );
+    CHECK( cpm.FEpochRangeChanged( 990, 20 ) );
+    cpm.SetRangeChanged( 500, 1 );
+    cpm.EndEpoch( fFalse );
+
+    CHECK( JET_errSuccess == cpm.ErrBeginEpoch( 1000 ) );
+    CHECK( cpm.FEpochRangeChanged( 100, 1 ) );
+    CHECK( cpm.FEpochRangeChanged( 500, 1 ) );
+    CHECK( !cpm.FEpochRangeChanged( 300, 1 ) );
+    cpm.EndEpoch( fTrue );
+
+    cpm.Term();
+    CHECK( !cpm.FTracking() );
+    CHECK( !cpm.FInEpoch() );
+}
+
+JETUNITTEST( FMP, ChangedPageMapShrinkAndRegrow )
+{
+    CChangedPageMap cpm;
+
+    CHECK( JET_errSuccess == cpm.ErrBeginEpoch( 1000 ) );
+    cpm.EndEpoch( fTrue );
+
+
+    cpm.SetResized( 1000, 500 );
+    cpm.SetResized( 500, 1000 );
+    cpm.SetRangeChanged( 700, 1 );
+    cpm.SetResized( 1000, 1000 );
+
+    CHECK( JET_errSuccess == cpm.ErrBeginEpoch( 1000 ) );
+    CHECK( cpm.FEpochRangeChanged( 501, 1 ) );
+    CHECK( cpm.FEpochRangeChanged( 600, 1 ) );
+    CHECK( cpm.FEpochRangeChanged( 700, 1 ) );
+    CHECK( cpm.FEpochRangeChanged( 1000, 1 ) );
+    CHECK( !cpm.FEpochRangeChanged( 100, 300 ) );
+    cpm.EndEpoch( fTrue );
+
+
+    CHECK( JET_errSuccess == cpm.ErrBeginEpoch( 1000 ) );
+    CHECK( !cpm.FEpochRangeChanged( 501, 1 ) );
+    cpm.SetResized( 1000, 800 );
+    cpm.EndEpoch( fTrue );
+
+    CHECK( JET_errSuccess == cpm.ErrBeginEpoch( 800 ) );
+    CHECK( cpm.FEpochRangeChanged( 801, 1 ) );
+    CHECK( !cpm.FEpochRangeChanged( 501, 1 ) );
+    cpm.EndEpoch( fTrue );
+
+    cpm.Term();
+}
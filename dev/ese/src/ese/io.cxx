@@ -5965,16 +5965,27 @@ VOID FMP::FreeHeaderSignature()
 }
 
 
-struct READPAGE_DATA
-{
-    volatile ERR            err;
-    volatile LONG*          pacRead;
-    CAutoResetSignal*       pasigDone;
-    BOOL                    fCheckPagesOffset;
-    BOOL                    fExtensiveChecks;
-    IFMP                    ifmp;
-    LONG                    pgnoMost;
-};
+//  a caller that range locks the pages it reads (see fRangeLocked) has the lock dropped as soon as
+//  the reads are done rather than when it next waits, so BF writes to the range are not held up
+
+LOCAL VOID IOIReadDbPagesRangeUnlock( READPAGE_DATA * const preaddata )
+{
+    if ( preaddata->fRangeLocked )
+    {
+        g_rgfmp[ preaddata->ifmp ].RangeUnlock( preaddata->pgnoRangeLockFirst, preaddata->pgnoRangeLockLast );
+        preaddata->fRangeLocked = fFalse;
+    }
+}
+
+LOCAL DWORD IOIReadDbPagesRangeUnlockTask( VOID * const pvReadPageData )
+{
+    READPAGE_DATA * const preaddata = (READPAGE_DATA *)pvReadPageData;
+
+    IOIReadDbPagesRangeUnlock( preaddata );
+    preaddata->asigDone.Set();
+
+    return 0;
+}
 
 void IOReadDbPagesCompleted(
     const ERR err,
@@ -6051,10 +6062,19 @@ void IOReadDbPagesCompleted(
     }
 
     
-    if ( !AtomicDecrement( (LONG*)preaddata->pacRead ) )
+    if ( !AtomicDecrement( (LONG*)&preaddata->cRead ) )
     {
         
-        preaddata->pasigDone->Set();
+        preaddata->tickCompleted = TickOSTimeCurrent();
+
+        //  releasing the range lock may wait on BF writes, which is not allowed on the I/O thread,
+        //  so hand it to the task manager; if that fails the waiter releases it instead
+
+        if ( !preaddata->fRangeLocked ||
+            PinstFromIfmp( preaddata->ifmp )->Taskmgr().ErrTMPost( IOIReadDbPagesRangeUnlockTask, preaddata ) < JET_errSuccess )
+        {
+            preaddata->asigDone.Set();
+        }
     }
 }
 
@@ -6070,23 +6090,40 @@ ERR ErrIOReadDbPages(
     LONG pgnoMost,
     const TraceContext& tc,
     BOOL fExtensiveChecks )
+{
+    READPAGE_DATA readdata;
+
+    IOReadDbPagesIssue( ifmp, pfapi, pbData, pgnoStart, pgnoEnd, fCheckPagesOffset, pgnoMost, tc, fExtensiveChecks, QosAsyncReadDefault( PinstFromIfmp( ifmp ) ), &readdata );
+
+    return ErrIOReadDbPagesWait( &readdata );
+}
+
+VOID IOReadDbPagesIssue(
+    IFMP ifmp,
+    IFileAPI *pfapi,
+    BYTE *pbData,
+    LONG pgnoStart,
+    LONG pgnoEnd,
+    BOOL fCheckPagesOffset,
+    LONG pgnoMost,
+    const TraceContext& tc,
+    BOOL fExtensiveChecks,
+    const OSFILEQOS qos,
+    READPAGE_DATA * const preaddata )
 {
     ERR     err     = JET_errSuccess;
     
 
     PGNO pgnoMaxDb = pgnoEnd + 1;
 
-    volatile LONG acRead = 0;
-    CAutoResetSignal asigDone( CSyncBasicInfo( _T( "ErrIOReadDbPages::asigDone" ) ) );
-
-    READPAGE_DATA readdata;
-    readdata.err = JET_errSuccess;
-    readdata.pacRead = &acRead;
-    readdata.pasigDone = &asigDone;
-    readdata.fCheckPagesOffset = fCheckPagesOffset;
-    readdata.fExtensiveChecks = fExtensiveChecks;
-    readdata.ifmp = ifmp;
-    readdata.pgnoMost = pgnoMost;
+    preaddata->err = JET_errSuccess;
+    preaddata->cRead = 0;
+    preaddata->tickCompleted = 0;
+    preaddata->fWait = fFalse;
+    preaddata->fCheckPagesOffset = fCheckPagesOffset;
+    preaddata->fExtensiveChecks = fExtensiveChecks;
+    preaddata->ifmp = ifmp;
+    preaddata->pgnoMost = pgnoMost;
 
     DWORD cReadIssue;
     cReadIssue = 0;
@@ -6096,7 +6133,7 @@ ERR ErrIOReadDbPages(
     
     for ( pgno1 = pgnoStart,
           pgno2 = min( PGNO( ( ( pgnoStart + cpgDBReserved - 1 ) / cpgBackupChunkSize + 1 ) * cpgBackupChunkSize - cpgDBReserved + 1 ), pgnoMaxDb );
-          pgno1 < pgnoMaxDb && ( readdata.err >= 0 );
+          pgno1 < pgnoMaxDb && ( preaddata->err >= 0 );
           pgno1 = pgno2,
           pgno2 = (PGNO)min( pgno1 + cpgBackupChunkSize, pgnoMaxDb ) )
     {
@@ -6112,12 +6149,12 @@ ERR ErrIOReadDbPages(
                                 ibOffset,
                                 cbData,
                                 pbData,
-                                QosAsyncReadDefault( PinstFromIfmp( ifmp ) ),
+                                qos,
                                 IFileAPI::PfnIOComplete( IOReadDbPagesCompleted ),
-                                DWORD_PTR( &readdata ) );
-        if ( err < 0 && readdata.err >= 0 )
+                                DWORD_PTR( preaddata ) );
+        if ( err < 0 && preaddata->err >= 0 )
         {
-            readdata.err = err;
+            preaddata->err = err;
         }
         pbData += cbData;
 
@@ -6125,20 +6162,34 @@ ERR ErrIOReadDbPages(
     }
 
     
-    if ( AtomicExchangeAdd( (LONG*)&acRead, cReadIssue ) + cReadIssue != 0 )
+    if ( AtomicExchangeAdd( (LONG*)&preaddata->cRead, cReadIssue ) + cReadIssue != 0 )
     {
         CallS( pfapi->ErrIOIssue() );
-        asigDone.Wait();
+        preaddata->fWait = fTrue;
+    }
+    else
+    {
+        preaddata->tickCompleted = TickOSTimeCurrent();
+        IOIReadDbPagesRangeUnlock( preaddata );
     }
 
     if ( tc.iorReason.Iorp() == iorpBackup )
     {
         PERFOpt( cBKReadPages.Add( PinstFromIfmp( ifmp ), cReadIssue ) );
     }
+}
 
-    
-    err = ( err < 0 ? err : readdata.err );
-    return err;
+ERR ErrIOReadDbPagesWait( READPAGE_DATA * const preaddata )
+{
+    if ( preaddata->fWait )
+    {
+        preaddata->asigDone.Wait();
+        preaddata->fWait = fFalse;
+    }
+
+    IOIReadDbPagesRangeUnlock( preaddata );
+
+    return preaddata->err;
 }
 
 BOOL FDBTestCheckShrunkPages( BYTE* pv, const CPG cpg )
@@ -2218,6 +2218,8 @@ INST::~INST()
     }
     OSMemoryPageFree( m_rgpls );
 
+    m_apilatency.Term();
+
     m_rwlpoolPIBTrx.Term();
 
     Assert( m_rgparam != g_rgparam );
@@ -3256,6 +3258,7 @@ ERR ErrNewInst(
     {
         new(&pinst->m_rgpls[iProc]) INST::PLS;
     }
+    Call( pinst->m_apilatency.ErrInit( pinst->m_cpls, pinst->m_iInstance ) );
 
     AtomicExchangePointer( (void **)&g_rgpinst[ ipinst ], pinst );
     g_cpinstInit++;
@@ -3469,6 +3472,418 @@ WCHAR   profile_wszFileName[ IFileSystemAPI::cchPathMax ]    = L"";
 #endif
 
 
+#ifdef PERFMON_SUPPORT
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPISeekLatencyP50;
+LONG LAPISeekLatencyP50CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPISeekLatencyP50.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPISeekLatencyP99;
+LONG LAPISeekLatencyP99CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPISeekLatencyP99.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPISeekLatencyP999;
+LONG LAPISeekLatencyP999CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPISeekLatencyP999.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPIRetrieveColumnLatencyP50;
+LONG LAPIRetrieveColumnLatencyP50CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPIRetrieveColumnLatencyP50.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPIRetrieveColumnLatencyP99;
+LONG LAPIRetrieveColumnLatencyP99CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPIRetrieveColumnLatencyP99.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPIRetrieveColumnLatencyP999;
+LONG LAPIRetrieveColumnLatencyP999CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPIRetrieveColumnLatencyP999.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPIUpdateLatencyP50;
+LONG LAPIUpdateLatencyP50CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPIUpdateLatencyP50.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPIUpdateLatencyP99;
+LONG LAPIUpdateLatencyP99CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPIUpdateLatencyP99.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPIUpdateLatencyP999;
+LONG LAPIUpdateLatencyP999CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPIUpdateLatencyP999.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPICommitTransactionLatencyP50;
+LONG LAPICommitTransactionLatencyP50CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPICommitTransactionLatencyP50.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPICommitTransactionLatencyP99;
+LONG LAPICommitTransactionLatencyP99CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPICommitTransactionLatencyP99.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> cAPICommitTransactionLatencyP999;
+LONG LAPICommitTransactionLatencyP999CEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cAPICommitTransactionLatencyP999.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+#endif
+
+QWORD CApiLatencyHistograms::CusecMaxFromIBucket( const ULONG iBucket )
+{
+    Assert( iBucket < cBucket );
+
+    if ( iBucket < cBucketLinear )
+    {
+        return iBucket;
+    }
+    if ( iBucket == cBucket - 1 )
+    {
+        return qwMax;
+    }
+
+    const ULONG iOctave = iOctaveMin + ( iBucket - cBucketLinear ) / cBucketPerOctave;
+    const ULONG iSub    = ( iBucket - cBucketLinear ) % cBucketPerOctave;
+    return ( ( QWORD( 2 + iSub ) << ( iOctave - 1 ) ) + ( QWORD( 1 ) << ( iOctave - 1 ) ) ) - 1;
+}
+
+ERR CApiLatencyHistograms::ErrInit( const size_t cproc, const INT iInstance )
+{
+    ERR err = JET_errSuccess;
+
+    Assert( NULL == m_rgb );
+    Assert( cproc > 0 );
+
+    m_cproc     = cproc;
+    m_cbPerProc = roundup( opMax * cBucket * sizeof( DWORD ), 64 );
+    m_iInstance = iInstance;
+
+    AllocR( m_rgb = (BYTE *)PvOSMemoryPageAlloc( m_cproc * m_cbPerProc, NULL ) );
+
+    const TICK tickNow = TickOSTimeCurrent();
+    for ( INT op = 0; op < opMax; op++ )
+    {
+        m_rgtickPerfRefresh[ op ] = tickNow;
+    }
+
+    return JET_errSuccess;
+}
+
+VOID CApiLatencyHistograms::Term()
+{
+    if ( m_rgb )
+    {
+        OSMemoryPageFree( m_rgb );
+        m_rgb = NULL;
+    }
+}
+
+QWORD CApiLatencyHistograms::CSamples( const INT op, QWORD * const rgcBucket ) const
+{
+    Assert( op >= 0 && op < opMax );
+
+    QWORD cSamples = 0;
+    memset( rgcBucket, 0, cBucket * sizeof( QWORD ) );
+
+    if ( NULL == m_rgb )
+    {
+        return 0;
+    }
+
+    for ( size_t iProc = 0; iProc < m_cproc; iProc++ )
+    {
+        const DWORD * const rgc = RgcBucket_( iProc, op );
+        for ( ULONG iBucket = 0; iBucket < cBucket; iBucket++ )
+        {
+            rgcBucket[ iBucket ] += rgc[ iBucket ];
+            cSamples += rgc[ iBucket ];
+        }
+    }
+
+    return cSamples;
+}
+
+QWORD CApiLatencyHistograms::CusecPercentile( const QWORD * const rgcBucket, const QWORD cSamples, const ULONG ulPermille )
+{
+    Assert( ulPermille <= 1000 );
+
+    if ( 0 == cSamples )
+    {
+        return 0;
+    }
+
+    const QWORD cSamplesTarget = max( (QWORD)1, ( cSamples * ulPermille + 999 ) / 1000 );
+    QWORD cSamplesSeen = 0;
+    for ( ULONG iBucket = 0; iBucket < cBucket; iBucket++ )
+    {
+        cSamplesSeen += rgcBucket[ iBucket ];
+        if ( cSamplesSeen >= cSamplesTarget )
+        {
+            return CusecMaxFromIBucket( iBucket );
+        }
+    }
+
+    return CusecMaxFromIBucket( cBucket - 1 );
+}
+
+VOID CApiLatencyHistograms::RefreshPerfCounters_( const INT op )
+{
+    const TICK tickLast = m_rgtickPerfRefresh[ op ];
+    const TICK tickNow  = TickOSTimeCurrent();
+    if ( (TICK)AtomicCompareExchange( (LONG *)&m_rgtickPerfRefresh[ op ], (LONG)tickLast, (LONG)tickNow ) != tickLast )
+    {
+        return;
+    }
+
+#ifdef PERFMON_SUPPORT
+    PERFInstanceDelayedTotal<LONG, INST, fFalse, fFalse> * rgpperf[ 3 ];
+    switch ( op )
+    {
+        case opSeek:
+            rgpperf[ 0 ] = &cAPISeekLatencyP50;
+            rgpperf[ 1 ] = &cAPISeekLatencyP99;
+            rgpperf[ 2 ] = &cAPISeekLatencyP999;
+            break;
+        case opRetrieveColumn:
+            rgpperf[ 0 ] = &cAPIRetrieveColumnLatencyP50;
+            rgpperf[ 1 ] = &cAPIRetrieveColumnLatencyP99;
+            rgpperf[ 2 ] = &cAPIRetrieveColumnLatencyP999;
+            break;
+        case opUpdate:
+            rgpperf[ 0 ] = &cAPIUpdateLatencyP50;
+            rgpperf[ 1 ] = &cAPIUpdateLatencyP99;
+            rgpperf[ 2 ] = &cAPIUpdateLatencyP999;
+            break;
+        case opCommitTransaction:
+            rgpperf[ 0 ] = &cAPICommitTransactionLatencyP50;
+            rgpperf[ 1 ] = &cAPICommitTransactionLatencyP99;
+            rgpperf[ 2 ] = &cAPICommitTransactionLatencyP999;
+            break;
+        default:
+            return;
+    }
+
+    if ( g_fDisablePerfmon )
+    {
+        return;
+    }
+
+    QWORD rgcBucket[ cBucket ];
+    const QWORD cSamples = CSamples( op, rgcBucket );
+    const ULONG rgulPermille[ 3 ] = { 500, 990, 999 };
+    for ( INT iperf = 0; iperf < _countof( rgpperf ); iperf++ )
+    {
+        const QWORD cusec = CusecPercentile( rgcBucket, cSamples, rgulPermille[ iperf ] );
+        PERFOpt( rgpperf[ iperf ]->Set( m_iInstance, (LONG)min( cusec, (QWORD)lMax ) ) );
+    }
+#endif
+}
+
+//  published names for the op* values, which are internal and not stable across releases
+LOCAL const CHAR * const g_rgszJetApiOp[] =
+{
+    "",
+    "JetIdle",
+    "JetGetTableIndexInfo",
+    "JetGetIndexInfo",
+    "JetGetObjectInfo",
+    "JetGetTableInfo",
+    "JetCreateObject",
+    "JetDeleteObject",
+    "JetRenameObject",
+    "JetBeginTransaction",
+    "JetCommitTransaction",
+    "JetRollback",
+    "JetOpenTable",
+    "JetDupCursor",
+    "JetCloseTable",
+    "JetGetTableColumnInfo",
+    "JetGetColumnInfo",
+    "JetRetrieveColumn",
+    "JetRetrieveColumns",
+    "JetSetColumn",
+    "JetSetColumns",
+    "JetPrepareUpdate",
+    "JetUpdate",
+    "JetDelete",
+    "JetGetCursorInfo",
+    "JetGetCurrentIndex",
+    "JetSetCurrentIndex",
+    "JetMove",
+    "JetMakeKey",
+    "JetSeek",
+    "JetGetBookmark",
+    "JetGotoBookmark",
+    "JetGetRecordPosition",
+    "JetGotoPosition",
+    "JetRetrieveKey",
+    "JetCreateDatabase",
+    "JetOpenDatabase",
+    "JetGetDatabaseInfo",
+    "JetCloseDatabase",
+    "JetCapability",
+    "JetCreateTable",
+    "JetRenameTable",
+    "JetDeleteTable",
+    "JetAddColumn",
+    "JetRenameColumn",
+    "JetDeleteColumn",
+    "JetCreateIndex",
+    "JetRenameIndex",
+    "JetDeleteIndex",
+    "JetComputeStats",
+    "JetAttachDatabase",
+    "JetDetachDatabase",
+    "JetOpenTempTable",
+    "JetSetIndexRange",
+    "JetIndexRecordCount",
+    "JetGetChecksum",
+    "JetGetObjidFromName",
+    "JetEscrowUpdate",
+    "JetGetLock",
+    "JetRetrieveTaggedColumnList",
+    "JetCreateTableColumnIndex",
+    "JetSetColumnDefaultValue",
+    "JetPrepareToCommitTransaction",
+    "JetSetTableSequential",
+    "JetResetTableSequential",
+    "JetRegisterCallback",
+    "JetUnregisterCallback",
+    "JetSetLS",
+    "JetGetLS",
+    "JetGetVersion",
+    "JetBeginSession",
+    "JetDupSession",
+    "JetEndSession",
+    "JetBackupInstance",
+    "JetBeginExternalBackupInstance",
+    "JetGetAttachInfoInstance",
+    "JetOpenFileInstance",
+    "JetReadFileInstance",
+    "JetCloseFileInstance",
+    "JetGetLogInfoInstance",
+    "JetGetTruncateLogInfoInstance",
+    "JetTruncateLogInstance",
+    "JetEndExternalBackupInstance",
+    "JetSnapshotStart",
+    "JetSnapshotStop",
+    "JetResetCounter",
+    "JetGetCounter",
+    "JetCompact",
+    "JetConvertDDL",
+    "JetUpgradeDatabase",
+    "JetDefragment",
+    "JetSetDatabaseSize",
+    "JetGrowDatabase",
+    "JetSetSessionContext",
+    "JetResetSessionContext",
+    "JetSetSystemParameter",
+    "JetGetSystemParameter",
+    "JetTerm",
+    "JetInit",
+    "JetIntersectIndexes",
+    "JetDBUtilities",
+    "JetGetResourceParam",
+    "JetSetResourceParam",
+    "JetEnumerateColumns",
+    "JetOSSnapPrepareInstance",
+    "JetOSSnapTruncateLogInstance",
+    "JetGetRecordSize",
+    "JetGetSessionInfo",
+    "JetGetInstanceMiscInfo",
+    "JetGetDatabasePages",
+    "JetBeginSurrogateBackup",
+    "JetEndSurrogateBackup",
+    "JetRemoveLogfile",
+    "JetDatabaseScan",
+    "JetBeginDatabaseIncrementalReseed",
+    "JetEndDatabaseIncrementalReseed",
+    "JetPatchDatabasePages",
+    "JetPrereadKeys",
+    "JetTestHook",
+    "JetConsumeLogData",
+    "JetOnlinePatchDatabasePage",
+    "JetGetErrorInfo",
+    "JetResizeDatabase",
+    "JetSetSessionParameter",
+    "JetGetSessionParameter",
+    "JetPrereadTable",
+    "JetCommitTransaction2",
+    "JetPrereadIndexRanges",
+    "JetSetCursorFilter",
+    "JetTracing",
+    "JetGetDatabaseFileInfo",
+    "JetGetLogFileInfo",
+    "JetGetPageInfo",
+    "JetGetThreadStats",
+    "JetGetDatabaseSize",
+    "JetEnableMultiInstance",
+    "JetCreateInstance",
+    "JetRestoreInstance",
+    "JetStopServiceInstance",
+    "JetStopBackupInstance",
+    "JetFreeBuffer",
+    "JetGetInstanceInfo",
+    "JetOSSnapshotPrepare",
+    "JetOSSnapshotFreeze",
+    "JetOSSnapshotThaw",
+    "JetOSSnapshotAbort",
+    "JetOSSnapshotTruncateLog",
+    "JetOSSnapshotGetFreezeInfo",
+    "JetOSSnapshotEnd",
+    "JetPrereadTables",
+    "JetPrereadIndexRange",
+    "JetCreateEncryptionKey",
+    "JetSetTableInfo",
+    "JetRetrieveColumnByReference",
+    "JetPrereadColumnsByReference",
+    "JetStreamRecords",
+    "JetRetrieveColumnFromRecordStream",
+    "JetFileSectionInstance",
+    "JetRBSPrepareRevert",
+    "JetRBSExecuteRevert",
+    "JetRBSCancelRevert",
+};
+
+C_ASSERT( _countof( g_rgszJetApiOp ) == opMax );
+
+LOCAL VOID JetApiOpName( const INT op, CHAR * const szOp, const size_t cbOp )
+{
+    Assert( op >= 0 && op < opMax );
+    OSStrCbCopyA( szOp, cbOp, g_rgszJetApiOp[ op ] );
+}
+
 
 class APICALL
 {
@@ -3675,17 +4090,80 @@ class APICALL_INST : public APICALL
         }
 };
 
+LOCAL VOID OpStatsIDeltaThreadStats(
+    JET_THREADSTATS4 * const        ptsDelta,
+    const JET_THREADSTATS4&         tsEnd,
+    const JET_THREADSTATS4&         tsBegin )
+{
+    ptsDelta->cbStruct                          = sizeof( JET_THREADSTATS4 );
+    ptsDelta->cPageReferenced                   = tsEnd.cPageReferenced - tsBegin.cPageReferenced;
+    ptsDelta->cPageRead                         = tsEnd.cPageRead - tsBegin.cPageRead;
+    ptsDelta->cPagePreread                      = tsEnd.cPagePreread - tsBegin.cPagePreread;
+    ptsDelta->cPageDirtied                      = tsEnd.cPageDirtied - tsBegin.cPageDirtied;
+    ptsDelta->cPageRedirtied                    = tsEnd.cPageRedirtied - tsBegin.cPageRedirtied;
+    ptsDelta->cLogRecord                        = tsEnd.cLogRecord - tsBegin.cLogRecord;
+    ptsDelta->cbLogRecord                       = tsEnd.cbLogRecord - tsBegin.cbLogRecord;
+    ptsDelta->cusecPageCacheMiss                = tsEnd.cusecPageCacheMiss - tsBegin.cusecPageCacheMiss;
+    ptsDelta->cPageCacheMiss                    = tsEnd.cPageCacheMiss - tsBegin.cPageCacheMiss;
+    ptsDelta->cSeparatedLongValueRead           = tsEnd.cSeparatedLongValueRead - tsBegin.cSeparatedLongValueRead;
+    ptsDelta->cusecLongValuePageCacheMiss       = tsEnd.cusecLongValuePageCacheMiss - tsBegin.cusecLongValuePageCacheMiss;
+    ptsDelta->cLongValuePageCacheMiss           = tsEnd.cLongValuePageCacheMiss - tsBegin.cLongValuePageCacheMiss;
+    ptsDelta->cSeparatedLongValueCreated        = tsEnd.cSeparatedLongValueCreated - tsBegin.cSeparatedLongValueCreated;
+    ptsDelta->cPageUniqueCacheHits              = tsEnd.cPageUniqueCacheHits - tsBegin.cPageUniqueCacheHits;
+    ptsDelta->cPageUniqueCacheRequests          = tsEnd.cPageUniqueCacheRequests - tsBegin.cPageUniqueCacheRequests;
+    ptsDelta->cDatabaseReads                    = tsEnd.cDatabaseReads - tsBegin.cDatabaseReads;
+    ptsDelta->cSumDatabaseReadQueueDepthImpact  = tsEnd.cSumDatabaseReadQueueDepthImpact - tsBegin.cSumDatabaseReadQueueDepthImpact;
+    ptsDelta->cSumDatabaseReadQueueDepth        = tsEnd.cSumDatabaseReadQueueDepth - tsBegin.cSumDatabaseReadQueueDepth;
+    ptsDelta->cusecWait                         = tsEnd.cusecWait - tsBegin.cusecWait;
+    ptsDelta->cWait                             = tsEnd.cWait - tsBegin.cWait;
+    ptsDelta->cNodesFlagDeleted                 = tsEnd.cNodesFlagDeleted - tsBegin.cNodesFlagDeleted;
+    ptsDelta->cbNodesFlagDeleted                = tsEnd.cbNodesFlagDeleted - tsBegin.cbNodesFlagDeleted;
+    ptsDelta->cPageTableAllocated               = tsEnd.cPageTableAllocated - tsBegin.cPageTableAllocated;
+    ptsDelta->cPageTableReleased                = tsEnd.cPageTableReleased - tsBegin.cPageTableReleased;
+    ptsDelta->cPageUpdateAllocated              = tsEnd.cPageUpdateAllocated - tsBegin.cPageUpdateAllocated;
+    ptsDelta->cPageUpdateReleased               = tsEnd.cPageUpdateReleased - tsBegin.cPageUpdateReleased;
+    ptsDelta->cPageUniqueModified               = tsEnd.cPageUniqueModified - tsBegin.cPageUniqueModified;
+}
+
 class APICALL_SESID : public APICALL
 {
     private:
         PIB*                            m_ppib;
         const UserTraceContext* const   m_putcOuter;
+        BOOL                            m_fTimed;
+        HRT                             m_hrtBegin;
+        BOOL                            m_fOpStats;
+        QWORD                           m_ccycOpStatsBegin;
+        JET_THREADSTATS4                m_tsOpStatsBegin;
+
+        VOID OpStatsBegin_( const TLS * const ptls )
+        {
+            m_fOpStats = fTrue;
+            m_tsOpStatsBegin = ptls->threadstats;
+            m_ccycOpStatsBegin = CcycUtilThreadCPU();
+        }
+
+        VOID OpStatsEnd_( const TLS * const ptls, const ERR err, const HRT dhrt )
+        {
+            JET_OPSTATS opstats;
+            opstats.cbStruct        = sizeof( JET_OPSTATS );
+            JetApiOpName( m_op, opstats.szOp, sizeof( opstats.szOp ) );
+            opstats.err             = err;
+            opstats.cusecElapsed    = CusecHRTFromDhrt( dhrt );
+            opstats.cCPUCycles      = CcycUtilThreadCPU() - m_ccycOpStatsBegin;
+            OpStatsIDeltaThreadStats( &opstats.threadstats, ptls->threadstats, m_tsOpStatsBegin );
+
+            m_ppib->SetOpstatsLast( opstats );
+            m_fOpStats = fFalse;
+        }
 
     public:
         APICALL_SESID( const INT op ) :
             APICALL( op ),
             m_ppib( NULL ),
-            m_putcOuter( PutcTLSGetUserContext() )
+            m_putcOuter( PutcTLSGetUserContext() ),
+            m_fTimed( fFalse ),
+            m_fOpStats( fFalse )
             {}
         ~APICALL_SESID()                                    {}
 
@@ -3772,6 +4250,14 @@ class APICALL_SESID : public APICALL
                         }
 
                         ptls->fInJetAPI = fTrue;
+
+                        if ( m_err >= JET_errSuccess && BoolParam( pinst, JET_paramEnableOpStats ) )
+                        {
+                            OpStatsBegin_( ptls );
+                        }
+
+                        m_fTimed = fTrue;
+                        m_hrtBegin = HrtHRTCount();
                     }
                 }
 #if ENABLE_API_TRACE
@@ -3819,6 +4305,16 @@ class APICALL_SESID : public APICALL
         __forceinline VOID LeaveAfterCall( const ERR err )
         {
             TLS *ptls = m_ppib->ptlsApi ? m_ppib->ptlsApi : Ptls();
+            if ( m_fTimed )
+            {
+                const HRT dhrt = HrtHRTCount() - m_hrtBegin;
+                PinstFromPpib( m_ppib )->m_apilatency.Record( m_op, CusecHRTFromDhrt( dhrt ) );
+                if ( m_fOpStats )
+                {
+                    OpStatsEnd_( ptls, err, dhrt );
+                }
+                m_fTimed = fFalse;
+            }
             if ( !ptls->fInCallback )
             {
                 Assert( ptls->fInJetAPI );
@@ -5502,6 +5998,26 @@ HandleError:
     return err;
 }
 
+ERR
+SetLockContentionSampleRate(    CJetParam* const    pjetparam,
+                                INST* const         pinst,
+                                PIB* const          ppib,
+                                const ULONG_PTR     ulParam,
+                                PCWSTR              wszParam )
+{
+    ERR     err = JET_errSuccess;
+
+    Assert( pjetparam->m_paramid == JET_paramLockContentionSampleRate );
+
+    Call( CJetParam::SetInteger( pjetparam, pinst, ppib, ulParam, wszParam ) );
+
+    OSSyncSetLockContentionSampleRate( (DWORD)pjetparam->Value() );
+
+HandleError:
+
+    return err;
+}
+
 ERR
 SetDatabasePageSize(    CJetParam* const    pjetparam,
                         INST* const         pinst,
@@ -20279,6 +20795,12 @@ LOCAL JET_ERR JET_API JetGetInstanceMiscInfoEx(
         case JET_InstanceMiscInfoRBS:
             cbMin = sizeof(JET_RBSINFOMISC);
             break;
+        case JET_InstanceMiscInfoLockContention:
+            cbMin = sizeof(JET_LOCKCONTENTION);
+            break;
+        case JET_InstanceMiscInfoApiLatency:
+            cbMin = sizeof(JET_APILATENCY);
+            break;
         default:
             Error( ErrERRCheck( JET_errInvalidParameter ) );
     }
@@ -20330,6 +20852,66 @@ LOCAL JET_ERR JET_API JetGetInstanceMiscInfoEx(
 
             break;
 
+            case JET_InstanceMiscInfoLockContention:
+            {
+                //  lock contention is sampled by the sync library for the whole process, not per instance,
+                //  so every instance returns the same entries, including waits on other instances' locks
+
+                JET_LOCKCONTENTION * const  rglc    = (JET_LOCKCONTENTION *)pvResult;
+                const size_t                clcMax  = cbMax / sizeof(JET_LOCKCONTENTION);
+                OSSYNCLOCKCONTENTION *      rglcSync = NULL;
+
+                Alloc( rglcSync = new OSSYNCLOCKCONTENTION[ clcMax ] );
+
+                const size_t clc = COSSyncGetLockContention( rglcSync, clcMax );
+                for ( size_t ilc = 0; ilc < clc; ilc++ )
+                {
+                    rglc[ ilc ].pvLock          = (void *)rglcSync[ ilc ].pvLock;
+                    rglc[ ilc ].pvCallSite      = (void *)rglcSync[ ilc ].pvCallSite;
+                    rglc[ ilc ].cSamples        = rglcSync[ ilc ].cSamples;
+                    rglc[ ilc ].cusecWaitTotal  = rglcSync[ ilc ].cusecWaitTotal;
+                    rglc[ ilc ].cusecWaitMax    = rglcSync[ ilc ].cusecWaitMax;
+                }
+                if ( clc < clcMax )
+                {
+                    memset( &rglc[ clc ], 0, sizeof(JET_LOCKCONTENTION) );
+                }
+
+                delete[] rglcSync;
+            }
+
+            break;
+
+            case JET_InstanceMiscInfoApiLatency:
+            {
+                JET_APILATENCY * const  rgal    = (JET_APILATENCY *)pvResult;
+                const size_t            calMax  = cbMax / sizeof(JET_APILATENCY);
+                size_t                  cal     = 0;
+                QWORD                   rgcBucket[ CApiLatencyHistograms::cBucket ];
+
+                for ( INT op = 0; op < opMax && cal < calMax; op++ )
+                {
+                    const QWORD cSamples = pinst->m_apilatency.CSamples( op, rgcBucket );
+                    if ( 0 == cSamples )
+                    {
+                        continue;
+                    }
+
+                    JetApiOpName( op, rgal[ cal ].szOp, sizeof( rgal[ cal ].szOp ) );
+                    rgal[ cal ].cSamples    = cSamples;
+                    rgal[ cal ].cusecP50    = CApiLatencyHistograms::CusecPercentile( rgcBucket, cSamples, 500 );
+                    rgal[ cal ].cusecP99    = CApiLatencyHistograms::CusecPercentile( rgcBucket, cSamples, 990 );
+                    rgal[ cal ].cusecP999   = CApiLatencyHistograms::CusecPercentile( rgcBucket, cSamples, 999 );
+                    cal++;
+                }
+                if ( cal < calMax )
+                {
+                    memset( &rgal[ cal ], 0, sizeof(JET_APILATENCY) );
+                }
+            }
+
+            break;
+
             default:
                 Assert( fFalse );
                 Error( ErrERRCheck( JET_errInvalidParameter ) );
@@ -21578,9 +22160,31 @@ JET_ERR JET_API JetTestHook(
         }
             break;
 
+        case opTestHookUnitBenchmarks:
+        {
+            const JET_TESTHOOKUNITBENCHMARK* const pParams = reinterpret_cast<JET_TESTHOOKUNITBENCHMARK*>( pv );
+            if ( pParams == NULL || pParams->cbStruct != sizeof(JET_TESTHOOKUNITBENCHMARK) )
+            {
+                Call( ErrERRCheck( JET_errInvalidParameter ) );
+            }
+
+            Call( ErrSetSystemParameter( pinstNil, JET_sesidNil, JET_paramDisablePerfmon, fTrue, NULL ) );
+            Call( ErrOSUInit() );
+            JetUnitBenchmark::Configure( pParams->szJsonFile, pParams->cRuns );
+            const INT failures = JetUnitTest::RunTests( pParams->szBenchmarkName, ifmpNil, true );
+            JetUnitBenchmark::Configure( NULL, 0 );
+            if( failures > 0 )
+            {
+                err = ErrERRCheck( JET_errInternalError );
+            }
+            OSUTerm();
+        }
+            break;
+
 #else
         case opTestHookUnitTests:
         case opTestHookUnitTests2:
+        case opTestHookUnitBenchmarks:
             err = ErrERRCheck( JET_errDisabledFunctionality );
             break;
 
@@ -22763,6 +23367,57 @@ JETUNITTEST( JetApi, ErrGetLogInfoMiscFromLgfilehdr )
     CHECK( 9 == loginfomisc2.lgposCheckpoint.lGeneration );
 }
 
+JETUNITTEST( JetApi, ApiLatencyHistogramBuckets )
+{
+    for ( ULONG iBucket = 0; iBucket < CApiLatencyHistograms::cBucket - 1; iBucket++ )
+    {
+        const QWORD cusecMax = CApiLatencyHistograms::CusecMaxFromIBucket( iBucket );
+        CHECK( iBucket == CApiLatencyHistograms::IBucketFromCusec( cusecMax ) );
+        CHECK( iBucket + 1 == CApiLatencyHistograms::IBucketFromCusec( cusecMax + 1 ) );
+    }
+    CHECK( CApiLatencyHistograms::cBucket - 1 == CApiLatencyHistograms::IBucketFromCusec( qwMax ) );
+    CHECK( CApiLatencyHistograms::cBucket - 1 == CApiLatencyHistograms::IBucketFromCusec( 0x100000000 ) );
+    CHECK( CApiLatencyHistograms::cBucket - 1 == CApiLatencyHistograms::IBucketFromCusec( 0x100000005 ) );
+    CHECK( CApiLatencyHistograms::cBucket - 1 == CApiLatencyHistograms::IBucketFromCusec( 0x10000000000 ) );
+
+    QWORD rgcBucket[ CApiLatencyHistograms::cBucket ] = { 0 };
+    rgcBucket[ CApiLatencyHistograms::IBucketFromCusec( 5 ) ]       = 980;
+    rgcBucket[ CApiLatencyHistograms::IBucketFromCusec( 100 ) ]     = 19;
+    rgcBucket[ CApiLatencyHistograms::IBucketFromCusec( 50000 ) ]   = 1;
+
+    CHECK( 5 == CApiLatencyHistograms::CusecPercentile( rgcBucket, 1000, 500 ) );
+    CHECK( 100 <= CApiLatencyHistograms::CusecPercentile( rgcBucket, 1000, 990 ) );
+    CHECK( 50000 <= CApiLatencyHistograms::CusecPercentile( rgcBucket, 1000, 1000 ) );
+    CHECK( 0 == CApiLatencyHistograms::CusecPercentile( rgcBucket, 0, 500 ) );
+}
+
+JETUNITTEST( JetApi, JetApiOpNames )
+{
+    CHAR szOp[ JET_cbOpNameMost ];
+
+    JetApiOpName( 0, szOp, sizeof( szOp ) );
+    CHECK( 0 == strcmp( szOp, "" ) );
+
+#define CHECK_OP_NAME( op )     { JetApiOpName( op##op, szOp, sizeof( szOp ) ); CHECK( 0 == strcmp( szOp, "Jet" #op ) ); }
+
+    CHECK_OP_NAME( Idle );
+    CHECK_OP_NAME( OpenTable );
+    CHECK_OP_NAME( SetTableSequential );
+    CHECK_OP_NAME( BeginSession );
+    CHECK_OP_NAME( EndExternalBackupInstance );
+    CHECK_OP_NAME( SetTableInfo );
+    CHECK_OP_NAME( RetrieveColumnByReference );
+    CHECK_OP_NAME( RBSCancelRevert );
+
+#undef CHECK_OP_NAME
+
+    for ( INT op = 1; op < opMax; op++ )
+    {
+        JetApiOpName( op, szOp, sizeof( szOp ) );
+        CHECK( 0 == strncmp( szOp, "Jet", 3 ) );
+    }
+}
+
 JETUNITTEST( JetApi, CAutoINDEXCREATE1To2 )
 {
     const INT cindexes = 3;
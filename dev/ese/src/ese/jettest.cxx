@@ -95,7 +95,7 @@ void JetUnitTest::PrintTests()
     }
 }
 
-INT JetUnitTest::RunTests( const char * const szTest, const IFMP ifmpTest )
+INT JetUnitTest::RunTests( const char * const szTest, const IFMP ifmpTest, const bool fBenchmarks )
 {
     bool fBFInitd = false;
 
@@ -130,9 +130,9 @@ INT JetUnitTest::RunTests( const char * const szTest, const IFMP ifmpTest )
         {
             (void)FNegTestUnset( fLeakingUnflushedIos );
         }
-        if( FTestNameMatches( ptest->m_szName, szTest ) )
+        if( FTestNameMatches( ptest->m_szName, szTest ) && ptest->FBenchmark() == fBenchmarks )
         {
-            if( ptest->FRunByDefault() || !fDefaultRun )
+            if( ptest->FRunByDefault() || !fDefaultRun || fBenchmarks )
             {
 
                 if ( ifmpTest == ifmpNil || ifmpTest == JET_dbidNil )
@@ -257,6 +257,11 @@ bool JetUnitTest::FRunByDefault()
     return fTrue;
 }
 
+bool JetUnitTest::FBenchmark()
+{
+    return fFalse;
+}
+
 void JetUnitTest::SetTestIfmp( const IFMP ifmpTest )
 {
     ExpectedSz( fFalse, "Setting Test Database / IFMP on test that does not require Test Database" );
@@ -342,6 +347,175 @@ IFMP JetSimpleDbUnitTest::IfmpTest()
 
 
 
+const char * JetUnitBenchmark::s_szJsonFile = NULL;
+INT JetUnitBenchmark::s_cRun = 20;
+
+void JetUnitBenchmark::Configure( const char * const szJsonFile, const INT cRun )
+{
+    s_szJsonFile = szJsonFile;
+    if ( cRun > 0 )
+    {
+        s_cRun = min( cRun, 1000 );
+    }
+}
+
+JetUnitBenchmark::JetUnitBenchmark( const char * const szName ) :
+    JetSimpleUnitTest( szName, dwDontRunByDefault ),
+    m_szName( szName ),
+    m_benchstate( benchstateNotStarted ),
+    m_rgdhrtRun( NULL ),
+    m_rgdccycRun( NULL )
+{
+}
+
+JetUnitBenchmark::JetUnitBenchmark( const char * const szName, const DWORD dwFacilities ) :
+    JetSimpleUnitTest( szName, dwFacilities | dwDontRunByDefault ),
+    m_szName( szName ),
+    m_benchstate( benchstateNotStarted ),
+    m_rgdhrtRun( NULL ),
+    m_rgdccycRun( NULL )
+{
+}
+
+JetUnitBenchmark::~JetUnitBenchmark()
+{
+}
+
+void JetUnitBenchmark::Run( JetUnitTestResult * const presult )
+{
+    m_presult = presult;
+
+    m_benchstate    = benchstateNotStarted;
+    m_cIterPerRun   = 0;
+    m_cIterLeft     = 0;
+    m_iRun          = 0;
+    m_rgdhrtRun     = new HRT[ s_cRun ];
+    m_rgdccycRun    = new QWORD[ s_cRun ];
+
+    if ( NULL == m_rgdhrtRun || NULL == m_rgdccycRun )
+    {
+        Fail_( __FILE__, __LINE__, "Out of memory for benchmark samples" );
+    }
+    else
+    {
+        Run_();
+
+        if ( benchstateDone == m_benchstate )
+        {
+            Report_();
+        }
+        else
+        {
+            Fail_( __FILE__, __LINE__, "Benchmark body did not iterate to completion" );
+        }
+    }
+
+    delete[] m_rgdhrtRun;
+    delete[] m_rgdccycRun;
+    m_rgdhrtRun = NULL;
+    m_rgdccycRun = NULL;
+}
+
+void JetUnitBenchmark::StartRun_()
+{
+    m_cIterLeft = m_cIterPerRun - 1;
+    m_ccycRunStart = CcycUtilThreadCPU();
+    m_hrtRunStart = HrtHRTCount();
+}
+
+bool JetUnitBenchmark::FIterateNextRun_()
+{
+    const HRT dhrt = HrtHRTCount() - m_hrtRunStart;
+    const QWORD dccyc = CcycUtilThreadCPU() - m_ccycRunStart;
+
+    switch ( m_benchstate )
+    {
+        case benchstateNotStarted:
+            m_benchstate = benchstateWarmup;
+            m_cIterPerRun = 1;
+            break;
+
+        case benchstateWarmup:
+            if ( dhrt < HrtHRTFreq() / 100 && m_cIterPerRun < ( QWORD( 1 ) << 40 ) )
+            {
+                m_cIterPerRun *= 2;
+            }
+            else
+            {
+                m_benchstate = benchstateMeasure;
+                m_iRun = 0;
+            }
+            break;
+
+        case benchstateMeasure:
+            m_rgdhrtRun[ m_iRun ] = dhrt;
+            m_rgdccycRun[ m_iRun ] = dccyc;
+            m_iRun++;
+            if ( m_iRun == s_cRun )
+            {
+                m_benchstate = benchstateDone;
+                return false;
+            }
+            break;
+
+        default:
+            Assert( fFalse );
+            return false;
+    }
+
+    StartRun_();
+    return true;
+}
+
+void JetUnitBenchmark::Report_()
+{
+    const double dblNsPerHrt = 1000000000.0 / (double)HrtHRTFreq();
+
+    std::sort( m_rgdhrtRun, m_rgdhrtRun + s_cRun );
+    std::sort( m_rgdccycRun, m_rgdccycRun + s_cRun );
+
+    const INT iRunMedian    = s_cRun / 2;
+    const INT iRunP99       = min( s_cRun - 1, ( s_cRun * 99 + 99 ) / 100 - 1 );
+
+    const double nsMin      = (double)m_rgdhrtRun[ 0 ] * dblNsPerHrt / (double)m_cIterPerRun;
+    const double nsMedian   = (double)m_rgdhrtRun[ iRunMedian ] * dblNsPerHrt / (double)m_cIterPerRun;
+    const double nsP99      = (double)m_rgdhrtRun[ iRunP99 ] * dblNsPerHrt / (double)m_cIterPerRun;
+    const double ccycMedian = (double)m_rgdccycRun[ iRunMedian ] / (double)m_cIterPerRun;
+
+    printf( "\n\t%d runs x %I64u iterations: min %.1f ns, median %.1f ns, p99 %.1f ns, median %.1f cycles per iteration\n\t",
+            s_cRun,
+            m_cIterPerRun,
+            nsMin,
+            nsMedian,
+            nsP99,
+            ccycMedian );
+
+    if ( s_szJsonFile )
+    {
+        FILE * pfile = NULL;
+        (void)fopen_s( &pfile, s_szJsonFile, "at" );
+        if ( pfile )
+        {
+            fprintf( pfile,
+                     "{\"name\":\"%s\",\"runs\":%d,\"iterations\":%I64u,\"ns_min\":%.3f,\"ns_median\":%.3f,\"ns_p99\":%.3f,\"cycles_median\":%.3f}\n",
+                     m_szName,
+                     s_cRun,
+                     m_cIterPerRun,
+                     nsMin,
+                     nsMedian,
+                     nsP99,
+                     ccycMedian );
+            fclose( pfile );
+        }
+        else
+        {
+            Fail_( __FILE__, __LINE__, "Could not open benchmark JSON output file" );
+        }
+    }
+}
+
+
+
 JetTestFixture::JetTestFixture() :
     m_presult(NULL)
 {
@@ -1293,3 +1293,63 @@ JETUNITTEST ( Node, TestCorruptRandishFuzzingStress )
         }
     }
 }
+
+JETUNITBENCHMARK( Node, IlineNDISeekGEQ )
+{
+    const ULONG cbPage = 32 * 1024;
+    const INT clines = 500;
+    const INT cseek = 256;
+
+    CPAGE cpage;
+    cpage.LoadNewTestPage( cbPage );
+
+    BYTE rgbHeader[ 8 ] = { 0 };
+    DATA data;
+    data.SetPv( rgbHeader );
+    data.SetCb( sizeof( rgbHeader ) );
+    cpage.SetExternalHeader( &data, 1, 0x0 );
+
+    for ( INT iline = 0; iline < clines; iline++ )
+    {
+        BYTE rgbKey[ 8 ] = { 0 };
+        *(UnalignedBigEndian<ULONG>*)rgbKey = ULONG( iline * 2 );
+
+        KEYDATAFLAGS    kdf;
+        kdf.Nullify();
+        kdf.key.suffix.SetPv( rgbKey );
+        kdf.key.suffix.SetCb( sizeof( rgbKey ) );
+        kdf.data.SetPv( rgbKey );
+        kdf.data.SetCb( sizeof( rgbKey ) );
+
+        DATA            rgdata[ 5 ];
+        INT             fFlagsLine;
+        LE_KEYLEN       le_keylen;
+        le_keylen.le_cbPrefix = 0;
+        const INT cdata = CdataNDIPrefixAndKeydataflagsToDataflags( &kdf, rgdata, &fFlagsLine, &le_keylen );
+        cpage.Insert( iline, rgdata, cdata, fFlagsLine );
+    }
+
+    BYTE rgrgbSeek[ cseek ][ 8 ];
+    for ( INT iseek = 0; iseek < cseek; iseek++ )
+    {
+        memset( rgrgbSeek[ iseek ], 0, sizeof( rgrgbSeek[ iseek ] ) );
+        *(UnalignedBigEndian<ULONG>*)rgrgbSeek[ iseek ] = ULONG( rand() % ( clines * 2 ) );
+    }
+
+    INT iseek = 0;
+    INT ilineLast = 0;
+    BENCHMARK_ITERATE()
+    {
+        BOOKMARK bm;
+        bm.Nullify();
+        bm.key.suffix.SetPv( rgrgbSeek[ iseek ] );
+        bm.key.suffix.SetCb( sizeof( rgrgbSeek[ iseek ] ) );
+
+        INT compare;
+        ilineLast = IlineNDISeekGEQ( cpage, bm, fTrue, &compare );
+        iseek = ( iseek + 1 ) % cseek;
+    }
+
+    CHECK( ilineLast >= 0 );
+    cpage.UnloadPage();
+}
@@ -188,6 +188,71 @@ DWORD BasicEnterLeaveThread( DWORD_PTR dwContext )
     return 0;
 }
 
+LOCAL volatile LONG g_cTaskManagerTestRun;
+LOCAL volatile LONG g_cTaskManagerTestPostFailed;
+
+LOCAL VOID TaskManagerTestTask( const DWORD     dwError,
+                                const DWORD_PTR dwThreadContext,
+                                const DWORD     dwCompletionKey1,
+                                const DWORD_PTR dwCompletionKey2 )
+{
+    CTaskManager * const ptm = (CTaskManager *)dwCompletionKey2;
+
+    if ( dwCompletionKey1 > 0 && ptm->ErrTMPost( TaskManagerTestTask, dwCompletionKey1 - 1, dwCompletionKey2 ) < JET_errSuccess )
+    {
+        AtomicIncrement( (LONG *)&g_cTaskManagerTestPostFailed );
+    }
+
+    AtomicIncrement( (LONG *)&g_cTaskManagerTestRun );
+}
+
+JETUNITTEST( CTaskManager, EveryTaskRunsWhenPostingFromWorkersAndOverflowingRings )
+{
+    const ULONG     cTaskRoot   = 2000;
+    const ULONG     cDepth      = 3;
+    CTaskManager    tm;
+
+    g_cTaskManagerTestRun = 0;
+    g_cTaskManagerTestPostFailed = 0;
+
+    CHECK( JET_errSuccess == tm.ErrTMInit( 4 ) );
+
+    for ( ULONG iTask = 0; iTask < cTaskRoot; iTask++ )
+    {
+        CHECK( JET_errSuccess == tm.ErrTMPost( TaskManagerTestTask, cDepth, DWORD_PTR( &tm ) ) );
+    }
+
+    while ( g_cTaskManagerTestRun < LONG( cTaskRoot * ( cDepth + 1 ) ) && 0 == g_cTaskManagerTestPostFailed )
+    {
+        UtilSleep( 1 );
+    }
+
+    CHECK( 0 == g_cTaskManagerTestPostFailed );
+    CHECK( LONG( cTaskRoot * ( cDepth + 1 ) ) == g_cTaskManagerTestRun );
+
+    tm.TMTerm();
+}
+
+JETUNITTEST( TaskInfoGenericStats, LatencyBuckets )
+{
+    CHECK( 0 == TaskInfoGenericStats::IBucketFromCusec( 0 ) );
+    CHECK( 1 == TaskInfoGenericStats::IBucketFromCusec( 1 ) );
+    CHECK( 2 == TaskInfoGenericStats::IBucketFromCusec( 2 ) );
+    CHECK( 2 == TaskInfoGenericStats::IBucketFromCusec( 3 ) );
+    CHECK( 3 == TaskInfoGenericStats::IBucketFromCusec( 4 ) );
+    CHECK( TaskInfoGenericStats::cLatencyBucket - 1 == TaskInfoGenericStats::IBucketFromCusec( ~QWORD( 0 ) ) );
+
+    LONG rgc[ TaskInfoGenericStats::cLatencyBucket ] = { 0 };
+    CHECK( 0 == TaskInfoGenericStats::CusecPercentile( rgc, 500 ) );
+
+    rgc[ 1 ] = 90;
+    rgc[ 11 ] = 9;
+    rgc[ 20 ] = 1;
+    CHECK( 1 == TaskInfoGenericStats::CusecPercentile( rgc, 500 ) );
+    CHECK( 2047 == TaskInfoGenericStats::CusecPercentile( rgc, 990 ) );
+    CHECK( ( 1 << 20 ) - 1 == TaskInfoGenericStats::CusecPercentile( rgc, 999 ) );
+}
+
 #pragma warning( push )
 #pragma warning( disable: 4101 4189 )
 
@@ -274,6 +339,162 @@ JETUNITTEST( PatrolDogSynchronizer, ProperTiming )
 }
 
 
+template< class TLock >
+class CRWLBenchmark
+{
+    public:
+        CRWLBenchmark( const INT cLoop, const INT cReadsPerWrite )
+            :   m_lock( CLockBasicInfo( CSyncBasicInfo( "CRWLBenchmark::m_lock" ), 0, 0 ) ),
+                m_cLoop( cLoop ),
+                m_cReadsPerWrite( cReadsPerWrite ),
+                m_lValue1( 0 ),
+                m_lValue2( 0 ),
+                m_cTornReads( 0 )
+        {
+        }
+
+        static DWORD DwThreadProc( DWORD_PTR dwContext )
+        {
+            ( (CRWLBenchmark*)dwContext )->Run_();
+            return 0;
+        }
+
+        LONG LValue() const         { return m_lValue1; }
+        LONG CTornReads() const     { return m_cTornReads; }
+
+    private:
+        void EnterAsReader_( INT* const piStripe );
+        void LeaveAsReader_( const INT iStripe );
+
+        void Run_()
+        {
+            for ( INT iLoop = 0; iLoop < m_cLoop; iLoop++ )
+            {
+                if ( m_cReadsPerWrite > 0 && ( iLoop % m_cReadsPerWrite ) == 0 )
+                {
+                    m_lock.EnterAsWriter();
+                    m_lValue1++;
+                    m_lValue2++;
+                    m_lock.LeaveAsWriter();
+                }
+                else
+                {
+                    INT iStripe;
+                    EnterAsReader_( &iStripe );
+                    if ( m_lValue1 != m_lValue2 )
+                    {
+                        AtomicIncrement( (LONG*)&m_cTornReads );
+                    }
+                    LeaveAsReader_( iStripe );
+                }
+            }
+        }
+
+        TLock           m_lock;
+        const INT       m_cLoop;
+        const INT       m_cReadsPerWrite;
+        volatile LONG   m_lValue1;
+        volatile LONG   m_lValue2;
+        volatile LONG   m_cTornReads;
+};
+
+template<>
+void CRWLBenchmark< CReaderWriterLock >::EnterAsReader_( INT* const piStripe )  { m_lock.EnterAsReader(); *piStripe = 0; }
+template<>
+void CRWLBenchmark< CReaderWriterLock >::LeaveAsReader_( const INT iStripe )    { m_lock.LeaveAsReader(); }
+template<>
+void CRWLBenchmark< CBigReaderWriterLock >::EnterAsReader_( INT* const piStripe )   { *piStripe = m_lock.EnterAsReader(); }
+template<>
+void CRWLBenchmark< CBigReaderWriterLock >::LeaveAsReader_( const INT iStripe )     { m_lock.LeaveAsReader( iStripe ); }
+
+template< class TLock >
+LOCAL QWORD CmsecRWLBenchmark( const INT cThread, const INT cLoop, const INT cReadsPerWrite, LONG* const pcTornReads )
+{
+    CRWLBenchmark< TLock > bench( cLoop, cReadsPerWrite );
+    THREAD rgthread[ 128 ] = { 0 };
+    INT ithread = 0;
+
+    Assert( cThread <= _countof( rgthread ) );
+
+    const HRT hrtStart = HrtHRTCount();
+    for ( ithread = 0; ithread < cThread; ithread++ )
+    {
+        if ( ErrUtilThreadCreate( CRWLBenchmark< TLock >::DwThreadProc, 0, priorityNormal, &rgthread[ ithread ], (DWORD_PTR)&bench ) < JET_errSuccess )
+        {
+            break;
+        }
+    }
+    for ( INT ithreadEnd = 0; ithreadEnd < ithread; ithreadEnd++ )
+    {
+        UtilThreadEnd( rgthread[ ithreadEnd ] );
+    }
+    const QWORD cmsec = CmsecHRTFromDhrt( HrtHRTCount() - hrtStart );
+
+    *pcTornReads = bench.CTornReads();
+    if ( cReadsPerWrite > 0 && ithread == cThread && bench.LValue() != cThread * ( ( cLoop + cReadsPerWrite - 1 ) / cReadsPerWrite ) )
+    {
+        ( *pcTornReads )++;
+    }
+
+    return cmsec;
+}
+
+JETUNITTEST( SYNC, BigReaderWriterLockExcludesWriters )
+{
+    CBigReaderWriterLock brwl( CLockBasicInfo( CSyncBasicInfo( "BigReaderWriterLockExcludesWriters" ), 0, 0 ) );
+
+    const INT iStripe = brwl.EnterAsReader();
+    CHECK( !brwl.FTryEnterAsWriter() );
+    CHECK( !brwl.FWriterActive() );
+
+    INT iStripeT;
+    CHECK( brwl.FTryEnterAsReader( &iStripeT ) );
+    brwl.LeaveAsReader( iStripeT );
+    brwl.LeaveAsReader( iStripe );
+
+    CHECK( brwl.FTryEnterAsWriter() );
+    CHECK( brwl.FWriterActive() );
+    CHECK( !brwl.FTryEnterAsReader( &iStripeT ) );
+    brwl.LeaveAsWriter();
+
+    CHECK( brwl.FTryEnterAsReader( &iStripeT ) );
+    brwl.LeaveAsReader( iStripeT );
+}
+
+JETUNITTEST( SYNC, BigReaderWriterLockConcurrentReadersAndWriters )
+{
+    LONG cTornReads = 0;
+    CmsecRWLBenchmark< CBigReaderWriterLock >( 16, 20000, 64, &cTornReads );
+    CHECK( 0 == cTornReads );
+}
+
+//  read-mostly contention between 32 threads, the big reader/writer lock should scale where the plain one does not
+
+JETUNITBENCHMARK( SYNC, ReaderWriterLockContention32Threads )
+{
+    LONG cTornReads = 0;
+    BENCHMARK_ITERATE()
+    {
+        LONG cTornReadsRun = 0;
+        CmsecRWLBenchmark< CReaderWriterLock >( 32, 2000, 1000, &cTornReadsRun );
+        cTornReads += cTornReadsRun;
+    }
+    CHECK( 0 == cTornReads );
+}
+
+JETUNITBENCHMARK( SYNC, BigReaderWriterLockContention32Threads )
+{
+    LONG cTornReads = 0;
+    BENCHMARK_ITERATE()
+    {
+        LONG cTornReadsRun = 0;
+        CmsecRWLBenchmark< CBigReaderWriterLock >( 32, 2000, 1000, &cTornReadsRun );
+        cTornReads += cTornReadsRun;
+    }
+    CHECK( 0 == cTornReads );
+}
+
+
 JETUNITTEST( NORM, NormCompareBasic )
 {
     CHECK( 0 == NORMCompareLocaleName( L"en-US", L"en-US" ) );
@@ -20,8 +20,157 @@ LONG LPIBTotalCEFLPv( LONG iInstance, void* pvBuf )
     return 0;
 }
 
+PERFInstanceDelayedTotal<QWORD> cPIBArenaAlloc;
+LONG LPIBArenaAllocCEFLPv( LONG iInstance, void* pvBuf )
+{
+    cPIBArenaAlloc.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceDelayedTotal<> cPIBArenaHeapAlloc;
+LONG LPIBArenaHeapAllocCEFLPv( LONG iInstance, void* pvBuf )
+{
+    cPIBArenaHeapAlloc.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
 #endif
 
+BOOL CArena::FTryEnterScope_()
+{
+    const DWORD dwThreadId = DwUtilThreadId();
+    Assert( 0 != dwThreadId );
+
+    if ( dwThreadId != m_dwOwnerThreadId &&
+        0 != AtomicCompareExchange( (ULONG *)&m_dwOwnerThreadId, 0, dwThreadId ) )
+    {
+        return fFalse;
+    }
+
+    Assert( dwThreadId == m_dwOwnerThreadId );
+    m_cScope++;
+    return fTrue;
+}
+
+VOID * CArena::CScope::PvAllocFromHeap_( const size_t cb )
+{
+    const size_t cbAlloc = cbHeapAllocHeader + cb;
+    if ( cbAlloc < cb )
+    {
+        return NULL;
+    }
+
+    HEAPALLOC * const pheapalloc = (HEAPALLOC *)PvOSMemoryHeapAlloc( cbAlloc );
+    if ( NULL == pheapalloc )
+    {
+        return NULL;
+    }
+
+    pheapalloc->pheapallocNext = m_pheapalloc;
+    m_pheapalloc = pheapalloc;
+
+    return (BYTE *)pheapalloc + cbHeapAllocHeader;
+}
+
+VOID CArena::CScope::FreeHeapAllocs_( HEAPALLOC * pheapalloc )
+{
+    while ( NULL != pheapalloc )
+    {
+        HEAPALLOC * const pheapallocFree = pheapalloc;
+        pheapalloc = pheapalloc->pheapallocNext;
+        OSMemoryHeapFree( pheapallocFree );
+    }
+}
+
+VOID * CArena::PvAllocFromNewBlock_( const size_t cb )
+{
+    BLOCK * pblock = NULL;
+
+    if ( NULL != m_pblockSpare && cb <= m_pblockSpare->cb - cbBlockHeader )
+    {
+        pblock = m_pblockSpare;
+        m_pblockSpare = NULL;
+    }
+    else
+    {
+        const size_t cbBlock = max( (size_t)cbBlockDefault, cbBlockHeader + cb );
+        if ( cbBlock < cb )
+        {
+            return NULL;
+        }
+
+        pblock = (BLOCK *)PvOSMemoryHeapAlloc( cbBlock );
+        if ( NULL == pblock )
+        {
+            return NULL;
+        }
+        pblock->cb = cbBlock;
+
+        m_cHeapAlloc++;
+        PERFOpt( cPIBArenaHeapAlloc.Inc( m_iInstance ) );
+    }
+
+    pblock->pblockPrev = m_pblockCurr;
+    pblock->ibFree = cbBlockHeader + cb;
+    m_pblockCurr = pblock;
+
+    return (BYTE *)pblock + cbBlockHeader;
+}
+
+VOID CArena::Rewind_( BLOCK * const pblock, const size_t ibFree )
+{
+    Assert( m_cScope > 0 );
+    Assert( DwUtilThreadId() == m_dwOwnerThreadId );
+
+    while ( m_pblockCurr != pblock )
+    {
+        BLOCK * const pblockFree = m_pblockCurr;
+        Assert( NULL != pblockFree );
+        m_pblockCurr = pblockFree->pblockPrev;
+
+        if ( NULL == m_pblockSpare && cbBlockDefault == pblockFree->cb )
+        {
+            m_pblockSpare = pblockFree;
+        }
+        else
+        {
+            OSMemoryHeapFree( pblockFree );
+        }
+    }
+
+    if ( NULL != m_pblockCurr )
+    {
+        Assert( ibFree <= m_pblockCurr->ibFree );
+        m_pblockCurr->ibFree = ibFree;
+    }
+
+    if ( 0 == --m_cScope )
+    {
+        Assert( NULL == m_pblockCurr );
+        PERFOpt( cPIBArenaAlloc.Add( m_iInstance, m_cAlloc - m_cAllocReported ) );
+        m_cAllocReported = m_cAlloc;
+        AtomicExchange( (LONG *)&m_dwOwnerThreadId, 0 );
+    }
+}
+
+VOID CArena::Term()
+{
+    Assert( 0 == m_cScope );
+    Assert( 0 == m_dwOwnerThreadId );
+    Assert( NULL == m_pblockCurr );
+
+    while ( NULL != m_pblockCurr )
+    {
+        BLOCK * const pblockFree = m_pblockCurr;
+        m_pblockCurr = pblockFree->pblockPrev;
+        OSMemoryHeapFree( pblockFree );
+    }
+
+    OSMemoryHeapFree( m_pblockSpare );
+    m_pblockSpare = NULL;
+}
+
+
 TrxidStack::TrxidStack() : m_ctrxCurr( 0 )
 {
 }
@@ -154,6 +303,43 @@ JETUNITTEST( TrxidStack, BufferTooSmallForTime )
     CHECK( 0 == wsz[0] );
 }
 
+LOCAL DWORD DwArenaScopeOnOtherThread( DWORD_PTR dwContext )
+{
+    CArena * const parena = (CArena *)dwContext;
+    CArena::CScope scope( parena );
+    BYTE * const pb = (BYTE *)scope.PvAlloc( 100 );
+    if ( pb )
+    {
+        memset( pb, 0xFF, 100 );
+    }
+    return pb ? 1 : 0;
+}
+
+JETUNITTEST( CArena, ScopeOnOtherThreadFallsBackToHeap )
+{
+    CArena arena;
+    THREAD thread;
+
+    {
+        CArena::CScope scope( &arena );
+        BYTE * const pb = (BYTE *)scope.PvAlloc( 100 );
+        CHECK( NULL != pb );
+        CHECK( 1 == arena.CAlloc() );
+
+        CHECK( JET_errSuccess == ErrUtilThreadCreate( DwArenaScopeOnOtherThread, 0, priorityNormal, &thread, (DWORD_PTR)&arena ) );
+        CHECK( 1 == UtilThreadEnd( thread ) );
+        CHECK( 1 == arena.CAlloc() );
+
+        CArena::CScope scopeNested( &arena );
+        CHECK( NULL != scopeNested.PvAlloc( 100 ) );
+        CHECK( 2 == arena.CAlloc() );
+    }
+
+    CHECK( JET_errSuccess == ErrUtilThreadCreate( DwArenaScopeOnOtherThread, 0, priorityNormal, &thread, (DWORD_PTR)&arena ) );
+    CHECK( 1 == UtilThreadEnd( thread ) );
+    CHECK( 3 == arena.CAlloc() );
+}
+
 #endif
 
 template<class KEY, class DATA>
@@ -568,6 +754,7 @@ ERR ErrPIBBeginSession( INST *pinst, _Outptr_ PIB ** pppib, PROCID procidTarget,
     Assert( 0 == ppib->cCursors );
 
     ppib->m_pinst = pinst;
+    ppib->m_arena.SetPerfInstance( pinst->m_iInstance );
     Assert( 0 == ppib->Level() );
 
     Assert( ppib->grbitCommitDefault == NO_GRBIT ); 
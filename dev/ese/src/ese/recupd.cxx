@@ -240,6 +240,7 @@ ERR ErrRECIEnumerateKeys(
 
     KEY             keyRead;
     BYTE            *pbReadKey              = NULL;
+    CArena::CScope  arenascope( pfucb->ppib->Parena() );
 
     Assert( ( pfnIndexEntryCallback == ErrRECIInsertIndexEntry ) ||
             ( pfnIndexEntryCallback == ErrRECIDeleteIndexEntry ) ||
@@ -249,7 +250,7 @@ ERR ErrRECIEnumerateKeys(
     Assert( NULL != pfnIndexEntryCallback );
     Assert( NULL != pfIndexUpdated );
 
-    Alloc( pbReadKey = (BYTE *)RESKEY.PvRESAlloc() );
+    Alloc( pbReadKey = (BYTE *)arenascope.PvAlloc( cbKeyAlloc ) );
     keyRead.prefix.Nullify();
     keyRead.suffix.SetPv( pbReadKey );
 
@@ -403,7 +404,6 @@ ERR ErrRECIEnumerateKeys(
     }
 
 HandleError:
-    RESKEY.Free( pbReadKey );
     return err;
 }
 
@@ -1088,6 +1088,7 @@ LOCAL ERR ErrRECIInsert(
     FCB *           pfcbIdx;
     FUCB *          pfucbT                  = pfucbNil;
     BOOL            fUpdatingLatchSet       = fFalse;
+    CArena::CScope  arenascope( ppib->Parena() );
     ULONG           iidxsegT;
 
     DIRFLAG fDIRFlags = fDIRNull;
@@ -1228,7 +1229,7 @@ LOCAL ERR ErrRECIInsert(
 
     pfcbTable->LeaveDML();
 
-    Alloc( pbKey = (BYTE *)RESKEY.PvRESAlloc() );
+    Alloc( pbKey = (BYTE *)arenascope.PvAlloc( cbKeyAlloc ) );
     keyToAdd.prefix.Nullify();
     keyToAdd.suffix.SetPv( pbKey );
 
@@ -1374,15 +1375,11 @@ LOCAL ERR ErrRECIInsert(
 
     AssertDIRNoLatch( ppib );
 
-    RESKEY.Free( pbKey );
-
     return err;
 
 HandleError:
     Assert( err < 0 );
 
-    RESKEY.Free( pbKey );
-
     if ( fUpdatingLatchSet )
     {
         Assert( pfcbTable != pfcbNil );
@@ -1891,6 +1888,7 @@ LOCAL ERR ErrRECFIndexChanged( FUCB *pfucb, FCB *pfcbIdx, BOOL *pfChanged )
     ULONG   iidxsegT;
     BOOL    fCopyBufferKeyIsPresentInIndex  = fFalse;
     BOOL    fRecordKeyIsPresentInIndex      = fFalse;
+    CArena::CScope  arenascope( pfucb->ppib->Parena() );
 
     Assert( pfucb );
     Assert( !Pcsr( pfucb )->FLatched( ) );
@@ -1901,11 +1899,11 @@ LOCAL ERR ErrRECFIndexChanged( FUCB *pfucb, FCB *pfcbIdx, BOOL *pfChanged )
 
     Assert( !pfcbIdx->Pidb()->FTuples() );
 
-    Alloc( pbNewKey = (BYTE *)RESKEY.PvRESAlloc() );
+    Alloc( pbNewKey = (BYTE *)arenascope.PvAlloc( cbKeyAlloc ) );
     keyNew.prefix.Nullify();
     keyNew.suffix.SetCb( cbKeyAlloc );
     keyNew.suffix.SetPv( pbNewKey );
-    CallR( ErrRECRetrieveKeyFromCopyBuffer(
+    Call( ErrRECRetrieveKeyFromCopyBuffer(
         pfucb,
         pfcbIdx->Pidb(),
         &keyNew,
@@ -1920,7 +1918,7 @@ LOCAL ERR ErrRECFIndexChanged( FUCB *pfucb, FCB *pfcbIdx, BOOL *pfChanged )
     fCopyBufferKeyIsPresentInIndex = ( wrnFLDNotPresentInIndex != err );
 
 
-    Alloc( pbOldKey = (BYTE *)RESKEY.PvRESAlloc() );
+    Alloc( pbOldKey = (BYTE *)arenascope.PvAlloc( cbKeyAlloc ) );
     keyOld.prefix.Nullify();
     keyOld.suffix.SetCb( cbKeyAlloc );
     keyOld.suffix.SetPv( pbOldKey );
@@ -1962,9 +1960,6 @@ LOCAL ERR ErrRECFIndexChanged( FUCB *pfucb, FCB *pfcbIdx, BOOL *pfChanged )
     err = JET_errSuccess;
 
 HandleError:
-    RESKEY.Free( pbNewKey );
-    RESKEY.Free( pbOldKey );
-
     Assert( !Pcsr( pfucb )->FLatched() );
     return err;
 }
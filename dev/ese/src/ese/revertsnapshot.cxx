@@ -6,6 +6,31 @@
 
 const RBS_POS rbsposMin = { 0x0,  0x0 };
 
+#ifdef PERFMON_SUPPORT
+
+PERFInstanceLiveTotal<> cRBSPreimagesCaptured;
+LONG LRBSPreimagesCapturedCEFLPv( LONG iInstance, VOID *pvBuf )
+{
+    cRBSPreimagesCaptured.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceLiveTotal<QWORD> cRBSPreimageCaptureTotalDhrts;
+LONG LRBSPreimageCaptureTotalDhrtsCEFLPv( LONG iInstance, VOID *pvBuf )
+{
+    cRBSPreimageCaptureTotalDhrts.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceLiveTotal<> cRBSStageFullDrains;
+LONG LRBSStageFullDrainsCEFLPv( LONG iInstance, VOID *pvBuf )
+{
+    cRBSStageFullDrains.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+#endif
+
 ERR ErrBeginDatabaseIncReseedTracing( _In_ IFileSystemAPI* pfsapi, _In_ JET_PCWSTR wszDatabase, _Out_ CPRINTF** ppcprintf );
 ERR ErrDBFormatFeatureEnabled_( const JET_ENGINEFORMATVERSION efvFormatFeature, const DbVersion& dbvCurrentFromFile );
 VOID TraceFuncBegun( CPRINTF* const pcprintf, const CHAR* const szFunction );
@@ -25,6 +50,20 @@ JETUNITTEST( CmpRbspos, Test )
     CHECK( CmpRbspos( pos1, pos4 ) < 0 );
     CHECK( CmpRbspos( pos4, pos1 ) > 0 );
 }
+
+JETUNITTEST( RBSStagedRec, Bounds )
+{
+    const ULONG cbContinuation = cbRBSSegmentSize - sizeof( RBSSEGHDR ) - sizeof( RBSFragContinue );
+
+    CHECK( CbRBSStagedEntry( 1 ) == 2 * sizeof( RBSSTAGEDREC ) );
+    CHECK( CbRBSStagedEntry( sizeof( RBSSTAGEDREC ) ) == 2 * sizeof( RBSSTAGEDREC ) );
+    CHECK( CbRBSStagedEntry( sizeof( RBSSTAGEDREC ) + 1 ) == 3 * sizeof( RBSSTAGEDREC ) );
+
+    CHECK( CsegRBSStagedRecordMax( 1 ) == 1 );
+    CHECK( CsegRBSStagedRecordMax( cbContinuation ) == 1 );
+    CHECK( CsegRBSStagedRecordMax( cbContinuation + 1 ) == 2 );
+    CHECK( CsegRBSStagedRecordMax( 4 * cbContinuation ) == 4 );
+}
 #endif
 
 LOCAL ERR ErrAllocAndSetStr( __in PCWSTR wszName, __out WCHAR** pwszResult )
@@ -855,6 +894,7 @@ ERR CRevertSnapshot::ErrRBSCreateOrLoadRbsGen(
     {
         m_pActiveBuffer->Reset( m_cNextActiveSegment );
     }
+    ResetStagedPositions();
 
     Call( ErrOSStrCbCopyW( wszRBSAbsLogDirPath, cbOSFSAPI_MAX_PATHW, wszRBSAbsLogPath ) );
 
@@ -992,7 +1032,9 @@ CRevertSnapshot::CRevertSnapshot( __in INST* const pinst )
     m_pinst ( pinst ),
     m_cresRBSBuf( pinst ),
     m_critBufferLock( CLockBasicInfo( CSyncBasicInfo( szRBSBuf ), rankRBSBuf, 0 ) ),
-    m_critWriteLock( CLockBasicInfo( CSyncBasicInfo( szRBSWrite ), rankRBSWrite, 0 ) )
+    m_critWriteLock( CLockBasicInfo( CSyncBasicInfo( szRBSWrite ), rankRBSWrite, 0 ) ),
+    m_critStageLock( CLockBasicInfo( CSyncBasicInfo( szRBSStage ), rankRBSStage, 0 ) ),
+    m_critStageDrain( CLockBasicInfo( CSyncBasicInfo( szRBSStageDrain ), rankRBSStageDrain, 0 ) )
 {
     Assert( pinst );
 }
@@ -1014,6 +1056,12 @@ CRevertSnapshot::~CRevertSnapshot( )
     m_pBuffersToWrite = NULL;
     m_pBuffersToWriteLast = NULL;
 
+    if ( m_pbStage != NULL )
+    {
+        OSMemoryPageFree( m_pbStage );
+        m_pbStage = NULL;
+    }
+
     m_cresRBSBuf.Term();
 
     delete m_pReadBuffer;
@@ -1187,6 +1235,11 @@ ERR CRevertSnapshot::ErrRBSInit( BOOL fRBSCreateIfRequired )
     Alloc( m_pActiveBuffer = new (&m_cresRBSBuf) CSnapshotBuffer( m_cNextActiveSegment, &m_cresRBSBuf ) );
     Call( m_pActiveBuffer->ErrAllocBuffer() );
 
+    if ( m_pbStage == NULL )
+    {
+        Alloc( m_pbStage = (BYTE *)PvOSMemoryPageAlloc( cbRBSStageBufferSize, NULL ) );
+    }
+
     CSnapshotBuffer::PreAllocReserveBuffer();
 
     m_fInitialized = fTrue;
@@ -1804,29 +1857,26 @@ ERR CRevertSnapshot::ErrCapturePreimage(
     Assert( m_fInitialized );
     Assert( !m_fInvalid );
 
-    ERR err = JET_errSuccess;
-    BYTE *pbDataDehydrated = NULL, *pbDataCompressed = NULL;
+    ERR err;
+    const HRT hrtStart = HrtHRTCount();
     RBSDbPageRecord dbRec;
-    ULONG fFlags;
     DATA dataRec;
     dataRec.SetPv( (VOID *)pbImage );
     dataRec.SetCb( cbImage );
 
-    Alloc( pbDataDehydrated = PbPKAllocCompressionBuffer() );
-    Alloc( pbDataCompressed = PbPKAllocCompressionBuffer() );
-    RBSICompressPreImage( m_pinst, m_pinst->m_mpdbidifmp[ dbid ], pgno, g_cbPage, dataRec, pbDataDehydrated, pbDataCompressed, &fFlags );
-
     dbRec.m_bRecType = rbsrectypeDbPage;
     dbRec.m_usRecLength = sizeof( RBSDbPageRecord ) + dataRec.Cb();
     dbRec.m_dbid = dbid;
     dbRec.m_pgno = pgno;
-    dbRec.m_fFlags = fFlags;
+    dbRec.m_fFlags = 0;
 
-    err = ErrCaptureRec( &dbRec, &dataRec, prbsposRecord );
+    err = ErrCaptureRec( m_pinst->m_mpdbidifmp[ dbid ], &dbRec, &dataRec, prbsposRecord );
 
-HandleError:
-    PKFreeCompressionBuffer( pbDataDehydrated );
-    PKFreeCompressionBuffer( pbDataCompressed );
+    if ( err >= JET_errSuccess )
+    {
+        PERFOpt( cRBSPreimagesCaptured.Inc( m_pinst ) );
+        PERFOpt( cRBSPreimageCaptureTotalDhrts.Add( m_pinst, HrtHRTCount() - hrtStart ) );
+    }
 
     return err;
 }
@@ -1848,7 +1898,7 @@ ERR CRevertSnapshot::ErrCaptureNewPage(
     dbRec.m_dbid = dbid;
     dbRec.m_pgno = pgno;
 
-    return ErrCaptureRec( &dbRec, &dataDummy, prbsposRecord );
+    return ErrCaptureRec( m_pinst->m_mpdbidifmp[ dbid ], &dbRec, &dataDummy, prbsposRecord );
 }
 
 ERR CRevertSnapshot::ErrCaptureDbHeader( FMP * const pfmp )
@@ -1863,7 +1913,7 @@ ERR CRevertSnapshot::ErrCaptureDbHeader( FMP * const pfmp )
     dataRec.SetPv( (VOID *)pfmp->Pdbfilehdr().get() );
     dataRec.SetCb( sizeof( DBFILEHDR ) );
 
-    return ErrCaptureRec( &dbRec, &dataRec, &dummy );
+    return ErrCaptureRec( pfmp->Ifmp(), &dbRec, &dataRec, &dummy );
 }
 
 ERR CRevertSnapshot::ErrCaptureDbAttach( FMP * const pfmp )
@@ -1879,7 +1929,7 @@ ERR CRevertSnapshot::ErrCaptureDbAttach( FMP * const pfmp )
     dbRec.m_dbid = pfmp->Dbid();
     dbRec.m_usRecLength = sizeof( RBSDbAttachRecord ) + dataRec.Cb();
 
-    return ErrCaptureRec( &dbRec, &dataRec, &dummy );
+    return ErrCaptureRec( pfmp->Ifmp(), &dbRec, &dataRec, &dummy );
 }
 
 ERR CRevertSnapshot::ErrQueueCurrentAndAllocBuffer()
@@ -1928,9 +1978,232 @@ ERR CRevertSnapshot::ErrQueueCurrentAndAllocBuffer()
 }
 
 ERR CRevertSnapshot::ErrCaptureRec(
+        const IFMP        ifmp,
         const RBSRecord * pRec,
         const DATA      * pExtraData,
               RBS_POS   * prbsposRecord )
+{
+    ERR err             = JET_errSuccess;
+    const USHORT cbRec  = CbRBSRecFixed( pRec->m_bRecType );
+    const ULONG cbEntry = CbRBSStagedEntry( cbRec + pExtraData->Cb() );
+    BOOL fPostDrain     = fFalse;
+
+    Assert( FInitialized() );
+    Assert( pRec->m_usRecLength == cbRec + pExtraData->Cb() );
+    Assert( cbEntry <= cbRBSStageBufferSize / 2 );
+
+    while ( fTrue )
+    {
+        {
+        ENTERCRITICALSECTION critStage( &m_critStageLock );
+
+        Call( m_errStage );
+
+        ULONG ibEntry   = m_ibStageTail;
+        ULONG cbPad     = 0;
+        if ( ibEntry + cbEntry > cbRBSStageBufferSize )
+        {
+            cbPad = cbRBSStageBufferSize - ibEntry;
+            ibEntry = 0;
+        }
+
+        if ( m_cbStaged + cbPad + cbEntry <= cbRBSStageBufferSize )
+        {
+            const LONG isegBound = m_isegStagedBound + 1 + CsegRBSStagedRecordMax( cbRec + pExtraData->Cb() );
+            if ( isegBound > cRBSSegmentMax )
+            {
+                Error( ErrERRCheck( JET_errOutOfRBSSpace ) );
+            }
+
+            if ( cbPad > 0 )
+            {
+                RBSSTAGEDREC * const ppad = (RBSSTAGEDREC *)( m_pbStage + m_ibStageTail );
+                memset( ppad, 0, sizeof( RBSSTAGEDREC ) );
+                ppad->cbEntry = cbPad;
+            }
+
+            RBSSTAGEDREC * const pstaged = (RBSSTAGEDREC *)( m_pbStage + ibEntry );
+            pstaged->cbEntry    = cbEntry;
+            pstaged->isegBound  = isegBound;
+            pstaged->ifmp       = ifmp;
+            pstaged->cbRec      = cbRec;
+            pstaged->cbData     = (USHORT)pExtraData->Cb();
+            UtilMemCpy( (BYTE *)( pstaged + 1 ), pRec, cbRec );
+            UtilMemCpy( (BYTE *)( pstaged + 1 ) + cbRec, pExtraData->Pv(), pExtraData->Cb() );
+
+            m_ibStageTail = ( ibEntry + cbEntry ) % cbRBSStageBufferSize;
+            m_cbStaged += cbPad + cbEntry;
+            m_isegStagedBound = isegBound;
+
+            prbsposRecord->lGeneration = m_prbsfilehdrCurrent->rbsfilehdr.le_lGeneration;
+            prbsposRecord->iSegment = isegBound;
+
+            if ( !m_fStageDrainInProgress )
+            {
+                m_fStageDrainInProgress = fTrue;
+                fPostDrain = fTrue;
+            }
+            break;
+        }
+        }
+
+        Call( ErrDrainStaged() );
+        PERFOpt( cRBSStageFullDrains.Inc( m_pinst ) );
+    }
+
+    if ( fPostDrain && m_pinst->Taskmgr().ErrTMPost( DrainStaged_, this ) < JET_errSuccess )
+    {
+        Call( ErrDrainStaged() );
+    }
+
+HandleError:
+    return err;
+}
+
+DWORD CRevertSnapshot::DrainStaged_( VOID *pvThis )
+{
+    CRevertSnapshot *pSnapshot = (CRevertSnapshot *)pvThis;
+    (VOID)pSnapshot->ErrDrainStaged();
+    return 0;
+}
+
+ERR CRevertSnapshot::ErrDrainStaged()
+{
+    ERR err = JET_errSuccess;
+    BYTE *pbDataDehydrated = NULL, *pbDataCompressed = NULL;
+
+    Alloc( pbDataDehydrated = PbPKAllocCompressionBuffer() );
+    Alloc( pbDataCompressed = PbPKAllocCompressionBuffer() );
+
+    {
+    ENTERCRITICALSECTION critDrain( &m_critStageDrain );
+
+    while ( fTrue )
+    {
+        RBSSTAGEDREC *pstaged;
+
+        {
+        ENTERCRITICALSECTION critStage( &m_critStageLock );
+        Call( m_errStage );
+        if ( m_cbStaged == 0 )
+        {
+            m_fStageDrainInProgress = fFalse;
+            break;
+        }
+        pstaged = (RBSSTAGEDREC *)( m_pbStage + m_ibStageHead );
+        if ( pstaged->cbRec == 0 )
+        {
+            Assert( m_ibStageHead + pstaged->cbEntry == cbRBSStageBufferSize );
+            m_ibStageHead = 0;
+            m_cbStaged -= pstaged->cbEntry;
+            continue;
+        }
+        }
+
+        err = ErrAppendStaged( pstaged, pbDataDehydrated, pbDataCompressed );
+
+        ENTERCRITICALSECTION critStage( &m_critStageLock );
+        if ( err < JET_errSuccess )
+        {
+            m_errStage = err;
+            Call( err );
+        }
+        m_ibStageHead = ( m_ibStageHead + pstaged->cbEntry ) % cbRBSStageBufferSize;
+        m_cbStaged -= pstaged->cbEntry;
+    }
+    }
+
+HandleError:
+    if ( err < JET_errSuccess )
+    {
+        //  let a later capture post another drain rather than leave the staged records stranded
+        ENTERCRITICALSECTION critStage( &m_critStageLock );
+        m_fStageDrainInProgress = fFalse;
+    }
+
+    PKFreeCompressionBuffer( pbDataDehydrated );
+    PKFreeCompressionBuffer( pbDataCompressed );
+    return err;
+}
+
+ERR CRevertSnapshot::ErrAppendStaged( RBSSTAGEDREC * const pstaged, BYTE * const pbDataDehydrated, BYTE * const pbDataCompressed )
+{
+    Assert( m_critStageDrain.FOwner() );
+
+    RBSRecord * const prec = (RBSRecord *)( pstaged + 1 );
+    DATA dataRec;
+    dataRec.SetPv( (BYTE *)prec + pstaged->cbRec );
+    dataRec.SetCb( pstaged->cbData );
+
+    if ( prec->m_bRecType == rbsrectypeDbPage )
+    {
+        RBSDbPageRecord * const pdbRec = (RBSDbPageRecord *)prec;
+        ULONG fFlags;
+        RBSICompressPreImage( m_pinst, pstaged->ifmp, pdbRec->m_pgno, g_cbPage, dataRec, pbDataDehydrated, pbDataCompressed, &fFlags );
+        pdbRec->m_usRecLength = sizeof( RBSDbPageRecord ) + dataRec.Cb();
+        pdbRec->m_fFlags = fFlags;
+    }
+
+    return ErrAppendRec( prec, &dataRec, pstaged->isegBound );
+}
+
+VOID CRevertSnapshot::ResetStagedPositions()
+{
+    Assert( m_cbStaged == 0 );
+
+    m_isegStagedBound = (LONG)m_cNextActiveSegment - 1;
+    m_isegStagedDurable = (LONG)m_cNextFlushSegment - 1;
+    m_istagedposFirst = 0;
+    m_cstagedpos = 0;
+}
+
+VOID CRevertSnapshot::AddStagedPosition( const LONG isegActual, const LONG isegBound )
+{
+    Assert( m_critBufferLock.FOwner() );
+    Assert( isegActual <= isegBound );
+
+    if ( m_cstagedpos > 0 )
+    {
+        RBSSTAGEDPOS * const pposLast = &m_rgstagedpos[ ( m_istagedposFirst + m_cstagedpos - 1 ) % cRBSStagedPosMax ];
+        Assert( pposLast->isegActual <= isegActual );
+        Assert( pposLast->isegBound < isegBound );
+
+        //  coalescing into the last entry only delays publishing the earlier bound, never advances it
+
+        if ( pposLast->isegActual == isegActual || m_cstagedpos == cRBSStagedPosMax )
+        {
+            pposLast->isegActual = isegActual;
+            pposLast->isegBound = isegBound;
+            return;
+        }
+    }
+
+    RBSSTAGEDPOS * const pposNew = &m_rgstagedpos[ ( m_istagedposFirst + m_cstagedpos ) % cRBSStagedPosMax ];
+    pposNew->isegActual = isegActual;
+    pposNew->isegBound = isegBound;
+    m_cstagedpos++;
+}
+
+VOID CRevertSnapshot::PublishStagedPositions()
+{
+    Assert( m_critBufferLock.FOwner() );
+
+    const LONG isegFlushed = (LONG)m_cNextFlushSegment - 1;
+    while ( m_cstagedpos > 0 && m_rgstagedpos[ m_istagedposFirst ].isegActual <= isegFlushed )
+    {
+        if ( m_rgstagedpos[ m_istagedposFirst ].isegBound > m_isegStagedDurable )
+        {
+            AtomicExchange( (LONG *)&m_isegStagedDurable, m_rgstagedpos[ m_istagedposFirst ].isegBound );
+        }
+        m_istagedposFirst = ( m_istagedposFirst + 1 ) % cRBSStagedPosMax;
+        m_cstagedpos--;
+    }
+}
+
+ERR CRevertSnapshot::ErrAppendRec(
+        const RBSRecord * pRec,
+        const DATA      * pExtraData,
+        const LONG        isegBound )
 {
     ERR err;
 
@@ -2029,8 +2302,7 @@ ERR CRevertSnapshot::ErrCaptureRec(
 
         if ( cbRemaining == 0 )
         {
-            prbsposRecord->lGeneration = m_prbsfilehdrCurrent->rbsfilehdr.le_lGeneration;
-            prbsposRecord->iSegment = m_pActiveBuffer->m_cStartSegment + CsegRBSCountSegmentOfOffset( m_pActiveBuffer->m_ibNextRecord + cbSegmentSpaceRemaining ) - 1;
+            AddStagedPosition( m_pActiveBuffer->m_cStartSegment + CsegRBSCountSegmentOfOffset( m_pActiveBuffer->m_ibNextRecord + cbSegmentSpaceRemaining ) - 1, isegBound );
         }
 
         if ( cbSegmentSpaceRemaining < sizeof( RBSFragBegin ) )
@@ -2391,6 +2663,11 @@ ERR CRevertSnapshot::ErrFlush()
 
         m_cNextFlushSegment = cNextWriteSegment;
         m_tickLastFlush = TickOSTimeCurrent();
+
+        {
+        ENTERCRITICALSECTION critBuf( &m_critBufferLock );
+        PublishStagedPositions();
+        }
         OSTrace( JET_tracetagRBS, OSFormat("RBS flush position:%u,%u\n", (LONG)m_prbsfilehdrCurrent->rbsfilehdr.le_lGeneration, m_cNextFlushSegment ) );
     }
 
@@ -2404,6 +2681,8 @@ ERR CRevertSnapshot::ErrFlushAll()
     Assert( m_fInitialized );
     Assert( !m_fInvalid );
 
+    Call( ErrDrainStaged() );
+
     if ( m_pActiveBuffer != NULL )
     {
         ENTERCRITICALSECTION critBuf( &m_critBufferLock );
@@ -2536,6 +2815,10 @@ ERR CRevertSnapshot::ErrRollSnapshot( BOOL fPrevRBSValid, BOOL fInferFromRstmap
     {
         Call( ErrFlushAll() );
     }
+    else
+    {
+        Call( ErrDrainStaged() );
+    }
 
     Alloc( m_prbsfilehdrCurrent = (RBSFILEHDR *)PvOSMemoryPageAlloc( sizeof(RBSFILEHDR), NULL ) );
 
@@ -3026,6 +3309,16 @@ CRBSDatabaseRevertContext::~CRBSDatabaseRevertContext()
         m_psbmDbPages = NULL;
     }
 
+    if ( m_rgpsbmGenPages )
+    {
+        for ( LONG igen = 0; igen < m_cGenPages; ++igen )
+        {
+            delete m_rgpsbmGenPages[ igen ];
+        }
+        delete[] m_rgpsbmGenPages;
+        m_rgpsbmGenPages = NULL;
+    }
+
     if ( m_pfm )
     {
         delete m_pfm;
@@ -3248,6 +3541,62 @@ BOOL CRBSDatabaseRevertContext::FPageAlreadyCaptured( PGNO pgno )
     return fPageAlreadyCaptured;
 }
 
+ERR CRBSDatabaseRevertContext::ErrInitGenPages( LONG lGenMin, LONG cGen )
+{
+    Assert( m_rgpsbmGenPages == NULL );
+    Assert( cGen > 0 );
+
+    ERR err = JET_errSuccess;
+
+    Alloc( m_rgpsbmGenPages = new IBitmapAPI*[ cGen ] );
+    memset( m_rgpsbmGenPages, 0, cGen * sizeof( IBitmapAPI* ) );
+    m_lGenPagesMin  = lGenMin;
+    m_cGenPages     = cGen;
+
+    for ( LONG igen = 0; igen < cGen; ++igen )
+    {
+        Alloc( m_rgpsbmGenPages[ igen ] = new CSparseBitmap() );
+
+        if ( m_rgpsbmGenPages[ igen ]->ErrInitBitmap( pgnoSysMax ) != IBitmapAPI::ERR::errSuccess )
+        {
+            Error( ErrERRCheck( JET_errOutOfMemory ) );
+        }
+    }
+
+HandleError:
+    return err;
+}
+
+VOID CRBSDatabaseRevertContext::SetGenPage( LONG lGen, PGNO pgno )
+{
+    Assert( m_rgpsbmGenPages );
+    Assert( lGen >= m_lGenPagesMin && lGen < m_lGenPagesMin + m_cGenPages );
+
+    //  a page we fail to record is just written twice, so out of memory is not fatal here
+
+    (VOID)m_rgpsbmGenPages[ lGen - m_lGenPagesMin ]->ErrSet( pgno, fTrue );
+}
+
+BOOL CRBSDatabaseRevertContext::FPageInOlderGen( PGNO pgno, LONG lGen )
+{
+    if ( m_rgpsbmGenPages == NULL )
+    {
+        return fFalse;
+    }
+
+    const LONG lGenLast = min( lGen, m_lGenPagesMin + m_cGenPages );
+    for ( LONG lGenT = m_lGenPagesMin; lGenT < lGenLast; ++lGenT )
+    {
+        BOOL fSet = fFalse;
+        if ( m_rgpsbmGenPages[ lGenT - m_lGenPagesMin ]->ErrGet( pgno, &fSet ) == IBitmapAPI::ERR::errSuccess && fSet )
+        {
+            return fTrue;
+        }
+    }
+
+    return fFalse;
+}
+
 ERR CRBSDatabaseRevertContext::ErrAddPage( void* pvPage, PGNO pgno )
 {
     Assert( pvPage );
@@ -4014,6 +4363,23 @@ BOOL CRBSRevertContext::FPageAlreadyCaptured( DBID dbid, PGNO pgno )
     return m_rgprbsdbrcAttached[ m_mpdbidirbsdbrc[ dbid ] ]->FPageAlreadyCaptured( pgno );
 }
 
+BOOL CRBSRevertContext::FPageInOlderGen( DBID dbid, PGNO pgno )
+{
+    Assert( m_mpdbidirbsdbrc[ dbid ] != irbsdbrcInvalid );
+    Assert( m_mpdbidirbsdbrc[ dbid ] <= m_irbsdbrcMaxInUse );
+
+    //  generations are applied newest first, so an image that an older generation also holds
+    //  would only be overwritten later; skip it and let the oldest image be the only write
+
+    if ( m_rgprbsdbrcAttached[ m_mpdbidirbsdbrc[ dbid ] ]->FPageInOlderGen( pgno, m_lRBSGenApplying ) )
+    {
+        m_cPagesSkippedCurRBSGen++;
+        return fTrue;
+    }
+
+    return fFalse;
+}
+
 ERR CRBSRevertContext::ErrApplyRBSRecord( RBSRecord* prbsrec, BOOL fCaptureDbHdrFromRBS, BOOL fDbHeaderOnly, BOOL* pfGivenDbfilehdrCaptured )
 {
     BYTE                bRecType        = prbsrec->m_bRecType;
@@ -4110,7 +4476,8 @@ ERR CRBSRevertContext::ErrApplyRBSRecord( RBSRecord* prbsrec, BOOL fCaptureDbHdr
             dataImage.SetPv( prbsdbpgrec->m_rgbData );
             dataImage.SetCb( prbsdbpgrec->m_usRecLength - sizeof(RBSDbPageRecord) );
             
-            if ( !FPageAlreadyCaptured( prbsdbpgrec->m_dbid, prbsdbpgrec->m_pgno ) )
+            if ( !FPageAlreadyCaptured( prbsdbpgrec->m_dbid, prbsdbpgrec->m_pgno ) &&
+                 !FPageInOlderGen( prbsdbpgrec->m_dbid, prbsdbpgrec->m_pgno ) )
             {
                 pvPage = PvOSMemoryPageAlloc( m_cbDbPageSize, NULL );
                 Alloc( pvPage );
@@ -4146,7 +4513,8 @@ ERR CRBSRevertContext::ErrApplyRBSRecord( RBSRecord* prbsrec, BOOL fCaptureDbHdr
 
             RBSDbNewPageRecord* prbsdbnewpgrec = ( RBSDbNewPageRecord* ) prbsrec;
 
-            if ( !FPageAlreadyCaptured( prbsdbnewpgrec->m_dbid, prbsdbnewpgrec->m_pgno ) )
+            if ( !FPageAlreadyCaptured( prbsdbnewpgrec->m_dbid, prbsdbnewpgrec->m_pgno ) &&
+                 !FPageInOlderGen( prbsdbnewpgrec->m_dbid, prbsdbnewpgrec->m_pgno ) )
             {
                 pvPage = PvOSMemoryPageAlloc( m_cbDbPageSize, NULL );
                 Alloc( pvPage );
@@ -4212,6 +4580,10 @@ ERR CRBSRevertContext::ErrRBSGenApply( LONG lRBSGen, BOOL fDbHeaderOnly )
     Assert( m_irbsdbrcMaxInUse >= 0 );
 
     (*m_pcprintfRevertTrace)( "RBSGen - %ld, DbHeaderOnly - %ld.\r\n", lRBSGen, fDbHeaderOnly );
+
+    m_lRBSGenApplying           = lRBSGen;
+    m_cPagesSkippedCurRBSGen    = 0;
+
     Call( ErrRBSFilePathForGen_( m_wszRBSAbsRootDirPath, m_wszRBSBaseName, m_pinst->m_pfsapi, wszRBSAbsDirPath, sizeof( wszRBSAbsDirPath ), wszRBSAbsFilePath, cbOSFSAPI_MAX_PATHW, lRBSGen ) );
     Call( CIOFilePerf::ErrFileOpen( m_pinst->m_pfsapi, m_pinst, wszRBSAbsFilePath, IFileAPI::fmfReadOnly, iofileRBS, qwRBSFileID, &pfapirbs ) );
 
@@ -4270,6 +4642,8 @@ ERR CRBSRevertContext::ErrRBSGenApply( LONG lRBSGen, BOOL fDbHeaderOnly )
     {
         Call( ErrFlushPages( fTrue ) );
         err = JET_errSuccess;
+
+        (*m_pcprintfRevertTrace)( "RBSGen - %ld, pages skipped for older generations - %I64u.\r\n", lRBSGen, m_cPagesSkippedCurRBSGen );
     }
     
 HandleError:
@@ -4371,6 +4745,167 @@ HandleError:
     return err;
 }
 
+const INT cRBSRevertScanThreadsMax = 8;
+
+ERR CRBSRevertContext::ErrScanRBSGenPages( LONG lRBSGen )
+{
+    ERR                 err                 = JET_errSuccess;
+    WCHAR               wszRBSAbsDirPath[ IFileSystemAPI::cchPathMax ];
+    WCHAR               wszRBSAbsFilePath[ IFileSystemAPI::cchPathMax ];
+    WCHAR               wszErrorReason[ cbOSFSAPI_MAX_PATHW ];
+    RBS_POS             rbsposRecStart      = rbsposMin;
+    CRevertSnapshot*    prbs                = NULL;
+    IFileAPI*           pfapirbs            = NULL;
+    RBSRecord*          prbsRecord          = NULL;
+    IRBSDBRC            mpdbidirbsdbrc[ dbidMax ];
+
+    for ( DBID dbid = 0; dbid < dbidMax; ++dbid )
+    {
+        mpdbidirbsdbrc[ dbid ] = irbsdbrcInvalid;
+    }
+
+    Call( ErrRBSFilePathForGen_( m_wszRBSAbsRootDirPath, m_wszRBSBaseName, m_pinst->m_pfsapi, wszRBSAbsDirPath, sizeof( wszRBSAbsDirPath ), wszRBSAbsFilePath, cbOSFSAPI_MAX_PATHW, lRBSGen ) );
+    Call( CIOFilePerf::ErrFileOpen( m_pinst->m_pfsapi, m_pinst, wszRBSAbsFilePath, IFileAPI::fmfReadOnly, iofileRBS, qwRBSFileID, &pfapirbs ) );
+
+    Alloc( prbs = new CRevertSnapshot( m_pinst ) );
+    err = prbs->ErrSetRBSFileApi( pfapirbs );
+    pfapirbs = NULL;
+    Call( err );
+
+    //  this file's dbid mapping is rebuilt from its own attach records; page records for
+    //  a dbid not attached within the file are left unmarked, which only costs a rewrite
+
+    err = prbs->ErrGetNextRecord( &prbsRecord, &rbsposRecStart, wszErrorReason );
+
+    while ( err == JET_errSuccess && !m_fRevertCancelled )
+    {
+        switch ( prbsRecord->m_bRecType )
+        {
+            case rbsrectypeDbAttach:
+            {
+                RBSDbAttachRecord* prbsdbatchrec    = ( RBSDbAttachRecord* ) prbsRecord;
+                IRBSDBRC irbsdbrc                   = irbsdbrcInvalid;
+                CAutoWSZPATH wszDbName;
+                Call( wszDbName.ErrSet( prbsdbatchrec->m_wszDbName ) );
+
+                if ( FRBSDBRC( wszDbName, &irbsdbrc ) )
+                {
+                    for ( DBID dbid = 0; dbid < dbidMax; ++dbid )
+                    {
+                        if ( mpdbidirbsdbrc[ dbid ] == irbsdbrc )
+                        {
+                            mpdbidirbsdbrc[ dbid ] = irbsdbrcInvalid;
+                        }
+                    }
+                }
+                if ( prbsdbatchrec->m_dbid < dbidMax )
+                {
+                    mpdbidirbsdbrc[ prbsdbatchrec->m_dbid ] = irbsdbrc;
+                }
+                break;
+            }
+
+            case rbsrectypeDbPage:
+            {
+                RBSDbPageRecord* prbsdbpgrec = ( RBSDbPageRecord* ) prbsRecord;
+                if ( prbsdbpgrec->m_dbid < dbidMax && mpdbidirbsdbrc[ prbsdbpgrec->m_dbid ] != irbsdbrcInvalid )
+                {
+                    m_rgprbsdbrcAttached[ mpdbidirbsdbrc[ prbsdbpgrec->m_dbid ] ]->SetGenPage( lRBSGen, prbsdbpgrec->m_pgno );
+                }
+                break;
+            }
+
+            case rbsrectypeDbNewPage:
+            {
+                RBSDbNewPageRecord* prbsdbnewpgrec = ( RBSDbNewPageRecord* ) prbsRecord;
+                if ( prbsdbnewpgrec->m_dbid < dbidMax && mpdbidirbsdbrc[ prbsdbnewpgrec->m_dbid ] != irbsdbrcInvalid )
+                {
+                    m_rgprbsdbrcAttached[ mpdbidirbsdbrc[ prbsdbnewpgrec->m_dbid ] ]->SetGenPage( lRBSGen, prbsdbnewpgrec->m_pgno );
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        err = prbs->ErrGetNextRecord( &prbsRecord, &rbsposRecStart, wszErrorReason );
+    }
+
+    if ( err == JET_wrnNoMoreRecords )
+    {
+        err = JET_errSuccess;
+    }
+
+HandleError:
+    delete prbs;
+    delete pfapirbs;
+    return err;
+}
+
+DWORD CRBSRevertContext::DwScanRBSGensThreadProc( DWORD_PTR dwContext )
+{
+    CRBSRevertContext* const prbsrc = (CRBSRevertContext*) dwContext;
+    LONG lRBSGen;
+
+    while ( !prbsrc->m_fRevertCancelled &&
+            ( lRBSGen = AtomicIncrement( (LONG*) &prbsrc->m_lRBSGenNextToScan ) - 1 ) < prbsrc->m_lRBSMaxGenToApply )
+    {
+        //  a generation that fails to scan keeps whatever it recorded, which is still a subset
+        //  of its pages; the apply pass will report the failure itself
+
+        (VOID)prbsrc->ErrScanRBSGenPages( lRBSGen );
+    }
+
+    return 0;
+}
+
+ERR CRBSRevertContext::ErrScanRBSGens()
+{
+    ERR         err                                 = JET_errSuccess;
+    THREAD      rgthread[ cRBSRevertScanThreadsMax ] = { NULL };
+    INT         cthread                             = 0;
+    const LONG  cGenOlder                           = m_lRBSMaxGenToApply - m_lRBSMinGenToApply;
+    const INT   cthreadMax                          = min( min( (INT)cGenOlder, cRBSRevertScanThreadsMax ), (INT)CUtilProcessProcessor() );
+
+    //  only generations older than the one being applied are consulted, so the newest is never scanned
+
+    if ( cGenOlder <= 0 )
+    {
+        return JET_errSuccess;
+    }
+
+    for ( IRBSDBRC irbsdbrc = 0; irbsdbrc <= m_irbsdbrcMaxInUse; ++irbsdbrc )
+    {
+        Call( m_rgprbsdbrcAttached[ irbsdbrc ]->ErrInitGenPages( m_lRBSMinGenToApply, cGenOlder ) );
+    }
+
+    m_lRBSGenNextToScan = m_lRBSMinGenToApply;
+
+    for ( ; cthread < cthreadMax; ++cthread )
+    {
+        if ( ErrUtilThreadCreate( DwScanRBSGensThreadProc, 0, priorityNormal, &rgthread[ cthread ], (DWORD_PTR)this ) < JET_errSuccess )
+        {
+            break;
+        }
+    }
+
+    if ( cthread == 0 )
+    {
+        (VOID)DwScanRBSGensThreadProc( (DWORD_PTR)this );
+    }
+
+    for ( INT ithread = 0; ithread < cthread; ++ithread )
+    {
+        UtilThreadEnd( rgthread[ ithread ] );
+    }
+
+    (*m_pcprintfRevertTrace)( "Scanned %ld older RBS generations with %d threads.\r\n", cGenOlder, cthread );
+
+HandleError:
+    return err;
+}
+
 ERR CRBSRevertContext::ErrExecuteRevert( JET_GRBIT grbit, JET_RBSREVERTINFOMISC*  prbsrevertinfo )
 {
     Assert( m_lRBSMaxGenToApply > 0 );
@@ -4407,6 +4942,8 @@ ERR CRBSRevertContext::ErrExecuteRevert( JET_GRBIT grbit, JET_RBSREVERTINFOMISC*
             Call( m_rgprbsdbrcAttached[ irbsdbrc ]->ErrSetDbstateForRevert( m_prbsrchk->rbsrchkfilehdr.le_rbsrevertstate, m_ltRevertTo ) );
         }
 
+        Call( ErrScanRBSGens() );
+
         for ( LONG lRBSGen = m_lRBSMaxGenToApply; lRBSGen >= m_lRBSMinGenToApply; --lRBSGen )
         {
             Call( ErrRBSGenApply( lRBSGen, fFalse ) );
@@ -5,6 +5,7 @@
 
 
 INLINE VOID SrecToKeydataflags( const SREC * psrec, FUCB * pfucb );
+INLINE VOID SORTIInsertInMemory( SCB * const pscb, const KEY& key, const DATA& data );
 LOCAL LONG IspairSORTISeekByKey(
     const BYTE * const rgbRec,
     const SPAIR * const rgspair,
@@ -24,6 +25,7 @@ INLINE VOID SWAPPsrec( SREC **ppsrec1, SREC **ppsrec2 );
 INLINE VOID SWAPPmtnode( MTNODE **ppmtnode1, MTNODE **ppmtnode2 );
 LOCAL VOID SORTIInsertionSort( SCB *pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn );
 LOCAL VOID SORTIQuicksort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn );
+LOCAL VOID SORTIRadixSort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn, INT ibPrefix = 0 );
 LOCAL ERR ErrSORTIRunStart( SCB *pscb, QWORD cb, RUNINFO *pruninfo );
 LOCAL ERR ErrSORTIRunInsert( SCB *pscb, RUNINFO* pruninfo, SREC *psrec );
 INLINE VOID SORTIRunEnd( SCB * pscb, RUNINFO* pruninfo );
@@ -31,6 +33,7 @@ INLINE VOID SORTIRunDelete( SCB * pscb, const RUNINFO * pruninfo );
 LOCAL VOID  SORTIRunDeleteList( SCB *pscb, RUNLINK **pprunlink, LONG crun );
 LOCAL VOID  SORTIRunDeleteListMem( SCB *pscb, RUNLINK **pprunlink, LONG crun );
 LOCAL ERR ErrSORTIRunOpen( SCB *pscb, RUNINFO *pruninfo, RCB **pprcb );
+INLINE LONG CclusterSORTIMergePreread( const LONG crunMerge );
 LOCAL ERR ErrSORTIRunNext( RCB * prcb, SREC **ppsrec );
 LOCAL VOID SORTIRunClose( RCB *prcb );
 INLINE ERR ErrSORTIRunReadPage( RCB *prcb, PGNO pgno, LONG ipbf );
@@ -107,6 +110,7 @@ ERR ErrSORTOpen( PIB *ppib, FUCB **ppfucb, const BOOL fRemoveDuplicateKey, const
         SCBSetRemoveDuplicateKeyData( pscb );
     }
     pscb->cRecords  = 0;
+    pscb->cbRecords = 0;
 
     
     Alloc( rgspair = ( SPAIR * )( PvOSMemoryPageAlloc( cbSortMemFastUsed, NULL ) ) );
@@ -152,9 +156,8 @@ HandleError:
 
 
 
-ERR ErrSORTInsert( FUCB *pfucb, const KEY& key, const DATA& data )
+INLINE VOID SORTIInsertInMemory( SCB * const pscb, const KEY& key, const DATA& data )
 {
-    SCB     * const pscb    = pfucb->u.pscb;
     LONG    cbKey;
     LONG    cbData;
     LONG    irec;
@@ -164,31 +167,10 @@ ERR ErrSORTInsert( FUCB *pfucb, const KEY& key, const DATA& data )
     BYTE    * pbSrcMac      = 0;
     BYTE    * pbDest        = 0;
     BYTE    * pbDestMic     = 0;
-    ERR     err             = JET_errSuccess;
-
-    Assert( key.Cb() <= cbKeyMostMost );
-    Assert( FSCBInsert( pscb ) );
-
-
-    Assert( pscb->crecBuf <= cspairSortMax );
-    Assert( (SIZE_T)pscb->irecMac <= irecSortMax );
-
 
     INT cbNormNeeded = CbSRECSizeCbCb( key.Cb(), data.Cb() );
     INT cirecNeeded = CirecToStoreCb( cbNormNeeded );
 
-
-    if (    pscb->irecMac * cbIndexGran + cbNormNeeded > cbSortMemNormUsed ||
-            pscb->crecBuf == cspairSortMax )
-    {
-
-        SORTIQuicksort( pscb, pscb->rgspair, pscb->rgspair + pscb->ispairMac );
-
-
-        Call( ErrSORTIOutputRun( pscb ) );
-    }
-
-
     irec = pscb->irecMac;
     psrec = PsrecFromPbIrec( pscb->rgbRec, irec );
     pscb->irecMac += cirecNeeded;
@@ -234,6 +216,39 @@ ERR ErrSORTInsert( FUCB *pfucb, const KEY& key, const DATA& data )
 
 
     pscb->cRecords++;
+    pscb->cbRecords += key.Cb() + data.Cb();
+}
+
+
+
+ERR ErrSORTInsert( FUCB *pfucb, const KEY& key, const DATA& data )
+{
+    SCB     * const pscb    = pfucb->u.pscb;
+    ERR     err             = JET_errSuccess;
+
+    Assert( key.Cb() <= cbKeyMostMost );
+    Assert( FSCBInsert( pscb ) );
+
+
+    Assert( pscb->crecBuf <= cspairSortMax );
+    Assert( (SIZE_T)pscb->irecMac <= irecSortMax );
+
+
+    const INT cbNormNeeded = CbSRECSizeCbCb( key.Cb(), data.Cb() );
+
+
+    if (    pscb->irecMac * cbIndexGran + cbNormNeeded > cbSortMemNormUsed ||
+            pscb->crecBuf == cspairSortMax )
+    {
+
+        SORTIRadixSort( pscb, pscb->rgspair, pscb->rgspair + pscb->ispairMac );
+
+
+        Call( ErrSORTIOutputRun( pscb ) );
+    }
+
+
+    SORTIInsertInMemory( pscb, key, data );
 
 
     Assert( pscb->crecBuf <= cspairSortMax );
@@ -263,7 +278,7 @@ ERR ErrSORTEndInsert( FUCB *pfucb )
         return JET_errSuccess;
 
 
-    SORTIQuicksort( pscb, pscb->rgspair, pscb->rgspair + pscb->ispairMac );
+    SORTIRadixSort( pscb, pscb->rgspair, pscb->rgspair + pscb->ispairMac );
 
 
     if ( pscb->crun )
@@ -304,6 +319,13 @@ HandleError:
 }
 
 
+QWORD CbSORTRecords( FUCB *pfucb )
+{
+    Assert( pfucb->u.pscb != pscbNil );
+    return pfucb->u.pscb->cbRecords;
+}
+
+
 ERR ErrSORTFirst( FUCB * pfucb )
 {
     SCB     * const pscb    = pfucb->u.pscb;
@@ -1236,6 +1258,92 @@ LOCAL VOID SORTIQuicksort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn )
 }
 
 
+LOCAL VOID SORTIRadixSort( SCB * pscb, SPAIR *pspairMinIn, SPAIR *pspairMaxIn, INT ibPrefix )
+{
+    USHORT  rgcspair[256];
+    USHORT  rgispairNext[256];
+
+    SPAIR   * const pspairMin   = pspairMinIn;
+    SPAIR   * const pspairMax   = pspairMaxIn;
+    const LONG      cspair      = LONG( pspairMax - pspairMin );
+    LONG            ispairStart;
+    INT             ib;
+
+    Assert( cspair >= 0 );
+    Assert( cspair <= cspairSortMax );
+
+
+    forever
+    {
+        if ( cspair < cspairRadixSortMin || ibPrefix >= cbKeyPrefix )
+        {
+            SORTIQuicksort( pscb, pspairMin, pspairMax );
+            return;
+        }
+
+
+        ib = cbKeyPrefix - 1 - ibPrefix;
+
+        memset( rgcspair, 0, sizeof( rgcspair ) );
+        for ( SPAIR * pspair = pspairMin; pspair < pspairMax; pspair++ )
+        {
+            rgcspair[pspair->rgbKey[ib]]++;
+        }
+
+        if ( rgcspair[pspairMin->rgbKey[ib]] != cspair )
+        {
+            break;
+        }
+
+        ibPrefix++;
+    }
+
+
+    ispairStart = 0;
+    for ( INT b = 0; b < 256; b++ )
+    {
+        rgispairNext[b] = USHORT( ispairStart );
+        ispairStart += rgcspair[b];
+    }
+    Assert( ispairStart == cspair );
+
+
+    ispairStart = 0;
+    for ( INT b = 0; b < 256; b++ )
+    {
+        const LONG ispairEnd = ispairStart + rgcspair[b];
+
+        while ( rgispairNext[b] < ispairEnd )
+        {
+            SPAIR * const pspair = pspairMin + rgispairNext[b];
+
+            for ( BYTE bT = pspair->rgbKey[ib]; bT != b; bT = pspair->rgbKey[ib] )
+            {
+                Assert( bT > b );
+                SWAPSpair( pspair, pspairMin + rgispairNext[bT]++ );
+            }
+            rgispairNext[b]++;
+        }
+
+        ispairStart = ispairEnd;
+    }
+
+
+    ispairStart = 0;
+    for ( INT b = 0; b < 256; b++ )
+    {
+        if ( rgcspair[b] > 1 )
+        {
+            SORTIRadixSort( pscb,
+                            pspairMin + ispairStart,
+                            pspairMin + ispairStart + rgcspair[b],
+                            ibPrefix + 1 );
+        }
+        ispairStart += rgcspair[b];
+    }
+}
+
+
 LOCAL ERR ErrSORTIRunStart( SCB *pscb, QWORD cb, RUNINFO *pruninfo )
 {
     ERR             err;
@@ -1445,6 +1553,14 @@ LOCAL VOID  SORTIRunDeleteListMem( SCB *pscb, RUNLINK **pprunlink, LONG crun )
 
 
 
+INLINE LONG CclusterSORTIMergePreread( const LONG crunMerge )
+{
+    //  a merge never reads more than crunFanInMax runs, clamping also keeps the product from overflowing
+
+    return max( 1, cpgMergePrereadMax / ( cpgClusterSize * min( crunFanInMax, max( 1, crunMerge ) ) ) );
+}
+
+
 LOCAL ERR ErrSORTIRunOpen( SCB *pscb, RUNINFO *pruninfo, RCB **pprcb )
 {
     ERR     err;
@@ -1472,7 +1588,8 @@ LOCAL ERR ErrSORTIRunOpen( SCB *pscb, RUNINFO *pruninfo, RCB **pprcb )
     prcb->pvAssy        = NULL;
 
 
-    cpgRead = min( prcb->runinfo.cpgUsed, 2 * cpgClusterSize );
+    prcb->cclusterPreread = CclusterSORTIMergePreread( pscb->crunMerge );
+    cpgRead = (CPG)min( (LONG)prcb->runinfo.cpgUsed, ( prcb->cclusterPreread + 1 ) * cpgClusterSize );
 
     {
         TraceContextScope tc( iortSort );
@@ -1616,7 +1733,7 @@ LOCAL ERR ErrSORTIRunNext( RCB * prcb, SREC **ppsrec )
         prcb->pbInMax   = PbDataEndPspage( pspage );
 
 
-        pgnoNext += cpgClusterSize;
+        pgnoNext += prcb->cclusterPreread * cpgClusterSize;
         cpgRead = min(  (LONG) ( prcb->runinfo.run + prcb->runinfo.cpgUsed - pgnoNext ),
                         cpgClusterSize );
         if ( cpgRead > 0 )
@@ -2290,3 +2407,212 @@ LOCAL VOID SORTIOptTreeFree( SCB *pscb, OTNODE *potnode )
     SORTIRunDeleteListMem( pscb, &potnode->runlist.prunlinkHead, crunAll );
 }
 
+
+#ifdef ENABLE_JET_UNIT_TEST
+
+JETUNITTEST( SORT, MergePrereadScalesInverselyWithFanIn )
+{
+    CHECK( cpgMergePrereadMax / cpgClusterSize == CclusterSORTIMergePreread( 0 ) );
+    CHECK( cpgMergePrereadMax / cpgClusterSize == CclusterSORTIMergePreread( 1 ) );
+    CHECK( cpgMergePrereadMax / ( 2 * cpgClusterSize ) == CclusterSORTIMergePreread( 2 ) );
+    CHECK( 2 == CclusterSORTIMergePreread( crunFanInMax ) );
+    CHECK( CclusterSORTIMergePreread( crunFanInMax ) == CclusterSORTIMergePreread( lMax ) );
+
+    for ( LONG crun = 1; crun <= crunFanInMax; crun++ )
+    {
+        const LONG cclusterPreread = CclusterSORTIMergePreread( crun );
+
+        CHECK( cclusterPreread >= 1 );
+        CHECK( cclusterPreread <= CclusterSORTIMergePreread( crun - 1 ) );
+        CHECK( crun * cclusterPreread * cpgClusterSize <= cpgMergePrereadMax );
+    }
+}
+
+
+//  only the record buffer and the SPAIR array of the SCB are used by the in-memory sorts, so the
+//  SCB here is never constructed as a real sort
+
+class CSortInMemoryTest
+{
+    public:
+        CSortInMemoryTest() :
+            m_pscb( NULL ),
+            m_rgspairIn( NULL ),
+            m_rgspairRadix( NULL ),
+            m_ulRandom( 0x2545F491 )
+        {
+        }
+
+        ~CSortInMemoryTest()
+        {
+            if ( m_pscb )
+            {
+                OSMemoryPageFree( m_pscb->rgbRec );
+                OSMemoryPageFree( m_pscb->rgspair );
+                OSMemoryHeapFree( m_pscb );
+            }
+            delete[] m_rgspairIn;
+            delete[] m_rgspairRadix;
+        }
+
+        ERR ErrInit()
+        {
+            ERR err = JET_errSuccess;
+
+            Alloc( m_pscb = (SCB *)PvOSMemoryHeapAlloc( sizeof( SCB ) ) );
+            memset( (void *)m_pscb, 0, sizeof( SCB ) );
+            Alloc( m_pscb->rgspair = (SPAIR *)PvOSMemoryPageAlloc( cbSortMemFastUsed, NULL ) );
+            Alloc( m_pscb->rgbRec = (BYTE *)PvOSMemoryPageAlloc( cbSortMemNormUsed, NULL ) );
+            Alloc( m_rgspairIn = new SPAIR[ cspairSortMax ] );
+            Alloc( m_rgspairRadix = new SPAIR[ cspairSortMax ] );
+
+        HandleError:
+            return err;
+        }
+
+        ULONG UlRandom()
+        {
+            m_ulRandom ^= m_ulRandom << 13;
+            m_ulRandom ^= m_ulRandom >> 17;
+            m_ulRandom ^= m_ulRandom << 5;
+            return m_ulRandom;
+        }
+
+        BOOL FAdd( const BYTE * const pbKey, const INT cbKey, const BYTE * const pbData, const INT cbData )
+        {
+            const INT cbNormNeeded = CbSRECSizeCbCb( cbKey, cbData );
+            if (    m_pscb->irecMac * cbIndexGran + cbNormNeeded > cbSortMemNormUsed ||
+                    m_pscb->crecBuf == cspairSortMax )
+            {
+                return fFalse;
+            }
+
+            KEY     key;
+            DATA    data;
+            key.prefix.Nullify();
+            key.suffix.SetPv( (VOID *)pbKey );
+            key.suffix.SetCb( cbKey );
+            data.SetPv( (VOID *)pbData );
+            data.SetCb( cbData );
+
+            SORTIInsertInMemory( m_pscb, key, data );
+            return fTrue;
+        }
+
+        //  radix sort and quicksort the same input and check that both produce the same, ordered, sequence
+
+        BOOL FRadixSortMatchesQuicksort()
+        {
+            const LONG  cspair  = m_pscb->ispairMac;
+            SPAIR * const rgspair = m_pscb->rgspair;
+
+            memcpy( m_rgspairIn, rgspair, cspair * sizeof( SPAIR ) );
+
+            SORTIRadixSort( m_pscb, rgspair, rgspair + cspair );
+            memcpy( m_rgspairRadix, rgspair, cspair * sizeof( SPAIR ) );
+
+            memcpy( rgspair, m_rgspairIn, cspair * sizeof( SPAIR ) );
+            SORTIQuicksort( m_pscb, rgspair, rgspair + cspair );
+
+            for ( LONG ispair = 0; ispair < cspair; ispair++ )
+            {
+                if ( 0 != ISORTICmpPspairPspair( m_pscb, m_rgspairRadix + ispair, rgspair + ispair ) )
+                {
+                    return fFalse;
+                }
+                if ( ispair > 0 && ISORTICmpPspairPspair( m_pscb, m_rgspairRadix + ispair - 1, m_rgspairRadix + ispair ) > 0 )
+                {
+                    return fFalse;
+                }
+            }
+
+            return fTrue;
+        }
+
+        LONG Cspair() const     { return m_pscb->ispairMac; }
+
+    private:
+        SCB *       m_pscb;
+        SPAIR *     m_rgspairIn;
+        SPAIR *     m_rgspairRadix;
+        ULONG       m_ulRandom;
+};
+
+JETUNITTEST( SORT, RadixSortDuplicateKeys )
+{
+    CSortInMemoryTest test;
+    CHECK( JET_errSuccess == test.ErrInit() );
+
+    for ( INT irec = 0; irec < 2000; irec++ )
+    {
+        const BYTE  rgbKey[]    = { 0x7F, BYTE( test.UlRandom() % 8 ), 0x01 };
+        const BYTE  rgbData[]   = { BYTE( test.UlRandom() % 4 ) };
+        CHECK( test.FAdd( rgbKey, sizeof( rgbKey ), rgbData, sizeof( rgbData ) ) );
+    }
+
+    CHECK( test.FRadixSortMatchesQuicksort() );
+}
+
+JETUNITTEST( SORT, RadixSortKeysOfDifferentLengths )
+{
+    CSortInMemoryTest test;
+    CHECK( JET_errSuccess == test.ErrInit() );
+
+    BYTE rgbKey[ 40 ];
+    for ( INT irec = 0; irec < 2000; irec++ )
+    {
+        const INT cbKey = 1 + INT( test.UlRandom() % _countof( rgbKey ) );
+        for ( INT ib = 0; ib < cbKey; ib++ )
+        {
+            rgbKey[ ib ] = BYTE( test.UlRandom() % 3 );
+        }
+        const BYTE rgbData[] = { BYTE( irec ), BYTE( irec >> 8 ) };
+        CHECK( test.FAdd( rgbKey, cbKey, rgbData, sizeof( rgbData ) ) );
+    }
+
+    CHECK( test.FRadixSortMatchesQuicksort() );
+}
+
+JETUNITTEST( SORT, RadixSortKeysSharingLongPrefixes )
+{
+    CSortInMemoryTest test;
+    CHECK( JET_errSuccess == test.ErrInit() );
+
+    BYTE rgbKey[ 48 ];
+    memset( rgbKey, 0x5A, sizeof( rgbKey ) );
+    for ( INT irec = 0; irec < 2000; irec++ )
+    {
+        const INT cbPrefix = cbKeyPrefix - 2 + INT( test.UlRandom() % 24 );
+        for ( INT ib = cbPrefix; ib < _countof( rgbKey ); ib++ )
+        {
+            rgbKey[ ib ] = BYTE( test.UlRandom() );
+        }
+        CHECK( test.FAdd( rgbKey, cbPrefix + 1 + INT( test.UlRandom() % ( _countof( rgbKey ) - cbPrefix ) ), NULL, 0 ) );
+        memset( rgbKey, 0x5A, sizeof( rgbKey ) );
+    }
+
+    CHECK( test.FRadixSortMatchesQuicksort() );
+}
+
+JETUNITTEST( SORT, RadixSortAroundThreshold )
+{
+    const LONG rgcspair[] = { 0, 1, cspairRadixSortMin - 1, cspairRadixSortMin, cspairRadixSortMin + 1, 2 * cspairRadixSortMin };
+
+    for ( INT icspair = 0; icspair < _countof( rgcspair ); icspair++ )
+    {
+        CSortInMemoryTest test;
+        CHECK( JET_errSuccess == test.ErrInit() );
+
+        for ( LONG ispair = 0; ispair < rgcspair[ icspair ]; ispair++ )
+        {
+            const ULONG ul      = test.UlRandom();
+            const BYTE  rgbKey[]= { BYTE( ul ), BYTE( ul >> 8 ), BYTE( ul >> 16 ), BYTE( ul >> 24 ) };
+            CHECK( test.FAdd( rgbKey, 1 + INT( ul >> 30 ), NULL, 0 ) );
+        }
+
+        CHECK( rgcspair[ icspair ] == test.Cspair() );
+        CHECK( test.FRadixSortMatchesQuicksort() );
+    }
+}
+
+#endif
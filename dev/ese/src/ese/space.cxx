@@ -46,6 +46,20 @@ LONG LSPDeletedTreeFreedExtentsCEFLPv( LONG iInstance, VOID *pvBuf )
     return 0;
 }
 
+PERFInstanceLiveTotal<> cSPAvailPoolCacheHits;
+LONG LSPAvailPoolCacheHitsCEFLPv( LONG iInstance, VOID *pvBuf )
+{
+    cSPAvailPoolCacheHits.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+PERFInstanceLiveTotal<> cSPAvailPoolCacheMisses;
+LONG LSPAvailPoolCacheMissesCEFLPv( LONG iInstance, VOID *pvBuf )
+{
+    cSPAvailPoolCacheMisses.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
 #endif
 
 
@@ -1046,6 +1060,12 @@ class CSPExtentNodeKDF {
             return m_spextdata.CpgExtent();
         }
 
+        SpacePool SppPool( void ) const
+        {
+            ASSERT_VALID( this );
+            return m_spextkey.SppPool();
+        }
+
         const KEYDATAFLAGS * Pkdf( void ) const
         {
             ASSERT_VALID( this );
@@ -4848,6 +4868,53 @@ enum SPFindFlags {
     fSPFindAnyGreaterPage   = 0x2
 };
 
+LOCAL ERR ErrSPIAEFPoolEmpty(
+    __inout FUCB * const        pfucbAE,
+    __in    const SpacePool     sppAvailPool,
+    __out   BOOL * const        pfPoolEmpty )
+{
+    ERR             err;
+    DIB             dib;
+    CSPExtentInfo   spaei;
+
+    *pfPoolEmpty = fFalse;
+
+    CSPExtentKeyBM  spaeFirst( SPEXTKEY::fSPExtentTypeAE, pgnoNull, sppAvailPool );
+    dib.pos = posDown;
+    dib.pbm = spaeFirst.Pbm( pfucbAE );
+    dib.dirflag = fDIRNull;
+
+    err = ErrBTDown( pfucbAE, &dib, latchReadTouch );
+    if ( JET_errRecordNotFound == err )
+    {
+        *pfPoolEmpty = fTrue;
+        err = JET_errSuccess;
+        goto HandleError;
+    }
+    Call( err );
+
+    if ( wrnNDFoundLess == err )
+    {
+        err = ErrBTNext( pfucbAE, fDIRNull );
+        if ( JET_errNoCurrentRecord == err )
+        {
+            *pfPoolEmpty = fTrue;
+            err = JET_errSuccess;
+            goto HandleError;
+        }
+        Call( err );
+    }
+
+    spaei.Set( pfucbAE );
+    *pfPoolEmpty = ( spaei.SppPool() != sppAvailPool );
+    spaei.Unset();
+    err = JET_errSuccess;
+
+HandleError:
+    BTUp( pfucbAE );
+    return err;
+}
+
 ERR ErrSPIAEFindPage(
     __inout FUCB * const        pfucbAE,
     __in    const SPFindFlags   fSPFindFlags,
@@ -4860,6 +4927,7 @@ ERR ErrSPIAEFindPage(
     ERR             err             = JET_errSuccess;
     FCB * const     pfcb            = pfucbAE->u.pfcb;
     DIB             dib;
+    BOOL            fProbePool      = fFalse;
 
     Assert( pfucbAE );
     Assert( pspaeiAlloc );
@@ -4872,6 +4940,12 @@ ERR ErrSPIAEFindPage(
         *pcpgFindInsertionRegionMarker = 0;
     }
 
+    if ( pfcb->FAvailPoolEmpty( (ULONG)sppAvailPool ) )
+    {
+        PERFOpt( cSPAvailPoolCacheHits.Inc( PinstFromPfucb( pfucbAE ) ) );
+        return ErrERRCheck( errSPNoSpaceForYou );
+    }
+
     CSPExtentKeyBM  spaeFindPage( SPEXTKEY::fSPExtentTypeAE, pgnoLast, sppAvailPool );
     dib.pos = posDown;
     dib.pbm = spaeFindPage.Pbm( pfucbAE );
@@ -4896,6 +4970,7 @@ ERR ErrSPIAEFindPage(
 
         case JET_errRecordNotFound:
 
+            fProbePool = fTrue;
             Error( ErrERRCheck( errSPNoSpaceForYou ) );
             break;
 
@@ -4964,6 +5039,7 @@ ERR ErrSPIAEFindPage(
 
             if ( pspaeiAlloc->SppPool() != sppAvailPool )
             {
+                fProbePool = fTrue;
                 Error( ErrERRCheck( errSPNoSpaceForYou ) );
             }
 
@@ -5026,6 +5102,20 @@ HandleError:
 
         BTUp( pfucbAE );
 
+        if ( errSPNoSpaceForYou == err )
+        {
+            PERFOpt( cSPAvailPoolCacheMisses.Inc( PinstFromPfucb( pfucbAE ) ) );
+
+            if ( fProbePool && !pfcb->FAvailPoolProbed( (ULONG)sppAvailPool ) )
+            {
+                BOOL fPoolEmpty = fFalse;
+                if ( ErrSPIAEFPoolEmpty( pfucbAE, sppAvailPool, &fPoolEmpty ) >= JET_errSuccess )
+                {
+                    pfcb->SetAvailPoolProbed( (ULONG)sppAvailPool, fPoolEmpty );
+                }
+            }
+        }
+
         Assert( !Pcsr( pfucbAE )->FLatched() );
 
     }
@@ -8083,6 +8173,11 @@ INLINE ERR ErrSPIAddExtent(
     Assert( Pcsr( pfucb )->FLatched() );
 
     Assert( pfucb->fOwnExt || pfucb->fAvailExt );
+    if ( pfucb->fAvailExt )
+    {
+        pfucb->u.pfcb->ResetAvailPoolProbed( (ULONG)pcspextnode->SppPool() );
+    }
+
     OSTraceFMP( pfucb->ifmp, JET_tracetagSpaceManagement,
         OSFormat( "ErrSPIAddExtent: Add %lu + %d pages to 0x%x.%lu %hs.",
                 pcspextnode->PgnoFirst(),
@@ -8479,6 +8574,8 @@ LOCAL ERR ErrSPINewSize(
 
     Call( ErrIOResizeUpdateDbHdrCount( ifmp, ( cpgReq >= 0 )  ) );
 
+    g_rgfmp[ifmp].ChangedPageMap().SetResized( pgnoLastCurr, pgnoLastCurr + cpgReq );
+
 
     Call( ErrIONewSize(
             ifmp,
@@ -8744,7 +8841,11 @@ LOCAL ERR ErrSPIExtendDB(
 
     if ( fPermitAsyncExtension && ( ( pgnoSELast + cpgSEReqAdj + cpgSEReq ) <= pgnoSEMaxAdj ) )
     {
-        cpgAsyncExtension = cpgSEReq;
+        const CPG cpgAsyncExtensionLead = g_rgfmp[pfucbRoot->ifmp].CpgDbExtensionLead(
+                                                cpgSEReq,
+                                                (CPG)UlParam( PinstFromIfmp( pfucbRoot->ifmp ), JET_paramDbExtensionAsyncHeadroom ) );
+        cpgAsyncExtension = min( cpgAsyncExtensionLead, (CPG)( pgnoSEMaxAdj - pgnoSELast - cpgSEReqAdj ) );
+        Assert( cpgAsyncExtension >= cpgSEReq );
     }
 
     err = ErrSPINewSize( TcCurr(), pfucbRoot->ifmp, pgnoSELast, cpgSEReqAdj, cpgAsyncExtension );
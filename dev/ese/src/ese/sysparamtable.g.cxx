@@ -223,6 +223,10 @@ JetParam g_rgparamRaw[] =
     NORMAL_PARAM(JET_paramUseFlushForWriteDurability, CJetParam::typeBoolean, 1,  0,  0, 1, 0, 1, 1),
     NORMAL_PARAM(JET_paramEnableRBS, CJetParam::typeBoolean, 1,  0,  0, 0, 0, 1, 0),
     NORMAL_PARAM(JET_paramRBSFilePath, CJetParam::typeFolder, 0,  0,  0, 1, 0, 246, L".\\"),
+    NORMAL_PARAM(JET_paramDbExtensionAsyncHeadroom, CJetParam::typeInteger, 1,  0,  0, 0, 0, 2147483647, 0),
+    NORMAL_PARAM(JET_paramEnableChangedPageTracking, CJetParam::typeBoolean, 1,  0,  0, 0, 0, 1, 0),
+    CUSTOM_PARAM3(JET_paramLockContentionSampleRate, CJetParam::typeInteger, 1,  1,  0, 0, 0, 2147483647, 1024, 1024, CJetParam::GetInteger, SetLockContentionSampleRate, CJetParam::CloneDefault),
+    NORMAL_PARAM(JET_paramEnableOpStats, CJetParam::typeBoolean, 1,  0,  0, 0, 0, 1, 0),
     ILLEGAL_PARAM(JET_paramMaxValueInvalid),
 };
 
@@ -444,4 +448,8 @@ static_assert( JET_paramRecordSizeMost == 213, "The order of defintion for JET_p
 static_assert( JET_paramUseFlushForWriteDurability == 214, "The order of defintion for JET_paramUseFlushForWriteDurability in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
 static_assert( JET_paramEnableRBS == 215, "The order of defintion for JET_paramEnableRBS in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
 static_assert( JET_paramRBSFilePath == 216, "The order of defintion for JET_paramRBSFilePath in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
-static_assert( JET_paramMaxValueInvalid == 217, "The order of defintion for JET_paramMaxValueInvalid in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
+static_assert( JET_paramDbExtensionAsyncHeadroom == 217, "The order of defintion for JET_paramDbExtensionAsyncHeadroom in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
+static_assert( JET_paramEnableChangedPageTracking == 218, "The order of defintion for JET_paramEnableChangedPageTracking in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
+static_assert( JET_paramLockContentionSampleRate == 219, "The order of defintion for JET_paramLockContentionSampleRate in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
+static_assert( JET_paramEnableOpStats == 220, "The order of defintion for JET_paramEnableOpStats in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
+static_assert( JET_paramMaxValueInvalid == 221, "The order of defintion for JET_paramMaxValueInvalid in sysparam.xml must follow the numerical ordering of its value (as defined in jethdr.w)." );
@@ -1166,6 +1166,9 @@ ERR ErrIsamSetSessionParameter(
     case JET_sesparamCommitContextContainsCustomerData:
         return ppib->ErrSetCommitContextContainsCustomerData( pvParam, cbParam );
 
+    case JET_sesparamOpStats:
+        return ErrERRCheck( JET_errFeatureNotAvailable );
+
     default:
         Expected( ( sesparamid >= JET_sesparamCommitDefault )  && ( sesparamid < ( JET_sesparamCommitDefault + 1024 ) ) );
         return ErrERRCheck( JET_errInvalidSesparamId );
@@ -1426,6 +1429,24 @@ ERR ErrIsamGetSessionParameter(
         break;
     }
 
+    case JET_sesparamOpStats:
+    {
+        const DWORD cbParamActual = sizeof( JET_OPSTATS );
+        if ( pcbParamActual )
+        {
+            *pcbParamActual = cbParamActual;
+        }
+        if ( pvParam && cbParamMax < cbParamActual )
+        {
+            return ErrERRCheck( JET_errInvalidBufferSize );
+        }
+        if ( pvParam )
+        {
+            memcpy( pvParam, &ppib->OpstatsLast(), cbParamActual );
+        }
+        break;
+    }
+
     default:
         Expected( ( sesparamid >= JET_sesparamCommitDefault )  && ( sesparamid < ( JET_sesparamCommitDefault + 1024 ) ) );
         return ErrERRCheck( JET_errInvalidSesparamId );
@@ -31,6 +31,9 @@ PERFInstanceDelayedTotal<> cVERAsyncCleanupDispatched;
 PERFInstanceDelayedTotal<> cVERSyncCleanupDispatched;
 PERFInstanceDelayedTotal<> cVERCleanupDiscarded;
 PERFInstanceDelayedTotal<> cVERCleanupFailed;
+PERFInstanceDelayedTotal<> cVERcbucketHashTable;
+PERFInstanceDelayedTotal<> cVERCleanupPending;
+PERFInstanceDelayedTotal<> cVERCleanupCoalesced;
 
 
 LONG LVERcbucketAllocatedCEFLPv( LONG iInstance, VOID * pvBuf )
@@ -121,6 +124,36 @@ LONG LVERCleanupFailedCEFLPv( LONG iInstance, VOID * pvBuf )
     return 0;
 }
 
+LONG LVERcbucketHashTableCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cVERcbucketHashTable.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
+LONG LVERCleanupPendingCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    if ( pvBuf )
+    {
+        LONG counter = cVERCleanupPending.Get( iInstance );
+        if ( counter < 0 )
+        {
+            cVERCleanupPending.Clear( iInstance );
+            *((LONG *)pvBuf) = 0;
+        }
+        else
+        {
+            *((LONG *)pvBuf) = counter;
+        }
+    }
+    return 0;
+}
+
+LONG LVERCleanupCoalescedCEFLPv( LONG iInstance, VOID * pvBuf )
+{
+    cVERCleanupCoalesced.PassTo( iInstance, pvBuf );
+    return 0;
+}
+
 #endif
 
 
@@ -419,12 +452,86 @@ VOID VER::VERIReportVersionStoreOOM( PIB * ppibTrxOldest, BOOL fMaxTrxSize, cons
 }
 
 
-INLINE ERR VER::ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash )
+INLINE VER::BUCKETSLOT *VER::PbucketslotVERI( const IFMP ifmp, const PGNO pgnoFDPTable )
 {
-    Assert( m_critBucketGlobal.FOwner() );
+    Assert( m_cbucketslot > 0 );
+    Assert( m_cbucketslot <= cbucketslotMax );
 
-    Assert( m_pbucketGlobalHead == pbucketNil
-        || (size_t)cbRCE > CbBUFree( m_pbucketGlobalHead ) );
+    if ( 1 == m_cbucketslot )
+    {
+        return &m_rgbucketslot[ 0 ];
+    }
+
+    const UINT uiSlot = (UINT)ifmp * 0x9E3779B1 + (UINT)pgnoFDPTable;
+
+    return &m_rgbucketslot[ uiSlot % m_cbucketslot ];
+}
+
+INLINE VER::BUCKETSLOT *VER::PbucketslotVERI( const FCB * const pfcb )
+{
+    const FCB * const   pfcbTable   = ( ( pfcb->FTypeLV() || pfcb->FTypeSecondaryIndex() ) && pfcbNil != pfcb->PfcbTable() ) ?
+                                        pfcb->PfcbTable() :
+                                        pfcb;
+
+    return PbucketslotVERI( pfcbTable->Ifmp(), pfcbTable->PgnoFDP() );
+}
+
+//  operDeleteTable is versioned on the database root but must share a slot (and therefore
+//  allocation order) with the RCEs of the table it deletes
+
+INLINE VER::BUCKETSLOT *VER::PbucketslotVERI( const RCE * const prce )
+{
+    if ( operDeleteTable == prce->Oper() )
+    {
+        return PbucketslotVERI( prce->Ifmp(), *(PGNO*)prce->PbData() );
+    }
+
+    return PbucketslotVERI( prce->Pfcb() );
+}
+
+
+INLINE BOOL VER::FVERIBucketActive( const BUCKET * const pbucket ) const
+{
+    Assert( pbucket->hdr.ibucketslot >= 0 );
+    Assert( pbucket->hdr.ibucketslot < m_cbucketslot );
+    return m_rgbucketslot[ pbucket->hdr.ibucketslot ].pbucketActive == pbucket;
+}
+
+
+VOID VER::VERUnallocateLastRCE( RCE * const prce )
+{
+    BUCKETSLOT * const      pbucketslot     = PbucketslotVERI( prce );
+    ENTERCRITICALSECTION    enterCritBucketSlot( &pbucketslot->crit );
+
+    Assert( pbucketNil != pbucketslot->pbucketActive );
+    Assert( (RCE *)PvAlignForThisPlatform( (BYTE *)prce + prce->CbRce() )
+                == pbucketslot->pbucketActive->hdr.prceNextNew );
+    pbucketslot->pbucketActive->hdr.prceNextNew = prce;
+}
+
+
+#ifdef DEBUG
+BOOL VER::FInCritBucketSlot() const
+{
+    for ( INT ibucketslot = 0; ibucketslot < m_cbucketslot; ibucketslot++ )
+    {
+        if ( m_rgbucketslot[ ibucketslot ].crit.FOwner() )
+        {
+            return fTrue;
+        }
+    }
+    return fFalse;
+}
+#endif
+
+
+INLINE ERR VER::ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash, BUCKETSLOT * const pbucketslot )
+{
+    Assert( pbucketslot->crit.FOwner() );
+    Assert( !m_critBucketGlobal.FOwner() );
+
+    Assert( pbucketslot->pbucketActive == pbucketNil
+        || (size_t)cbRCE > CbBUFree( pbucketslot->pbucketActive ) );
 
     VERSignalCleanup();
 
@@ -432,7 +539,7 @@ INLINE ERR VER::ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash )
 
     if ( pbucketNil == pbucket )
     {
-        m_critBucketGlobal.Leave();
+        pbucketslot->crit.Leave();
 
         if ( uiHashInvalid != uiHash )
         {
@@ -448,15 +555,17 @@ INLINE ERR VER::ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash )
             RwlRCEChain( uiHash ).EnterAsWriter();
         }
 
-        m_critBucketGlobal.Enter();
+        pbucketslot->crit.Enter();
 
-        if ( m_pbucketGlobalHead == pbucketNil || (size_t)cbRCE > CbBUFree( m_pbucketGlobalHead ) )
+        if ( pbucketslot->pbucketActive == pbucketNil || (size_t)cbRCE > CbBUFree( pbucketslot->pbucketActive ) )
         {
             pbucket = new( this ) BUCKET( this );
 
             if ( pbucketNil == pbucket )
             {
+                m_critBucketGlobal.Enter();
                 VERIReportVersionStoreOOM( NULL, fFalse , fCleanupWasRun );
+                m_critBucketGlobal.Leave();
                 return ErrERRCheck( fCleanupWasRun ?
                                         JET_errVersionStoreOutOfMemory :
                                         JET_errVersionStoreOutOfMemoryAndCleanupTimedOut );
@@ -473,6 +582,11 @@ INLINE ERR VER::ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash )
     Assert( FAlignedForThisPlatform( pbucket->rgb ) );
     Assert( (BYTE *)PvAlignForThisPlatform( pbucket->rgb ) == pbucket->rgb );
 
+    pbucket->hdr.ibucketslot = INT( pbucketslot - m_rgbucketslot );
+    pbucketslot->pbucketActive = pbucket;
+
+    m_critBucketGlobal.Enter();
+
     pbucket->hdr.pbucketPrev = m_pbucketGlobalHead;
     if ( pbucket->hdr.pbucketPrev )
     {
@@ -508,6 +622,8 @@ INLINE ERR VER::ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash )
         }
     }
 
+    m_critBucketGlobal.Leave();
+
     Assert( (size_t)cbRCE <= CbBUFree( pbucket ) );
     return ( (size_t)cbRCE > CbBUFree( pbucket ) ? ErrERRCheck( JET_errVersionStoreEntryTooBig ) : JET_errSuccess );
 }
@@ -528,6 +644,8 @@ BUCKET *VER::PbucketVERIFreeAndGetNextOldestBucket( BUCKET * pbucket )
 {
     Assert( m_critBucketGlobal.FOwner() );
 
+    Assert( !FVERIBucketActive( pbucket ) );
+
     BUCKET * const pbucketNext = (BUCKET *)pbucket->hdr.pbucketNext;
     BUCKET * const pbucketPrev = (BUCKET *)pbucket->hdr.pbucketPrev;
 
@@ -578,29 +696,211 @@ BUCKET *VER::PbucketVERIFreeAndGetNextOldestBucket( BUCKET * pbucket )
 INLINE CReaderWriterLock& VER::RwlRCEChain( UINT ui )
 {
     Assert( m_frceHashTableInited );
-    Assert( ui < m_crceheadHashTable );
-    return m_rgrceheadHashTable[ ui ].rwl;
+    Assert( uiHashInvalid != ui );
+    return m_rgrceheadHashTable[ ui % m_crceheadHashTable ].rwl;
+}
+
+INLINE ULONG VER::CbucketIHashLevel_( const ULONG cbucket ) const
+{
+    Assert( cbucket >= m_crceheadHashTable );
+
+    ULONG cbucketLevel = (ULONG)m_crceheadHashTable;
+    while ( cbucketLevel * 2 <= cbucket )
+    {
+        cbucketLevel *= 2;
+    }
+    return cbucketLevel;
+}
+
+INLINE ULONG VER::IbucketIHash_( const UINT ui, const ULONG cbucket ) const
+{
+    const ULONG cbucketLevel    = CbucketIHashLevel_( cbucket );
+    ULONG       ibucket         = ui % ( cbucketLevel * 2 );
+    if ( ibucket >= cbucket )
+    {
+        ibucket -= cbucketLevel;
+    }
+    Assert( ibucket < cbucket );
+    Assert( ibucket % m_crceheadHashTable == ui % m_crceheadHashTable );
+    return ibucket;
+}
+
+INLINE ULONG VER::IbucketHashTable( UINT ui ) const
+{
+    Assert( m_frceHashTableInited );
+    Assert( uiHashInvalid != ui );
+    return IbucketIHash_( ui, m_cbucketHashTable );
+}
+
+INLINE RCE **VER::PprceIBucket_( const ULONG ibucket ) const
+{
+    Assert( ibucket < m_cbucketHashTableMax );
+
+    if ( ibucket < m_crceheadHashTable )
+    {
+        return const_cast<RCE **>( &m_rgrceheadHashTable[ ibucket ].prceChain );
+    }
+
+    ULONG   ibucketSegment  = (ULONG)m_crceheadHashTable;
+    INT     ihashsegment    = 1;
+    while ( ibucket >= ibucketSegment * 2 )
+    {
+        ibucketSegment *= 2;
+        ihashsegment++;
+    }
+
+    Assert( ihashsegment < chashsegmentMax );
+    Assert( NULL != m_rgprceHashSegment[ ihashsegment ] );
+    return &m_rgprceHashSegment[ ihashsegment ][ ibucket - ibucketSegment ];
 }
 
 INLINE RCE *VER::GetChain( UINT ui ) const
 {
     Assert( m_frceHashTableInited );
-    Assert( ui < m_crceheadHashTable );
-    return m_rgrceheadHashTable[ ui ].prceChain;
+    return *PprceIBucket_( IbucketHashTable( ui ) );
 }
 
 INLINE RCE **VER::PGetChain( UINT ui )
 {
     Assert( m_frceHashTableInited );
-    Assert( ui < m_crceheadHashTable );
-    return &m_rgrceheadHashTable[ ui ].prceChain;
+    return PprceIBucket_( IbucketHashTable( ui ) );
 }
 
 INLINE VOID VER::SetChain( UINT ui, RCE *prce )
 {
     Assert( m_frceHashTableInited );
-    Assert( ui < m_crceheadHashTable );
-    m_rgrceheadHashTable[ ui ].prceChain = prce;
+    *PprceIBucket_( IbucketHashTable( ui ) ) = prce;
+}
+
+INLINE BOOL VER::FChainEmptyNoLock( UINT ui ) const
+{
+    Assert( m_frceHashTableInited );
+
+    const ULONG cbucketBefore   = m_cbucketHashTable;
+    const RCE * const prceChain = *(RCE * volatile *)PprceIBucket_( IbucketIHash_( ui, cbucketBefore ) );
+    const ULONG cbucketAfter    = m_cbucketHashTable;
+
+    return prceNil == prceChain && cbucketBefore == cbucketAfter;
+}
+
+INLINE VOID VER::VERNoteHashChainLength( const INT crceChain )
+{
+    if ( crceChain > m_crceHashChainLongest )
+    {
+        m_crceHashChainLongest = crceChain;
+    }
+
+    if ( crceChain >= crceHashChainGrowThreshold
+        && !m_fHashTableGrowthRequested
+        && m_cbucketHashTable < m_cbucketHashTableMax )
+    {
+        m_fHashTableGrowthRequested = fTrue;
+    }
+}
+
+VOID VER::VERIGrowHashTable()
+{
+    Assert( m_critRCEClean.FOwner() );
+
+    if ( !m_frceHashTableInited
+        || !AtomicCompareExchange( (LONG *)&m_fHashTableGrowthRequested, fTrue, fFalse ) )
+    {
+        return;
+    }
+
+    for ( INT isplit = 0; isplit < cbucketHashSplitPerPass; isplit++ )
+    {
+        const ULONG cbucket = m_cbucketHashTable;
+        if ( cbucket >= m_cbucketHashTableMax )
+        {
+            break;
+        }
+
+        const ULONG cbucketLevel = CbucketIHashLevel_( cbucket );
+
+        if ( cbucket == cbucketLevel )
+        {
+            INT ihashsegment = 1;
+            for ( ULONG cbucketT = (ULONG)m_crceheadHashTable; cbucketT < cbucketLevel; cbucketT *= 2 )
+            {
+                ihashsegment++;
+            }
+            Assert( ihashsegment < chashsegmentMax );
+
+            if ( NULL == m_rgprceHashSegment[ ihashsegment ] )
+            {
+                RCE ** const rgprce = (RCE **)PvOSMemoryPageAlloc( cbucketLevel * sizeof( RCE * ), NULL );
+                if ( NULL == rgprce )
+                {
+                    break;
+                }
+                AtomicExchangePointer( (void **)&m_rgprceHashSegment[ ihashsegment ], rgprce );
+            }
+        }
+
+        const ULONG ibucketLow  = cbucket - cbucketLevel;
+        const ULONG ibucketHigh = cbucket;
+
+        ENTERREADERWRITERLOCK enterRwlHashAsWriter( &( RwlRCEChain( ibucketLow ) ), fFalse );
+
+        RCE ** const    pprceLow        = PprceIBucket_( ibucketLow );
+        RCE ** const    pprceHigh       = PprceIBucket_( ibucketHigh );
+        RCE *           prceLowHead     = prceNil;
+        RCE **          pprceLowTail    = &prceLowHead;
+        RCE *           prceHighHead    = prceNil;
+        RCE **          pprceHighTail   = &prceHighHead;
+
+        Assert( prceNil == *pprceHigh );
+
+        for ( RCE * prce = *pprceLow; prceNil != prce; )
+        {
+            RCE * const prceNext = prce->PrceHashOverflow();
+
+            Assert( prceNil == prce->PrceNextOfNode() );
+            Assert( ibucketLow == prce->UiHash() % cbucketLevel );
+
+            if ( ibucketHigh == prce->UiHash() % ( cbucketLevel * 2 ) )
+            {
+                *pprceHighTail = prce;
+                pprceHighTail = &prce->PrceHashOverflow();
+            }
+            else
+            {
+                *pprceLowTail = prce;
+                pprceLowTail = &prce->PrceHashOverflow();
+            }
+
+            prce = prceNext;
+        }
+
+        *pprceLowTail = prceNil;
+        *pprceHighTail = prceNil;
+
+        *pprceHigh = prceHighHead;
+        AtomicIncrement( (LONG *)&m_cbucketHashTable );
+        *pprceLow = prceLowHead;
+
+        m_cHashBucketSplits++;
+        PERFOpt( cVERcbucketHashTable.Inc( m_pinst ) );
+    }
+
+    OSTrace(
+        JET_tracetagVersionStore,
+        OSFormat(
+            "Version Store hash table grown to %u buckets (%u lock stripes, longest chain observed=%d)",
+            (ULONG)m_cbucketHashTable,
+            (ULONG)m_crceheadHashTable,
+            (INT)m_crceHashChainLongest ) );
+    m_crceHashChainLongest = 0;
+}
+
+VOID VER::VERIFreeHashSegments()
+{
+    for ( INT ihashsegment = 0; ihashsegment < chashsegmentMax; ihashsegment++ )
+    {
+        OSMemoryPageFree( m_rgprceHashSegment[ ihashsegment ] );
+        m_rgprceHashSegment[ ihashsegment ] = NULL;
+    }
 }
 
 CReaderWriterLock& RCE::RwlChain()
@@ -616,9 +916,6 @@ LOCAL UINT UiRCHashFunc( IFMP ifmp, PGNO pgnoFDP, const BOOKMARK& bookmark, cons
     ASSERT_VALID( &bookmark );
     Assert( pgnoNull != pgnoFDP );
 
-    const UINT crceheadHashTable = crcehead ? crcehead : PverFromIfmp( ifmp )->m_crceheadHashTable;
-
-
     UINT uiHash =   (UINT)ifmp
                     + pgnoFDP
                     + bookmark.key.prefix.Cb()
@@ -707,7 +1004,14 @@ LOCAL UINT UiRCHashFunc( IFMP ifmp, PGNO pgnoFDP, const BOOKMARK& bookmark, cons
         }
     }
 
-    uiHash %= crceheadHashTable;
+    if ( crcehead )
+    {
+        uiHash %= crcehead;
+    }
+    else if ( uiHashInvalid == uiHash )
+    {
+        uiHash = 0;
+    }
 
     return uiHash;
 }
@@ -880,7 +1184,7 @@ VOID RCE::AssertValid() const
 #ifndef RTM
 
 
-ERR VER::ErrCheckRCEChain( const RCE * const prce, const UINT uiHash ) const
+ERR VER::ErrCheckRCEChain( const RCE * const prce, const ULONG ibucket ) const
 {
     const RCE   * prceChainOld  = prceNil;
     const RCE   * prceChain     = prce;
@@ -890,7 +1194,8 @@ ERR VER::ErrCheckRCEChain( const RCE * const prce, const UINT uiHash ) const
         prceChain->AssertValid();
         AssertRTL( prceChain->PgnoFDP() == prce->PgnoFDP() );
         AssertRTL( prceChain->Ifmp() == prce->Ifmp() );
-        AssertRTL( prceChain->UiHash() == uiHash );
+        AssertRTL( prceChain->UiHash() == prce->UiHash() );
+        AssertRTL( IbucketHashTable( prceChain->UiHash() ) == ibucket );
         AssertRTL( !prceChain->FOperDDL() );
 
         prceChainOld    = prceChain;
@@ -900,13 +1205,13 @@ ERR VER::ErrCheckRCEChain( const RCE * const prce, const UINT uiHash ) const
 }
 
 
-ERR VER::ErrCheckRCEHashList( const RCE * const prce, const UINT uiHash ) const
+ERR VER::ErrCheckRCEHashList( const RCE * const prce, const ULONG ibucket ) const
 {
     ERR err = JET_errSuccess;
     const RCE * prceT = prce;
     for ( ; prceNil != prceT; prceT = prceT->PrceHashOverflow() )
     {
-        CallR( ErrCheckRCEChain( prceT, uiHash ) );
+        CallR( ErrCheckRCEChain( prceT, ibucket ) );
     }
     return err;
 }
@@ -915,14 +1220,14 @@ ERR VER::ErrCheckRCEHashList( const RCE * const prce, const UINT uiHash ) const
 ERR VER::ErrInternalCheck()
 {
     ERR err = JET_errSuccess;
-    UINT uiHash = 0;
-    for ( ; uiHash < m_crceheadHashTable; ++uiHash )
+    const ULONG cbucket = m_cbucketHashTable;
+    for ( ULONG ibucket = 0; ibucket < cbucket; ++ibucket )
     {
-        if( NULL != GetChain( uiHash ) )
+        if( NULL != *PprceIBucket_( ibucket ) )
         {
-            ENTERREADERWRITERLOCK rwlHashAsReader( &(RwlRCEChain( uiHash )), fTrue );
-            const RCE * const prce = GetChain( uiHash );
-            CallR( ErrCheckRCEHashList( prce, uiHash ) );
+            ENTERREADERWRITERLOCK rwlHashAsReader( &(RwlRCEChain( ibucket )), fTrue );
+            const RCE * const prce = *PprceIBucket_( ibucket );
+            CallR( ErrCheckRCEHashList( prce, ibucket ) );
         }
     }
     return err;
@@ -1140,19 +1445,20 @@ BOOL RCE::FRCECorrectEDBG( IFMP ifmp, PGNO pgnoFDP, const BOOKMARK& bookmark )
 }
 
 
-LOCAL RCE **PprceRCEChainGet( UINT uiHash, IFMP ifmp, PGNO pgnoFDP, const BOOKMARK& bookmark )
+LOCAL RCE **PprceRCEChainGet( UINT uiHash, IFMP ifmp, PGNO pgnoFDP, const BOOKMARK& bookmark, INT * const pcrceChain = NULL )
 {
     Assert( PverFromIfmp( ifmp )->RwlRCEChain( uiHash ).FReader() ||
             PverFromIfmp( ifmp )->RwlRCEChain( uiHash ).FWriter() );
 
     AssertRTL( UiRCHashFunc( ifmp, pgnoFDP, bookmark ) == uiHash );
 
+    INT crceChain = 0;
     RCE **pprceChain = PverFromIfmp( ifmp )->PGetChain( uiHash );
     while ( prceNil != *pprceChain )
     {
         RCE * const prceT = *pprceChain;
 
-        AssertRTL( prceT->UiHash() == uiHash );
+        Assert( PverFromIfmp( ifmp )->IbucketHashTable( prceT->UiHash() ) == PverFromIfmp( ifmp )->IbucketHashTable( uiHash ) );
 
         if ( FRCECorrect( ifmp, pgnoFDP, bookmark, prceT ) )
         {
@@ -1162,7 +1468,7 @@ LOCAL RCE **PprceRCEChainGet( UINT uiHash, IFMP ifmp, PGNO pgnoFDP, const BOOKMA
             if ( prceNil == prceT->PrceNextOfNode() )
             {
                 Assert( prceNil == prceT->PrceHashOverflow()
-                    || prceT->PrceHashOverflow()->UiHash() == prceT->UiHash() );
+                    || PverFromIfmp( ifmp )->IbucketHashTable( prceT->PrceHashOverflow()->UiHash() ) == PverFromIfmp( ifmp )->IbucketHashTable( prceT->UiHash() ) );
             }
             else
             {
@@ -1182,7 +1488,7 @@ LOCAL RCE **PprceRCEChainGet( UINT uiHash, IFMP ifmp, PGNO pgnoFDP, const BOOKMA
                 }
             }
             else if ( prceNil != prceT->PrceHashOverflow()
-                && prceT->PrceHashOverflow()->UiHash() != prceT->UiHash() )
+                && PverFromIfmp( ifmp )->IbucketHashTable( prceT->PrceHashOverflow()->UiHash() ) != PverFromIfmp( ifmp )->IbucketHashTable( prceT->UiHash() ) )
             {
                 Assert( fFalse );
             }
@@ -1191,10 +1497,15 @@ LOCAL RCE **PprceRCEChainGet( UINT uiHash, IFMP ifmp, PGNO pgnoFDP, const BOOKMA
             return pprceChain;
         }
 
+        crceChain++;
         pprceChain = &prceT->PrceHashOverflow();
     }
 
     Assert( prceNil == *pprceChain );
+    if ( NULL != pcrceChain )
+    {
+        *pcrceChain = crceChain;
+    }
     return NULL;
 }
 
@@ -1347,9 +1658,9 @@ INLINE BOOL FVERIAddUndoInfo( const RCE * const prce )
     return fAddUndoInfo;
 }
 
-ERR VER::ErrVERIAllocateRCE( INT cbRCE, RCE ** pprce, const UINT uiHash )
+ERR VER::ErrVERIAllocateRCE( INT cbRCE, RCE ** pprce, const UINT uiHash, BUCKETSLOT * const pbucketslot )
 {
-    Assert( m_critBucketGlobal.FOwner() );
+    Assert( pbucketslot->crit.FOwner() );
 
     ERR err = JET_errSuccess;
 
@@ -1359,21 +1670,23 @@ ERR VER::ErrVERIAllocateRCE( INT cbRCE, RCE ** pprce, const UINT uiHash )
     }
 
 
-    if ( m_pbucketGlobalHead == pbucketNil || (size_t)cbRCE > CbBUFree( m_pbucketGlobalHead ) )
+    if ( pbucketslot->pbucketActive == pbucketNil || (size_t)cbRCE > CbBUFree( pbucketslot->pbucketActive ) )
     {
-        Call( ErrVERIBUAllocBucket( cbRCE, uiHash ) );
+        Call( ErrVERIBUAllocBucket( cbRCE, uiHash, pbucketslot ) );
     }
-    Assert( (size_t)cbRCE <= CbBUFree( m_pbucketGlobalHead ) );
 
-    Assert( FAlignedForThisPlatform( m_pbucketGlobalHead ) );
+    BUCKET * const pbucket = pbucketslot->pbucketActive;
+    Assert( (size_t)cbRCE <= CbBUFree( pbucket ) );
+
+    Assert( FAlignedForThisPlatform( pbucket ) );
 
 
-    *pprce = m_pbucketGlobalHead->hdr.prceNextNew;
-    m_pbucketGlobalHead->hdr.prceNextNew =
+    *pprce = pbucket->hdr.prceNextNew;
+    pbucket->hdr.prceNextNew =
         reinterpret_cast<RCE *>( PvAlignForThisPlatform( reinterpret_cast<BYTE *>( *pprce ) + cbRCE ) );
 
     Assert( FAlignedForThisPlatform( *pprce ) );
-    Assert( FAlignedForThisPlatform( m_pbucketGlobalHead->hdr.prceNextNew ) );
+    Assert( FAlignedForThisPlatform( pbucket->hdr.prceNextNew ) );
 
 HandleError:
     return err;
@@ -1394,7 +1707,8 @@ ERR VER::ErrVERICreateRCE(
     UINT        uiHash,
     RCE         **pprce,
     const BOOL  fProxy,
-    RCEID       rceid
+    RCEID       rceid,
+    const PGNO  pgnoFDPTableSlot
     )
 {
     ERR         err                 = JET_errSuccess;
@@ -1412,7 +1726,10 @@ ERR VER::ErrVERICreateRCE(
         uiHashConcurrentOp = uiHashInvalid;
     }
 
-    m_critBucketGlobal.Enter();
+    BUCKETSLOT * const pbucketslot = ( pgnoNull != pgnoFDPTableSlot ) ?
+                                        PbucketslotVERI( pfcb->Ifmp(), pgnoFDPTableSlot ) :
+                                        PbucketslotVERI( pfcb );
+    pbucketslot->crit.Enter();
 
     Assert( pfucbNil == pfucb ? 0 == level : level > 0 );
 
@@ -1424,7 +1741,7 @@ ERR VER::ErrVERICreateRCE(
         Error( ErrERRCheck( JET_errOutOfMemory ) );
     }
 
-    Call( ErrVERIAllocateRCE( cbNewRCE, &prce, uiHashConcurrentOp ) );
+    Call( ErrVERIAllocateRCE( cbNewRCE, &prce, uiHashConcurrentOp, pbucketslot ) );
 
 #ifdef DEBUG
     if ( !PinstFromIfmp( pfcb->Ifmp() )->m_plog->FRecovering() )
@@ -1459,7 +1776,7 @@ ERR VER::ErrVERICreateRCE(
             );
 
 HandleError:
-    m_critBucketGlobal.Leave();
+    pbucketslot->crit.Leave();
 
     if ( err >= 0 )
     {
@@ -1487,10 +1804,12 @@ LOCAL ERR ErrVERIInsertRCEIntoHash( RCE * const prce )
     Assert( UiRCHashFunc( prce->Ifmp(), prce->PgnoFDP(), bookmark ) == prce->UiHash() );
 #endif
 
+    INT             crceChain   = 0;
     RCE ** const    pprceChain  = PprceRCEChainGet( prce->UiHash(),
                                                     prce->Ifmp(),
                                                     prce->PgnoFDP(),
-                                                    bookmark );
+                                                    bookmark,
+                                                    &crceChain );
 
     if ( pprceChain )
     {
@@ -1523,10 +1842,7 @@ LOCAL ERR ErrVERIInsertRCEIntoHash( RCE * const prce )
                     Assert( PinstFromIfmp( prce->Ifmp() )->m_plog->FRecovering() );
                     Assert( FAlignedForThisPlatform( prce ) );
 
-                    VER *pver = PverFromIfmp( prce->Ifmp() );
-                    Assert( (RCE *)PvAlignForThisPlatform( (BYTE *)prce + prce->CbRce() )
-                                == pver->m_pbucketGlobalHead->hdr.prceNextNew );
-                    pver->m_pbucketGlobalHead->hdr.prceNextNew = prce;
+                    PverFromIfmp( prce->Ifmp() )->VERUnallocateLastRCE( prce );
 
                     ERR err = ErrERRCheck( JET_errPreviousVersion );
                     return err;
@@ -1576,18 +1892,20 @@ LOCAL ERR ErrVERIInsertRCEIntoHash( RCE * const prce )
         Assert( prceNil == prce->PrceNextOfNode() );
         Assert( prceNil == prce->PrcePrevOfNode() );
 
-        prce->SetPrceHashOverflow( PverFromIfmp( prce->Ifmp() )->GetChain( prce->UiHash() ) );
-        PverFromIfmp( prce->Ifmp() )->SetChain( prce->UiHash(), prce );
+        VER * const pver = PverFromIfmp( prce->Ifmp() );
+        prce->SetPrceHashOverflow( pver->GetChain( prce->UiHash() ) );
+        pver->SetChain( prce->UiHash(), prce );
+        pver->VERNoteHashChainLength( crceChain + 1 );
     }
 
     Assert( prceNil != prce->PrceNextOfNode()
         || prceNil == prce->PrceHashOverflow()
-        || prce->PrceHashOverflow()->UiHash() == prce->UiHash() );
+        || PverFromIfmp( prce->Ifmp() )->IbucketHashTable( prce->PrceHashOverflow()->UiHash() ) == PverFromIfmp( prce->Ifmp() )->IbucketHashTable( prce->UiHash() ) );
 
 #ifdef DEBUG
     if ( prceNil == prce->PrceNextOfNode()
         && prceNil != prce->PrceHashOverflow()
-        && prce->PrceHashOverflow()->UiHash() != prce->UiHash() )
+        && PverFromIfmp( prce->Ifmp() )->IbucketHashTable( prce->PrceHashOverflow()->UiHash() ) != PverFromIfmp( prce->Ifmp() )->IbucketHashTable( prce->UiHash() ) )
     {
         Assert( fFalse );
     }
@@ -2218,6 +2536,7 @@ DWORD VER::VERIRCECleanProc( VOID *pvThis )
 
     pver->m_critRCEClean.Enter();
     pver->ErrVERIRCEClean();
+    pver->VERIGrowHashTable();
     LONG fStatus = AtomicCompareExchange( (LONG *)&pver->m_fVERCleanUpWait, 1, 0 );
     pver->m_critRCEClean.Leave();
 
@@ -2314,6 +2633,17 @@ VER * VER::VERAlloc( INST* pinst )
 
     AssertRTL( sizeof(VER::RCEHEAD) *  pVer->m_crceheadHashTable < cbVER );
 
+    pVer->m_cbucketHashTable = (ULONG)pVer->m_crceheadHashTable;
+    pVer->m_cbucketHashTableMax = (ULONG)pVer->m_crceheadHashTable;
+    for ( INT ihashsegment = 1; ihashsegment < chashsegmentMax; ihashsegment++ )
+    {
+        if ( pVer->m_cbucketHashTableMax * 2 > cbucketHashTableLimit )
+        {
+            break;
+        }
+        pVer->m_cbucketHashTableMax *= 2;
+    }
+
     return pVer;
 }
 
@@ -2324,6 +2654,7 @@ VOID VER::VERFree( VER * pVer )
         return;
     }
 
+    pVer->VERIFreeHashSegments();
     pVer->~VER();
     OSMemoryPageFree( pVer );
 }
@@ -2343,6 +2674,8 @@ ERR VER::ErrVERInit( INST* pinst )
     PERFOpt( cVERAsyncCleanupDispatched.Clear( m_pinst ) );
     PERFOpt( cVERCleanupDiscarded.Clear( m_pinst ) );
     PERFOpt( cVERCleanupFailed.Clear( m_pinst ) );
+    PERFOpt( cVERcbucketHashTable.Clear( m_pinst ) );
+    PERFOpt( cVERcbucketHashTable.Add( m_pinst, m_cbucketHashTable ) );
 
     AssertRTL( TrxCmp( trxMax, trxMax ) == 0 );
     AssertRTL( TrxCmp( trxMax, 0 ) > 0 );
@@ -2373,6 +2706,21 @@ ERR VER::ErrVERInit( INST* pinst )
     m_pbucketGlobalHead = pbucketNil;
     m_pbucketGlobalTail = pbucketNil;
 
+    if ( m_pinst->FRecovering()
+        || ( m_pinst->m_config & ( JET_configLowMemory | JET_configDynamicMediumMemory ) ) )
+    {
+        m_cbucketslot = 1;
+    }
+    else
+    {
+        m_cbucketslot = max( 1, min( (INT)cbucketslotMax, OSSyncGetProcessorCountMax() ) );
+    }
+    for ( INT ibucketslot = 0; ibucketslot < cbucketslotMax; ibucketslot++ )
+    {
+        Assert( pbucketNil == m_rgbucketslot[ ibucketslot ].pbucketActive );
+        m_rgbucketslot[ ibucketslot ].pbucketActive = pbucketNil;
+    }
+
     Assert( ppibNil == m_ppibRCEClean );
     Assert( ppibNil == m_ppibRCECleanCallback );
 
@@ -2484,6 +2832,11 @@ VOID VER::VERTerm( BOOL fNormal )
     m_pbucketGlobalHead = pbucketNil;
     m_pbucketGlobalTail = pbucketNil;
 
+    for ( INT ibucketslot = 0; ibucketslot < cbucketslotMax; ibucketslot++ )
+    {
+        m_rgbucketslot[ ibucketslot ].pbucketActive = pbucketNil;
+    }
+
     m_cresBucket.Term();
     if ( m_pinst->FRecovering() )
     {
@@ -2499,6 +2852,11 @@ VOID VER::VERTerm( BOOL fNormal )
     }
     m_frceHashTableInited = fFalse;
 
+    VERIFreeHashSegments();
+    m_cbucketHashTable = (ULONG)m_crceheadHashTable;
+    m_fHashTableGrowthRequested = fFalse;
+    m_crceHashChainLongest = 0;
+
     PERFOpt( cVERcbucketAllocated.Clear( m_pinst ) );
     PERFOpt( cVERcbucketDeleteAllocated.Clear( m_pinst ) );
     PERFOpt( cVERBucketAllocWaitForRCEClean.Clear( m_pinst ) );
@@ -2509,6 +2867,7 @@ VOID VER::VERTerm( BOOL fNormal )
     PERFOpt( cVERAsyncCleanupDispatched.Clear( m_pinst ) );
     PERFOpt( cVERCleanupDiscarded.Clear( m_pinst ) );
     PERFOpt( cVERCleanupFailed.Clear( m_pinst ) );
+    PERFOpt( cVERcbucketHashTable.Clear( m_pinst ) );
 }
 
 
@@ -2581,7 +2940,7 @@ ERR ErrVERAccessNode( FUCB * pfucb, const BOOKMARK& bookmark, NS * pns )
 
     const UINT uiHash = UiRCHashFunc( pfucb->ifmp, pfucb->u.pfcb->PgnoFDP(), bookmark );
 
-    if ( prceNil == PverFromIfmp( pfucb->ifmp )->GetChain( uiHash ) )
+    if ( PverFromIfmp( pfucb->ifmp )->FChainEmptyNoLock( uiHash ) )
     {
         PERFOpt( cVERUnnecessaryCalls.Inc( PinstFromPfucb( pfucb ) ) );
 
@@ -3703,7 +4062,7 @@ ERR VER::ErrVERModify(
     (*pprce)->GetBookmark( &bookmarkT );
     CallR( ErrCheckRCEChain(
         *PprceRCEChainGet( (*pprce)->UiHash(), (*pprce)->Ifmp(), (*pprce)->PgnoFDP(), bookmarkT ),
-        (*pprce)->UiHash() ) );
+        IbucketHashTable( (*pprce)->UiHash() ) ) );
 }
 #endif
 
@@ -3769,7 +4128,10 @@ ERR VER::ErrVERFlag( FUCB * pfucb, OPER oper, const VOID * pv, INT cb )
             0,
             oper,
             uiHashInvalid,
-            &prce
+            &prce,
+            fFalse,
+            rceidNull,
+            operDeleteTable == oper ? *(PGNO *)pv : pgnoNull
             ) );
     AssertPREFIX( prce );
 
@@ -4123,7 +4485,7 @@ BOOL FIsRCECleanup()
 
 BOOL FInCritBucket( VER *pver )
 {
-    return pver->m_critBucketGlobal.FOwner();
+    return pver->m_critBucketGlobal.FOwner() || pver->FInCritBucketSlot();
 }
 #endif
 
@@ -4342,6 +4704,21 @@ VOID VER::IncrementCCleanupFailed()
     PERFOpt( cVERCleanupFailed.Inc( m_pinst ) );
 }
 
+VOID VER::IncrementCCleanupPending()
+{
+    PERFOpt( cVERCleanupPending.Inc( m_pinst ) );
+}
+
+VOID VER::DecrementCCleanupPending()
+{
+    PERFOpt( cVERCleanupPending.Dec( m_pinst ) );
+}
+
+VOID VER::IncrementCCleanupCoalesced()
+{
+    PERFOpt( cVERCleanupCoalesced.Inc( m_pinst ) );
+}
+
 VOID VER::IncrementCCleanupDiscarded( const RCE * const prce )
 {
     if ( !prce->FOperNull() )
@@ -4781,6 +5158,141 @@ ERR RCE::ErrPrepareToDeallocate( TRX trxOldest )
 }
 
 
+//  the next bucket of the same slot, newer than the given one
+
+BUCKET *VER::PbucketVERINextInSlot( const BUCKET * const pbucket ) const
+{
+    Assert( m_critBucketGlobal.FOwner() );
+
+    BUCKET * pbucketNext = pbucket->hdr.pbucketNext;
+    while ( pbucketNil != pbucketNext && pbucketNext->hdr.ibucketslot != pbucket->hdr.ibucketslot )
+    {
+        pbucketNext = pbucketNext->hdr.pbucketNext;
+    }
+
+    return pbucketNext;
+}
+
+
+//  moves the cleanup position of a slot onto an RCE, freeing every bucket it runs off
+//  the end of; returns fFalse once the slot has no RCE left for this pass
+
+BOOL VER::FVERICleanPositionRCE( BUCKETSLOTCLEAN * const pbucketslotclean, RCEID * const prceid )
+{
+    Assert( m_critRCEClean.FOwner() );
+
+    while ( pbucketNil != pbucketslotclean->pbucket )
+    {
+        BUCKET * const      pbucket         = pbucketslotclean->pbucket;
+        CCriticalSection *  pcritBucketSlot = &m_rgbucketslot[ pbucket->hdr.ibucketslot ].crit;
+
+        //  once a bucket is no longer active nothing is appended to it, so it can be
+        //  read without the slot
+
+        pcritBucketSlot->Enter();
+        if ( !FVERIBucketActive( pbucket ) )
+        {
+            pcritBucketSlot->Leave();
+            pcritBucketSlot = NULL;
+        }
+
+        if ( !pbucketslotclean->fSkippedRCEInBucket )
+        {
+            pbucket->hdr.prceOldest = pbucketslotclean->prce;
+        }
+
+        Assert( pbucket->rgb <= pbucket->hdr.pbLastDelete );
+        Assert( pbucket->hdr.pbLastDelete <= reinterpret_cast<BYTE *>( pbucket->hdr.prceOldest ) );
+        Assert( pbucket->hdr.prceOldest <= pbucket->hdr.prceNextNew );
+
+        if ( pbucket->hdr.prceNextNew != pbucketslotclean->prce )
+        {
+            *prceid = pbucketslotclean->prce->Rceid();
+            if ( pcritBucketSlot )
+            {
+                pcritBucketSlot->Leave();
+            }
+            return fTrue;
+        }
+
+        m_critBucketGlobal.Enter();
+
+#ifdef VERPERF
+        ++m_cbucketSeen;
+#endif
+
+        BUCKET * const pbucketNext = PbucketVERINextInSlot( pbucket );
+
+        if ( !pbucketslotclean->fSkippedRCEInBucket )
+        {
+            Assert( pbucket->rgb == pbucket->hdr.pbLastDelete );
+
+            if ( pcritBucketSlot && FVERIBucketActive( pbucket ) )
+            {
+                m_rgbucketslot[ pbucket->hdr.ibucketslot ].pbucketActive = pbucketNil;
+            }
+
+            (VOID)PbucketVERIFreeAndGetNextOldestBucket( pbucket );
+
+#ifdef VERPERF
+            ++m_cbucketCleaned;
+#endif
+        }
+
+        m_critBucketGlobal.Leave();
+
+        if ( pcritBucketSlot )
+        {
+            pcritBucketSlot->Leave();
+        }
+
+        pbucketslotclean->pbucket               = pbucketNext;
+        pbucketslotclean->prce                  = ( pbucketNil != pbucketNext ) ? pbucketNext->hdr.prceOldest : prceNil;
+        pbucketslotclean->fSkippedRCEInBucket   = fFalse;
+    }
+
+    return fFalse;
+}
+
+
+//  picks the slot holding the oldest RCE, and the oldest RCE of all other slots as the
+//  limit up to which that slot may be cleaned; returns -1 if no slot has an RCE left
+
+INT VER::IbucketslotVERICleanNext(
+    const BOOL * const  rgfRceid,
+    const RCEID * const rgrceid,
+    const INT           cbucketslot,
+    BOOL * const        pfLimit,
+    RCEID * const       prceidLimit )
+{
+    INT ibucketslotOldest   = -1;
+    INT ibucketslotLimit    = -1;
+
+    for ( INT ibucketslot = 0; ibucketslot < cbucketslot; ibucketslot++ )
+    {
+        if ( !rgfRceid[ ibucketslot ] )
+        {
+            continue;
+        }
+
+        if ( ibucketslotOldest < 0 || RceidCmp( rgrceid[ ibucketslot ], rgrceid[ ibucketslotOldest ] ) < 0 )
+        {
+            ibucketslotLimit    = ibucketslotOldest;
+            ibucketslotOldest   = ibucketslot;
+        }
+        else if ( ibucketslotLimit < 0 || RceidCmp( rgrceid[ ibucketslot ], rgrceid[ ibucketslotLimit ] ) < 0 )
+        {
+            ibucketslotLimit    = ibucketslot;
+        }
+    }
+
+    *pfLimit        = ( ibucketslotLimit >= 0 );
+    *prceidLimit    = *pfLimit ? rgrceid[ ibucketslotLimit ] : rceidNull;
+
+    return ibucketslotOldest;
+}
+
+
 ERR VER::ErrVERRCEClean( const IFMP ifmp )
 {
 
@@ -4816,72 +5328,77 @@ ERR VER::ErrVERIRCEClean( const IFMP ifmp )
     m_crceDeleteLV      = 0;
 #endif
 
-    ERR         err     = JET_errSuccess;
-    BUCKET *    pbucket;
+    ERR                 err             = JET_errSuccess;
+    const INT           cbucketslot     = m_cbucketslot;
+    BUCKETSLOTCLEAN     rgbucketslotclean[ cbucketslotMax ];
+    BOOL                rgfRceid[ cbucketslotMax ];
+    RCEID               rgrceid[ cbucketslotMax ];
+    INT                 cbucketslotFound    = 0;
+
+    //  every slot starts at its oldest bucket
 
+    for ( INT ibucketslot = 0; ibucketslot < cbucketslotMax; ibucketslot++ )
+    {
+        rgbucketslotclean[ ibucketslot ].pbucket                = pbucketNil;
+        rgbucketslotclean[ ibucketslot ].prce                   = prceNil;
+        rgbucketslotclean[ ibucketslot ].fSkippedRCEInBucket    = fFalse;
+        rgfRceid[ ibucketslot ]                                 = fFalse;
+    }
 
     m_critBucketGlobal.Enter();
 
-    pbucket = PbucketVERIGetOldest();
+    for ( BUCKET * pbucketT = PbucketVERIGetOldest();
+          pbucketNil != pbucketT && cbucketslotFound < cbucketslot;
+          pbucketT = pbucketT->hdr.pbucketNext )
+    {
+        BUCKETSLOTCLEAN * const pbucketslotclean = &rgbucketslotclean[ pbucketT->hdr.ibucketslot ];
+        if ( pbucketNil == pbucketslotclean->pbucket )
+        {
+            pbucketslotclean->pbucket   = pbucketT;
+            pbucketslotclean->prce      = pbucketT->hdr.prceOldest;
+            cbucketslotFound++;
+        }
+    }
 
     m_critBucketGlobal.Leave();
 
-    TRX trxOldest = TrxOldest( m_pinst );
-
-    while ( pbucketNil != pbucket )
+    for ( INT ibucketslot = 0; ibucketslot < cbucketslot; ibucketslot++ )
     {
-#ifdef VERPERF
-        INT crceInBucketSeen    = 0;
-        INT crceInBucketCleaned = 0;
-#endif
+        rgfRceid[ ibucketslot ] = FVERICleanPositionRCE( &rgbucketslotclean[ ibucketslot ], &rgrceid[ ibucketslot ] );
+    }
 
+    TRX trxOldest = TrxOldest( m_pinst );
 
-        BOOL    fNeedBeInCritBucketGlobal   = ( pbucket->hdr.pbucketNext == pbucketNil );
+    //  always clean the slot holding the oldest RCE and only until it passes the next
+    //  oldest RCE of any other slot, so we stop at the same RCE a single bucket chain would
 
+    forever
+    {
+        BOOL        fLimit;
+        RCEID       rceidLimit;
+        const INT   ibucketslot = IbucketslotVERICleanNext( rgfRceid, rgrceid, cbucketslot, &fLimit, &rceidLimit );
 
-        Assert( m_critRCEClean.FOwner() );
-        RCE *   prce                        = pbucket->hdr.prceOldest;
-        BOOL    fSkippedRCEInBucket         = fFalse;
+        if ( ibucketslot < 0 )
+        {
+            break;
+        }
+
+        BUCKETSLOTCLEAN * const pbucketslotclean = &rgbucketslotclean[ ibucketslot ];
 
-        forever
+        do
         {
 #ifdef VERPERF
             ++m_crceSeen;
-            ++crceInBucketSeen;
 #endif
 
-            Assert( pbucket->rgb <= (BYTE*)prce );
-            Assert( (BYTE*)prce < (BYTE*)pbucket + m_cbBucket ||
-                    (   (BYTE*)prce == (BYTE*)pbucket + m_cbBucket &&
-                        prce == pbucket->hdr.prceNextNew ) );
-
-            if ( fNeedBeInCritBucketGlobal )
-            {
-                m_critBucketGlobal.Enter();
-            }
-
-            const BOOL  fRecalcOldestRCE    = ( !fSkippedRCEInBucket );
-
-            if ( fRecalcOldestRCE )
-            {
-                pbucket->hdr.prceOldest = prce;
-            }
-
-            Assert( pbucket->rgb <= pbucket->hdr.pbLastDelete );
-            Assert( pbucket->hdr.pbLastDelete <= reinterpret_cast<BYTE *>( pbucket->hdr.prceOldest ) );
-            Assert( pbucket->hdr.prceOldest <= pbucket->hdr.prceNextNew );
-
-            if ( pbucket->hdr.prceNextNew == prce )
-                break;
-
-            if ( fNeedBeInCritBucketGlobal )
-                m_critBucketGlobal.Leave();
-
-            const INT   cbRce = prce->CbRce();
+            BUCKET * const  pbucket = pbucketslotclean->pbucket;
+            RCE * const     prce    = pbucketslotclean->prce;
+            const INT       cbRce   = prce->CbRce();
 
             Assert( pbucket->rgb <= (BYTE*)prce );
             Assert( prce->CbRce() > 0 );
             Assert( (BYTE*)prce + prce->CbRce() <= (BYTE*)pbucket + m_cbBucket );
+            Assert( RceidCmp( prce->Rceid(), rgrceid[ ibucketslot ] ) == 0 );
 
             if ( !prce->FOperNull() )
             {
@@ -4937,7 +5454,7 @@ ERR VER::ErrVERIRCEClean( const IFMP ifmp )
                         }
                         else
                         {
-                            fSkippedRCEInBucket = fTrue;
+                            pbucketslotclean->fSkippedRCEInBucket = fTrue;
                             goto NextRCE;
                         }
                     }
@@ -4982,7 +5499,6 @@ ERR VER::ErrVERIRCEClean( const IFMP ifmp )
                 Call( prce->ErrPrepareToDeallocate( trxOldest ) );
 
 #ifdef VERPERF
-                ++crceInBucketCleaned;
                 ++m_crceCleaned;
 #endif
             }
@@ -4990,51 +5506,18 @@ ERR VER::ErrVERIRCEClean( const IFMP ifmp )
 NextRCE:
             Assert( m_critRCEClean.FOwner() );
 
+            pbucketslotclean->prce = (RCE *)PvAlignForThisPlatform( (BYTE *)prce + cbRce );
 
-            const BYTE  *pbRce      = reinterpret_cast<BYTE *>( prce );
-            const BYTE  *pbNextRce  = reinterpret_cast<BYTE *>( PvAlignForThisPlatform( pbRce + cbRce ) );
-
-            prce = (RCE *)pbNextRce;
-
-            Assert( pbucket->rgb <= (BYTE*)prce );
-            Assert( (BYTE*)prce < (BYTE*)pbucket + m_cbBucket ||
-                    (   (BYTE*)prce == (BYTE*)pbucket + m_cbBucket &&
-                        prce == pbucket->hdr.prceNextNew ) );
-
-            Assert( pbucket->hdr.prceOldest <= pbucket->hdr.prceNextNew );
-        }
-
-
-        if ( fNeedBeInCritBucketGlobal )
-            Assert( m_critBucketGlobal.FOwner() );
-        else
-            m_critBucketGlobal.Enter();
-
-#ifdef VERPERF
-        ++m_cbucketSeen;
-#endif
-
-        const BOOL  fRemainingRCEs  = ( fSkippedRCEInBucket );
+            Assert( pbucket->rgb <= (BYTE*)pbucketslotclean->prce );
+            Assert( (BYTE*)pbucketslotclean->prce < (BYTE*)pbucket + m_cbBucket ||
+                    (   (BYTE*)pbucketslotclean->prce == (BYTE*)pbucket + m_cbBucket &&
+                        pbucketslotclean->prce == pbucket->hdr.prceNextNew ) );
 
-        if ( fRemainingRCEs )
-        {
-            pbucket = pbucket->hdr.pbucketNext;
+            rgfRceid[ ibucketslot ] = FVERICleanPositionRCE( pbucketslotclean, &rgrceid[ ibucketslot ] );
         }
-        else
-        {
-            Assert( pbucket->rgb == pbucket->hdr.pbLastDelete );
-            pbucket = PbucketVERIFreeAndGetNextOldestBucket( pbucket );
-
-#ifdef VERPERF
-            ++m_cbucketCleaned;
-#endif
-        }
-
-        m_critBucketGlobal.Leave();
+        while ( rgfRceid[ ibucketslot ] && ( !fLimit || RceidCmp( rgrceid[ ibucketslot ], rceidLimit ) < 0 ) );
     }
 
-
-    Assert( pbucketNil == pbucket );
     err = JET_errSuccess;
 
     if ( !fCleanOneDb )
@@ -6733,3 +7216,92 @@ JETUNITTEST( VER, AnythingIsGreaterThanRceidNull )
     CHECK(RceidCmp(1,rceidNull) > 0);
 }
 
+
+#ifdef ENABLE_JET_UNIT_TEST
+
+//  replays a cleanup pass over two slots, the RCE with rceidBlocked can't be cleaned yet
+
+LOCAL INT CrceVERTestCleanPass( const RCEID * const rgrceid0, const INT crce0, const RCEID * const rgrceid1, const INT crce1, const RCEID rceidBlocked, INT * const pirce0, INT * const pirce1 )
+{
+    const RCEID *   rgprgrceid[ 2 ] = { rgrceid0, rgrceid1 };
+    const INT       rgcrce[ 2 ]     = { crce0, crce1 };
+    INT             rgirce[ 2 ]     = { 0, 0 };
+    BOOL            rgfRceid[ 2 ];
+    RCEID           rgrceid[ 2 ];
+    INT             crceCleaned     = 0;
+
+    for ( INT ibucketslot = 0; ibucketslot < 2; ibucketslot++ )
+    {
+        rgfRceid[ ibucketslot ] = ( rgcrce[ ibucketslot ] > 0 );
+        rgrceid[ ibucketslot ] = rgfRceid[ ibucketslot ] ? rgprgrceid[ ibucketslot ][ 0 ] : rceidNull;
+    }
+
+    forever
+    {
+        BOOL        fLimit;
+        RCEID       rceidLimit;
+        const INT   ibucketslot = VER::IbucketslotVERICleanNext( rgfRceid, rgrceid, 2, &fLimit, &rceidLimit );
+
+        if ( ibucketslot < 0 )
+        {
+            break;
+        }
+
+        do
+        {
+            if ( rgrceid[ ibucketslot ] == rceidBlocked )
+            {
+                goto Done;
+            }
+
+            crceCleaned++;
+            rgirce[ ibucketslot ]++;
+            rgfRceid[ ibucketslot ] = ( rgirce[ ibucketslot ] < rgcrce[ ibucketslot ] );
+            if ( rgfRceid[ ibucketslot ] )
+            {
+                rgrceid[ ibucketslot ] = rgprgrceid[ ibucketslot ][ rgirce[ ibucketslot ] ];
+            }
+        }
+        while ( rgfRceid[ ibucketslot ] && ( !fLimit || RceidCmp( rgrceid[ ibucketslot ], rceidLimit ) < 0 ) );
+    }
+
+Done:
+    *pirce0 = rgirce[ 0 ];
+    *pirce1 = rgirce[ 1 ];
+    return crceCleaned;
+}
+
+JETUNITTEST( VER, CleanupMergesBucketSlotsInRceidOrder )
+{
+    const RCEID rgrceid0[] = { 1, 2, 100 };
+    RCEID       rgrceid1[ 97 ];
+    const INT   crce0   = _countof( rgrceid0 );
+    const INT   crce1   = _countof( rgrceid1 );
+    INT         irce0;
+    INT         irce1;
+
+    for ( INT irce = 0; irce < crce1; irce++ )
+    {
+        rgrceid1[ irce ] = 3 + irce;
+    }
+
+    //  RCEs of another slot older than the blocked one are cleaned, even from buckets linked after it
+
+    CHECK( 2 + 97 == CrceVERTestCleanPass( rgrceid0, crce0, rgrceid1, crce1, 100, &irce0, &irce1 ) );
+    CHECK( 2 == irce0 );
+    CHECK( 97 == irce1 );
+
+    //  but everything newer than the blocked RCE stays, whatever slot it is in
+
+    CHECK( 2 + 47 == CrceVERTestCleanPass( rgrceid0, crce0, rgrceid1, crce1, 50, &irce0, &irce1 ) );
+    CHECK( 2 == irce0 );
+    CHECK( 47 == irce1 );
+
+    //  and nothing is left once nothing is blocked
+
+    CHECK( 3 + 97 == CrceVERTestCleanPass( rgrceid0, crce0, rgrceid1, crce1, rceidNull, &irce0, &irce1 ) );
+    CHECK( 3 == irce0 );
+    CHECK( 97 == irce1 );
+}
+
+#endif // ENABLE_JET_UNIT_TEST
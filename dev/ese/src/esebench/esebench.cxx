@@ -0,0 +1,1115 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#if defined(BUILD_ENV_IS_NT) || defined(BUILD_ENV_IS_WPHONE)
+#include "esent_x.h"
+#else
+#include "jet.h"
+#endif
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+
+#define BenchCallJ( func, label )                           \
+{                                                           \
+    err = (func);                                           \
+    if ( err < JET_errSuccess )                             \
+    {                                                       \
+        printf( "%s failed with %ld at line %d\n", #func, err, __LINE__ );  \
+        goto label;                                         \
+    }                                                       \
+}
+
+#define BenchCall( func )                   BenchCallJ( func, HandleError )
+
+//  the measured operations fail routinely with write conflicts and missing records; BenchThreadProc
+//  counts every failure, so they are not reported here
+
+#define BenchOpCall( func )                                 \
+{                                                           \
+    err = (func);                                           \
+    if ( err < JET_errSuccess )                             \
+    {                                                       \
+        goto HandleError;                                   \
+    }                                                       \
+}
+
+
+
+enum BENCHOP
+{
+    benchopSeek,
+    benchopScan,
+    benchopInsert,
+    benchopUpdate,
+    benchopLVRead,
+    benchopLVWrite,
+    benchopLongTrx,
+    benchopMax
+};
+
+const char * const g_rgszBenchOp[ benchopMax ] =
+{
+    "seek",
+    "scan",
+    "insert",
+    "update",
+    "lvread",
+    "lvwrite",
+    "longtrx",
+};
+
+struct BENCHWORKLOAD
+{
+    const char *    szName;
+    ULONG           rgpct[ benchopMax ];
+};
+
+const BENCHWORKLOAD g_rgworkload[] =
+{
+    { "A",      { 50,  0,  0, 50,  0,  0,  0 } },
+    { "B",      { 95,  0,  0,  5,  0,  0,  0 } },
+    { "C",      { 100, 0,  0,  0,  0,  0,  0 } },
+    { "D",      { 95,  0,  5,  0,  0,  0,  0 } },
+    { "E",      { 0,  95,  5,  0,  0,  0,  0 } },
+    { "mixed",  { 50, 10, 10, 15,  5,  5,  5 } },
+};
+
+struct BENCHCONFIG
+{
+    ULONG           cInstances;
+    ULONG           cSessionsPerInstance;
+    ULONG           csecWarmup;
+    ULONG           csecDuration;
+    ULONG           cRecords;
+    ULONG           cbData;
+    ULONG           cbLV;
+    ULONG           cScanMax;
+    ULONG           cOpsLongTrx;
+    ULONG           cpgCacheMax;
+    double          dblZipfTheta;
+    ULONG           rgpctMix[ benchopMax ];
+    WCHAR           wszDir[ MAX_PATH ];
+    const char *    szJsonFile;
+};
+
+BENCHCONFIG g_config =
+{
+    1,
+    8,
+    5,
+    30,
+    100000,
+    100,
+    2048,
+    100,
+    50,
+    0,
+    0.99,
+    { 50, 10, 10, 15,  5,  5,  5 },
+    L".",
+    NULL,
+};
+
+volatile LONG g_fMeasure    = FALSE;
+volatile LONG g_fStop       = FALSE;
+
+
+
+//  log-linear microsecond buckets:  one per microsecond below 8us, then two per power of two
+
+const ULONG cBucketLinear   = 8;
+const ULONG iOctaveMin      = 3;
+const ULONG iOctaveMax      = 30;
+const ULONG cBucket         = cBucketLinear + ( iOctaveMax - iOctaveMin + 1 ) * 2;
+
+ULONG IBucketFromCusec( const unsigned __int64 cusec )
+{
+    if ( cusec < cBucketLinear )
+    {
+        return (ULONG)cusec;
+    }
+
+    ULONG iOctave = 0;
+    for ( unsigned __int64 cusecT = cusec; cusecT > 1; cusecT >>= 1 )
+    {
+        iOctave++;
+    }
+    if ( iOctave > iOctaveMax )
+    {
+        return cBucket - 1;
+    }
+
+    return cBucketLinear + ( iOctave - iOctaveMin ) * 2 + (ULONG)( ( cusec >> ( iOctave - 1 ) ) & 1 );
+}
+
+unsigned __int64 CusecMaxFromIBucket( const ULONG iBucket )
+{
+    if ( iBucket < cBucketLinear )
+    {
+        return iBucket;
+    }
+
+    const ULONG iOctave = iOctaveMin + ( iBucket - cBucketLinear ) / 2;
+    const ULONG iSub    = ( iBucket - cBucketLinear ) % 2;
+    return ( ( (unsigned __int64)( 3 + iSub ) ) << ( iOctave - 1 ) ) - 1;
+}
+
+struct BENCHHISTO
+{
+    unsigned __int64    cSamples;
+    unsigned __int64    cusecTotal;
+    unsigned __int64    rgc[ cBucket ];
+
+    void Add( const unsigned __int64 cusec )
+    {
+        cSamples++;
+        cusecTotal += cusec;
+        rgc[ IBucketFromCusec( cusec ) ]++;
+    }
+
+    void Merge( const BENCHHISTO& histo )
+    {
+        cSamples += histo.cSamples;
+        cusecTotal += histo.cusecTotal;
+        for ( ULONG iBucket = 0; iBucket < cBucket; iBucket++ )
+        {
+            rgc[ iBucket ] += histo.rgc[ iBucket ];
+        }
+    }
+
+    unsigned __int64 CusecPercentile( const ULONG ulPermille ) const
+    {
+        if ( 0 == cSamples )
+        {
+            return 0;
+        }
+
+        unsigned __int64 cTarget = ( cSamples * ulPermille + 999 ) / 1000;
+        cTarget = cTarget ? cTarget : 1;
+
+        unsigned __int64 cSeen = 0;
+        for ( ULONG iBucket = 0; iBucket < cBucket; iBucket++ )
+        {
+            cSeen += rgc[ iBucket ];
+            if ( cSeen >= cTarget )
+            {
+                return CusecMaxFromIBucket( iBucket );
+            }
+        }
+        return CusecMaxFromIBucket( cBucket - 1 );
+    }
+};
+
+
+
+//  YCSB-style scrambled zipfian key chooser (Gray et al., "Quickly Generating Billion-Record Synthetic Databases")
+
+struct BENCHZIPF
+{
+    ULONG       cItems;
+    double      dblTheta;
+    double      dblAlpha;
+    double      dblZetan;
+    double      dblEta;
+
+    void Init( const ULONG cItemsInit, const double dblThetaInit )
+    {
+        cItems = cItemsInit;
+        dblTheta = dblThetaInit;
+        if ( dblTheta <= 0.0 )
+        {
+            return;
+        }
+
+        double dblZeta2 = 0.0;
+        dblZetan = 0.0;
+        for ( ULONG i = 1; i <= cItems; i++ )
+        {
+            dblZetan += 1.0 / pow( (double)i, dblTheta );
+            if ( i == 2 )
+            {
+                dblZeta2 = dblZetan;
+            }
+        }
+
+        dblAlpha = 1.0 / ( 1.0 - dblTheta );
+        dblEta = ( 1.0 - pow( 2.0 / cItems, 1.0 - dblTheta ) ) / ( 1.0 - dblZeta2 / dblZetan );
+    }
+
+    ULONG IItem( const double dblUniform ) const
+    {
+        if ( dblTheta <= 0.0 )
+        {
+            return (ULONG)( dblUniform * cItems ) % cItems;
+        }
+
+        ULONG iRank;
+        const double dblUz = dblUniform * dblZetan;
+        if ( dblUz < 1.0 )
+        {
+            iRank = 0;
+        }
+        else if ( dblUz < 1.0 + pow( 0.5, dblTheta ) )
+        {
+            iRank = 1;
+        }
+        else
+        {
+            iRank = (ULONG)( cItems * pow( dblEta * dblUniform - dblEta + 1.0, dblAlpha ) );
+        }
+
+        unsigned __int64 qwHash = 14695981039346656037ULL;
+        for ( INT ib = 0; ib < sizeof( iRank ); ib++ )
+        {
+            qwHash ^= ( iRank >> ( ib * 8 ) ) & 0xFF;
+            qwHash *= 1099511628211ULL;
+        }
+        return (ULONG)( qwHash % cItems );
+    }
+};
+
+BENCHZIPF g_zipf;
+
+
+
+struct BENCHINSTANCE
+{
+    JET_INSTANCE        inst;
+    ULONG               iInstance;
+    WCHAR               wszDatabase[ MAX_PATH ];
+    volatile LONG64     keyNext;
+};
+
+struct BENCHTHREAD
+{
+    BENCHINSTANCE *     pbinst;
+    HANDLE              hThread;
+    unsigned __int64    qwRandom;
+
+    JET_SESID           sesid;
+    JET_DBID            dbid;
+    JET_TABLEID         tableid;
+    JET_COLUMNID        columnidKey;
+    JET_COLUMNID        columnidData;
+    JET_COLUMNID        columnidSec;
+    JET_COLUMNID        columnidLV;
+
+    BYTE *              pbData;
+    BYTE *              pbLV;
+
+    BENCHHISTO          rghisto[ benchopMax ];
+    unsigned __int64    cErrors;
+    unsigned __int64    cConflicts;
+    JET_THREADSTATS2    tsStart;
+    JET_THREADSTATS2    tsEnd;
+    JET_ERR             errFatal;
+};
+
+unsigned __int64 QwBenchRandom( BENCHTHREAD * const pbt )
+{
+    unsigned __int64 qw = pbt->qwRandom;
+    qw ^= qw << 13;
+    qw ^= qw >> 7;
+    qw ^= qw << 17;
+    pbt->qwRandom = qw;
+    return qw;
+}
+
+double DblBenchUniform( BENCHTHREAD * const pbt )
+{
+    return (double)( QwBenchRandom( pbt ) >> 11 ) / (double)( 1ULL << 53 );
+}
+
+unsigned __int64 CusecElapsed( const LARGE_INTEGER& liStart, const LARGE_INTEGER& liEnd )
+{
+    static LARGE_INTEGER s_liFreq = { 0 };
+    if ( 0 == s_liFreq.QuadPart )
+    {
+        QueryPerformanceFrequency( &s_liFreq );
+    }
+    return (unsigned __int64)( ( liEnd.QuadPart - liStart.QuadPart ) * 1000000 / s_liFreq.QuadPart );
+}
+
+
+
+JET_ERR ErrBenchOpenTable( BENCHTHREAD * const pbt )
+{
+    JET_ERR         err = JET_errSuccess;
+    JET_COLUMNDEF   columndef;
+
+    BenchCall( JetBeginSessionW( pbt->pbinst->inst, &pbt->sesid, NULL, NULL ) );
+    BenchCall( JetOpenDatabaseW( pbt->sesid, pbt->pbinst->wszDatabase, NULL, &pbt->dbid, JET_bitNil ) );
+    BenchCall( JetOpenTableA( pbt->sesid, pbt->dbid, "records", NULL, 0, JET_bitNil, &pbt->tableid ) );
+
+    BenchCall( JetGetTableColumnInfoA( pbt->sesid, pbt->tableid, "key", &columndef, sizeof( columndef ), JET_ColInfo ) );
+    pbt->columnidKey = columndef.columnid;
+    BenchCall( JetGetTableColumnInfoA( pbt->sesid, pbt->tableid, "data", &columndef, sizeof( columndef ), JET_ColInfo ) );
+    pbt->columnidData = columndef.columnid;
+    BenchCall( JetGetTableColumnInfoA( pbt->sesid, pbt->tableid, "sec", &columndef, sizeof( columndef ), JET_ColInfo ) );
+    pbt->columnidSec = columndef.columnid;
+    BenchCall( JetGetTableColumnInfoA( pbt->sesid, pbt->tableid, "lv", &columndef, sizeof( columndef ), JET_ColInfo ) );
+    pbt->columnidLV = columndef.columnid;
+
+HandleError:
+    return err;
+}
+
+void BenchCloseTable( BENCHTHREAD * const pbt )
+{
+    if ( JET_sesidNil != pbt->sesid )
+    {
+        (void)JetEndSession( pbt->sesid, JET_bitNil );
+        pbt->sesid = JET_sesidNil;
+    }
+}
+
+JET_ERR ErrBenchSeekKey( BENCHTHREAD * const pbt, const __int64 key, const JET_GRBIT grbitSeek )
+{
+    JET_ERR err = JET_errSuccess;
+
+    BenchOpCall( JetMakeKey( pbt->sesid, pbt->tableid, &key, sizeof( key ), JET_bitNewKey ) );
+    err = JetSeek( pbt->sesid, pbt->tableid, grbitSeek );
+
+HandleError:
+    return err;
+}
+
+JET_ERR ErrBenchSetRecord( BENCHTHREAD * const pbt, const __int64 key, const BOOL fLV )
+{
+    JET_ERR     err = JET_errSuccess;
+    const LONG  sec = (LONG)( QwBenchRandom( pbt ) % g_config.cRecords );
+
+    for ( ULONG ib = 0; ib < g_config.cbData; ib += sizeof( unsigned __int64 ) )
+    {
+        *(unsigned __int64 *)( pbt->pbData + ib ) = QwBenchRandom( pbt );
+    }
+
+    BenchOpCall( JetSetColumn( pbt->sesid, pbt->tableid, pbt->columnidKey, &key, sizeof( key ), JET_bitNil, NULL ) );
+    BenchOpCall( JetSetColumn( pbt->sesid, pbt->tableid, pbt->columnidData, pbt->pbData, g_config.cbData, JET_bitNil, NULL ) );
+    BenchOpCall( JetSetColumn( pbt->sesid, pbt->tableid, pbt->columnidSec, &sec, sizeof( sec ), JET_bitNil, NULL ) );
+    if ( fLV && g_config.cbLV > 0 )
+    {
+        BenchOpCall( JetSetColumn( pbt->sesid, pbt->tableid, pbt->columnidLV, pbt->pbLV, g_config.cbLV, JET_bitNil, NULL ) );
+    }
+
+HandleError:
+    return err;
+}
+
+JET_ERR ErrBenchUpdateRecord( BENCHTHREAD * const pbt, const __int64 key, const BOOL fLV )
+{
+    JET_ERR err = JET_errSuccess;
+
+    BenchOpCall( ErrBenchSeekKey( pbt, key, JET_bitSeekEQ ) );
+    BenchOpCall( JetPrepareUpdate( pbt->sesid, pbt->tableid, JET_prepReplace ) );
+
+    for ( ULONG ib = 0; ib < g_config.cbData; ib += sizeof( unsigned __int64 ) )
+    {
+        *(unsigned __int64 *)( pbt->pbData + ib ) = QwBenchRandom( pbt );
+    }
+    if ( fLV )
+    {
+        pbt->pbLV[ QwBenchRandom( pbt ) % g_config.cbLV ]++;
+        BenchOpCall( JetSetColumn( pbt->sesid, pbt->tableid, pbt->columnidLV, pbt->pbLV, g_config.cbLV, JET_bitNil, NULL ) );
+    }
+    else
+    {
+        BenchOpCall( JetSetColumn( pbt->sesid, pbt->tableid, pbt->columnidData, pbt->pbData, g_config.cbData, JET_bitNil, NULL ) );
+    }
+
+    BenchOpCall( JetUpdate( pbt->sesid, pbt->tableid, NULL, 0, NULL ) );
+
+HandleError:
+    if ( err < JET_errSuccess )
+    {
+        (void)JetPrepareUpdate( pbt->sesid, pbt->tableid, JET_prepCancel );
+    }
+    return err;
+}
+
+JET_ERR ErrBenchOp( BENCHTHREAD * const pbt, const BENCHOP benchop )
+{
+    JET_ERR         err         = JET_errSuccess;
+    BOOL            fInTrx      = FALSE;
+    const __int64   key         = g_zipf.IItem( DblBenchUniform( pbt ) );
+    ULONG           cbActual    = 0;
+
+    switch ( benchop )
+    {
+        case benchopSeek:
+            BenchOpCall( ErrBenchSeekKey( pbt, key, JET_bitSeekEQ ) );
+            BenchOpCall( JetRetrieveColumn( pbt->sesid, pbt->tableid, pbt->columnidData, pbt->pbData, g_config.cbData, &cbActual, JET_bitNil, NULL ) );
+            break;
+
+        case benchopScan:
+        {
+            const ULONG cScan = 1 + (ULONG)( QwBenchRandom( pbt ) % g_config.cScanMax );
+            BenchOpCall( ErrBenchSeekKey( pbt, key, JET_bitSeekGE ) );
+            for ( ULONG iScan = 0; iScan < cScan; iScan++ )
+            {
+                BenchOpCall( JetRetrieveColumn( pbt->sesid, pbt->tableid, pbt->columnidData, pbt->pbData, g_config.cbData, &cbActual, JET_bitNil, NULL ) );
+                err = JetMove( pbt->sesid, pbt->tableid, JET_MoveNext, JET_bitNil );
+                if ( JET_errNoCurrentRecord == err )
+                {
+                    err = JET_errSuccess;
+                    break;
+                }
+                BenchOpCall( err );
+            }
+            break;
+        }
+
+        case benchopInsert:
+        {
+            const __int64 keyInsert = InterlockedIncrement64( &pbt->pbinst->keyNext );
+            BenchOpCall( JetBeginTransaction( pbt->sesid ) );
+            fInTrx = TRUE;
+            BenchOpCall( JetPrepareUpdate( pbt->sesid, pbt->tableid, JET_prepInsert ) );
+            err = ErrBenchSetRecord( pbt, keyInsert, FALSE );
+            if ( err >= JET_errSuccess )
+            {
+                err = JetUpdate( pbt->sesid, pbt->tableid, NULL, 0, NULL );
+            }
+            if ( err < JET_errSuccess )
+            {
+                (void)JetPrepareUpdate( pbt->sesid, pbt->tableid, JET_prepCancel );
+                goto HandleError;
+            }
+            BenchOpCall( JetCommitTransaction( pbt->sesid, JET_bitCommitLazyFlush ) );
+            fInTrx = FALSE;
+            break;
+        }
+
+        case benchopUpdate:
+        case benchopLVWrite:
+            BenchOpCall( JetBeginTransaction( pbt->sesid ) );
+            fInTrx = TRUE;
+            BenchOpCall( ErrBenchUpdateRecord( pbt, key, benchopLVWrite == benchop ) );
+            BenchOpCall( JetCommitTransaction( pbt->sesid, JET_bitCommitLazyFlush ) );
+            fInTrx = FALSE;
+            break;
+
+        case benchopLVRead:
+            BenchOpCall( ErrBenchSeekKey( pbt, key, JET_bitSeekEQ ) );
+            BenchOpCall( JetRetrieveColumn( pbt->sesid, pbt->tableid, pbt->columnidLV, pbt->pbLV, g_config.cbLV, &cbActual, JET_bitNil, NULL ) );
+            break;
+
+        case benchopLongTrx:
+            BenchOpCall( JetBeginTransaction( pbt->sesid ) );
+            fInTrx = TRUE;
+            for ( ULONG iOp = 0; iOp < g_config.cOpsLongTrx; iOp++ )
+            {
+                BenchOpCall( ErrBenchUpdateRecord( pbt, g_zipf.IItem( DblBenchUniform( pbt ) ), FALSE ) );
+            }
+            BenchOpCall( JetCommitTransaction( pbt->sesid, JET_bitCommitLazyFlush ) );
+            fInTrx = FALSE;
+            break;
+
+        default:
+            err = JET_errInvalidParameter;
+            break;
+    }
+
+HandleError:
+    if ( fInTrx )
+    {
+        (void)JetRollback( pbt->sesid, JET_bitNil );
+    }
+    return err;
+}
+
+DWORD WINAPI BenchThreadProc( void * const pv )
+{
+    BENCHTHREAD * const pbt         = (BENCHTHREAD *)pv;
+    JET_ERR             err         = JET_errSuccess;
+    BOOL                fMeasuring  = FALSE;
+
+    BenchCall( ErrBenchOpenTable( pbt ) );
+
+    while ( !g_fStop )
+    {
+        ULONG pct = (ULONG)( QwBenchRandom( pbt ) % 100 );
+        BENCHOP benchop = benchopSeek;
+        for ( INT iop = 0; iop < benchopMax; iop++ )
+        {
+            if ( pct < g_config.rgpctMix[ iop ] )
+            {
+                benchop = (BENCHOP)iop;
+                break;
+            }
+            pct -= g_config.rgpctMix[ iop ];
+        }
+
+        if ( !fMeasuring && g_fMeasure )
+        {
+            pbt->tsStart.cbStruct = sizeof( pbt->tsStart );
+            (void)JetGetThreadStats( &pbt->tsStart, sizeof( pbt->tsStart ) );
+            fMeasuring = TRUE;
+        }
+
+        LARGE_INTEGER liStart;
+        LARGE_INTEGER liEnd;
+        QueryPerformanceCounter( &liStart );
+        const JET_ERR errOp = ErrBenchOp( pbt, benchop );
+        QueryPerformanceCounter( &liEnd );
+
+        if ( fMeasuring )
+        {
+            if ( JET_errWriteConflict == errOp )
+            {
+                pbt->cConflicts++;
+            }
+            else if ( errOp < JET_errSuccess )
+            {
+                pbt->cErrors++;
+            }
+            else
+            {
+                pbt->rghisto[ benchop ].Add( CusecElapsed( liStart, liEnd ) );
+            }
+        }
+    }
+
+    pbt->tsEnd.cbStruct = sizeof( pbt->tsEnd );
+    (void)JetGetThreadStats( &pbt->tsEnd, sizeof( pbt->tsEnd ) );
+    if ( !fMeasuring )
+    {
+        pbt->tsStart = pbt->tsEnd;
+    }
+
+HandleError:
+    pbt->errFatal = err;
+    BenchCloseTable( pbt );
+    return 0;
+}
+
+
+
+JET_ERR ErrBenchCreateDatabase( BENCHINSTANCE * const pbinst )
+{
+    JET_ERR         err         = JET_errSuccess;
+    JET_SESID       sesid       = JET_sesidNil;
+    JET_DBID        dbid        = JET_dbidNil;
+    JET_TABLEID     tableid     = JET_tableidNil;
+    JET_COLUMNDEF   columndef   = { sizeof( JET_COLUMNDEF ) };
+    JET_COLUMNID    columnid;
+
+    BenchCall( JetBeginSessionW( pbinst->inst, &sesid, NULL, NULL ) );
+    BenchCall( JetCreateDatabaseW( sesid, pbinst->wszDatabase, NULL, &dbid, JET_bitNil ) );
+    BenchCall( JetCreateTableA( sesid, dbid, "records", 16, 100, &tableid ) );
+
+    columndef.coltyp = JET_coltypLongLong;
+    columndef.grbit = JET_bitColumnFixed;
+    BenchCall( JetAddColumnA( sesid, tableid, "key", &columndef, NULL, 0, &columnid ) );
+
+    columndef.coltyp = JET_coltypBinary;
+    columndef.grbit = JET_bitNil;
+    columndef.cbMax = 255;
+    BenchCall( JetAddColumnA( sesid, tableid, "data", &columndef, NULL, 0, &columnid ) );
+
+    columndef.coltyp = JET_coltypLong;
+    columndef.grbit = JET_bitColumnFixed;
+    columndef.cbMax = 0;
+    BenchCall( JetAddColumnA( sesid, tableid, "sec", &columndef, NULL, 0, &columnid ) );
+
+    columndef.coltyp = JET_coltypLongBinary;
+    columndef.grbit = JET_bitColumnTagged;
+    BenchCall( JetAddColumnA( sesid, tableid, "lv", &columndef, NULL, 0, &columnid ) );
+
+    BenchCall( JetCreateIndexA( sesid, tableid, "primary", JET_bitIndexPrimary, "+key\0", 6, 100 ) );
+    BenchCall( JetCreateIndexA( sesid, tableid, "secondary", JET_bitNil, "+sec\0", 6, 90 ) );
+
+    BenchCall( JetCloseTable( sesid, tableid ) );
+    tableid = JET_tableidNil;
+    BenchCall( JetCloseDatabase( sesid, dbid, JET_bitNil ) );
+    dbid = JET_dbidNil;
+
+HandleError:
+    if ( JET_tableidNil != tableid )
+    {
+        (void)JetCloseTable( sesid, tableid );
+    }
+    if ( JET_dbidNil != dbid )
+    {
+        (void)JetCloseDatabase( sesid, dbid, JET_bitNil );
+    }
+    if ( JET_sesidNil != sesid )
+    {
+        (void)JetEndSession( sesid, JET_bitNil );
+    }
+    return err;
+}
+
+JET_ERR ErrBenchLoad( BENCHINSTANCE * const pbinst, BENCHTHREAD * const pbt )
+{
+    JET_ERR     err         = JET_errSuccess;
+    BOOL        fInTrx      = FALSE;
+    const ULONG cPerTrx     = 100;
+
+    BenchCall( ErrBenchOpenTable( pbt ) );
+
+    for ( ULONG iRecord = 0; iRecord < g_config.cRecords; iRecord++ )
+    {
+        if ( !fInTrx )
+        {
+            BenchCall( JetBeginTransaction( pbt->sesid ) );
+            fInTrx = TRUE;
+        }
+
+        BenchCall( JetPrepareUpdate( pbt->sesid, pbt->tableid, JET_prepInsert ) );
+        BenchCall( ErrBenchSetRecord( pbt, iRecord, TRUE ) );
+        BenchCall( JetUpdate( pbt->sesid, pbt->tableid, NULL, 0, NULL ) );
+
+        if ( iRecord % cPerTrx == cPerTrx - 1 )
+        {
+            BenchCall( JetCommitTransaction( pbt->sesid, JET_bitCommitLazyFlush ) );
+            fInTrx = FALSE;
+        }
+    }
+
+    if ( fInTrx )
+    {
+        BenchCall( JetCommitTransaction( pbt->sesid, JET_bitNil ) );
+        fInTrx = FALSE;
+    }
+
+    pbinst->keyNext = g_config.cRecords;
+
+HandleError:
+    if ( fInTrx )
+    {
+        (void)JetRollback( pbt->sesid, JET_bitNil );
+    }
+    BenchCloseTable( pbt );
+    return err;
+}
+
+JET_ERR ErrBenchInitInstance( BENCHINSTANCE * const pbinst, const ULONG iInstance )
+{
+    JET_ERR err = JET_errSuccess;
+    WCHAR   wszName[ 32 ];
+    WCHAR   wszPath[ MAX_PATH ];
+
+    pbinst->iInstance = iInstance;
+    swprintf_s( wszName, _countof( wszName ), L"esebench%u", iInstance );
+    swprintf_s( wszPath, _countof( wszPath ), L"%s\\%s\\", g_config.wszDir, wszName );
+    swprintf_s( pbinst->wszDatabase, _countof( pbinst->wszDatabase ), L"%s%s.edb", wszPath, wszName );
+
+    BenchCall( JetCreateInstance2W( &pbinst->inst, wszName, wszName, JET_bitNil ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramCreatePathIfNotExist, TRUE, NULL ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramSystemPath, 0, wszPath ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramLogFilePath, 0, wszPath ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramTempPath, 0, wszPath ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramBaseName, 0, L"edb" ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramCircularLog, TRUE, NULL ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramNoInformationEvent, TRUE, NULL ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramMaxSessions, g_config.cSessionsPerInstance + 4, NULL ) );
+    BenchCall( JetSetSystemParameterW( &pbinst->inst, JET_sesidNil, JET_paramMaxVerPages, 1024 * ( g_config.cSessionsPerInstance + 4 ), NULL ) );
+    BenchCall( JetInit3W( &pbinst->inst, NULL, JET_bitNil ) );
+
+    BenchCall( ErrBenchCreateDatabase( pbinst ) );
+
+HandleError:
+    return err;
+}
+
+
+
+void BenchReport( BENCHTHREAD * const rgbt, const ULONG cbt, const double dblSeconds )
+{
+    BENCHHISTO          rghisto[ benchopMax ];
+    unsigned __int64    cErrors         = 0;
+    unsigned __int64    cConflicts      = 0;
+    unsigned __int64    cPageReferenced = 0;
+    unsigned __int64    cPageCacheMiss  = 0;
+    unsigned __int64    cbLogRecord     = 0;
+    unsigned __int64    cOps            = 0;
+
+    memset( rghisto, 0, sizeof( rghisto ) );
+
+    for ( ULONG ibt = 0; ibt < cbt; ibt++ )
+    {
+        const BENCHTHREAD * const pbt = &rgbt[ ibt ];
+        for ( INT iop = 0; iop < benchopMax; iop++ )
+        {
+            rghisto[ iop ].Merge( pbt->rghisto[ iop ] );
+        }
+        cErrors         += pbt->cErrors;
+        cConflicts      += pbt->cConflicts;
+        cPageReferenced += (ULONG)( pbt->tsEnd.cPageReferenced - pbt->tsStart.cPageReferenced );
+        cPageCacheMiss  += (ULONG)( pbt->tsEnd.cPageCacheMiss - pbt->tsStart.cPageCacheMiss );
+        cbLogRecord     += (ULONG)( pbt->tsEnd.cbLogRecord - pbt->tsStart.cbLogRecord );
+    }
+    for ( INT iop = 0; iop < benchopMax; iop++ )
+    {
+        cOps += rghisto[ iop ].cSamples;
+    }
+
+    const double dblHitRate     = cPageReferenced ? 100.0 * (double)( cPageReferenced - min( cPageCacheMiss, cPageReferenced ) ) / (double)cPageReferenced : 100.0;
+    const double dblLogPerOp    = cOps ? (double)cbLogRecord / (double)cOps : 0.0;
+
+    printf( "\n%-10s %12s %12s %10s %10s %10s %10s\n", "op", "count", "ops/sec", "avg(us)", "p50(us)", "p99(us)", "p999(us)" );
+    for ( INT iop = 0; iop < benchopMax; iop++ )
+    {
+        const BENCHHISTO& histo = rghisto[ iop ];
+        if ( 0 == histo.cSamples )
+        {
+            continue;
+        }
+        printf( "%-10s %12I64u %12.1f %10.1f %10I64u %10I64u %10I64u\n",
+                g_rgszBenchOp[ iop ],
+                histo.cSamples,
+                (double)histo.cSamples / dblSeconds,
+                (double)histo.cusecTotal / (double)histo.cSamples,
+                histo.CusecPercentile( 500 ),
+                histo.CusecPercentile( 990 ),
+                histo.CusecPercentile( 999 ) );
+    }
+    printf( "\nTotal: %I64u ops in %.1f s (%.1f ops/sec), %I64u errors, %I64u write conflicts\n", cOps, dblSeconds, (double)cOps / dblSeconds, cErrors, cConflicts );
+    printf( "Cache hit rate: %.2f%%, log bytes per op: %.1f\n", dblHitRate, dblLogPerOp );
+
+    if ( g_config.szJsonFile )
+    {
+        FILE * pfile = NULL;
+        (void)fopen_s( &pfile, g_config.szJsonFile, "at" );
+        if ( NULL == pfile )
+        {
+            printf( "Could not open %s\n", g_config.szJsonFile );
+            return;
+        }
+
+        fprintf( pfile, "{\"instances\":%lu,\"sessions\":%lu,\"records\":%lu,\"seconds\":%.3f,\"ops\":%I64u,\"ops_per_sec\":%.3f,\"errors\":%I64u,\"conflicts\":%I64u,\"cache_hit_pct\":%.3f,\"log_bytes_per_op\":%.3f,\"latency\":{",
+                 g_config.cInstances,
+                 g_config.cSessionsPerInstance,
+                 g_config.cRecords,
+                 dblSeconds,
+                 cOps,
+                 (double)cOps / dblSeconds,
+                 cErrors,
+                 cConflicts,
+                 dblHitRate,
+                 dblLogPerOp );
+        BOOL fFirst = TRUE;
+        for ( INT iop = 0; iop < benchopMax; iop++ )
+        {
+            const BENCHHISTO& histo = rghisto[ iop ];
+            if ( 0 == histo.cSamples )
+            {
+                continue;
+            }
+            fprintf( pfile, "%s\"%s\":{\"count\":%I64u,\"p50_us\":%I64u,\"p99_us\":%I64u,\"p999_us\":%I64u}",
+                     fFirst ? "" : ",",
+                     g_rgszBenchOp[ iop ],
+                     histo.cSamples,
+                     histo.CusecPercentile( 500 ),
+                     histo.CusecPercentile( 990 ),
+                     histo.CusecPercentile( 999 ) );
+            fFirst = FALSE;
+        }
+        fprintf( pfile, "}}\n" );
+        fclose( pfile );
+    }
+}
+
+JET_ERR ErrBenchRun()
+{
+    JET_ERR             err         = JET_errSuccess;
+    BENCHINSTANCE *     rgbinst     = NULL;
+    BENCHTHREAD *       rgbt        = NULL;
+    const ULONG         cbt         = g_config.cInstances * g_config.cSessionsPerInstance;
+    ULONG               cbtStarted  = 0;
+    JET_INSTANCE        instNil     = JET_instanceNil;
+    LARGE_INTEGER       liStart;
+    LARGE_INTEGER       liEnd;
+
+    if ( g_config.cpgCacheMax )
+    {
+        BenchCall( JetSetSystemParameterW( &instNil, JET_sesidNil, JET_paramCacheSizeMax, g_config.cpgCacheMax, NULL ) );
+    }
+
+    rgbinst = (BENCHINSTANCE *)calloc( g_config.cInstances, sizeof( BENCHINSTANCE ) );
+    rgbt = (BENCHTHREAD *)calloc( cbt, sizeof( BENCHTHREAD ) );
+    if ( NULL == rgbinst || NULL == rgbt )
+    {
+        BenchCall( JET_errOutOfMemory );
+    }
+
+    for ( ULONG ibt = 0; ibt < cbt; ibt++ )
+    {
+        BENCHTHREAD * const pbt = &rgbt[ ibt ];
+        pbt->pbinst     = &rgbinst[ ibt / g_config.cSessionsPerInstance ];
+        pbt->qwRandom   = 0x9E3779B97F4A7C15ULL * ( ibt + 1 );
+        pbt->sesid      = JET_sesidNil;
+        pbt->pbData     = (BYTE *)calloc( g_config.cbData + sizeof( unsigned __int64 ), 1 );
+        pbt->pbLV       = (BYTE *)calloc( g_config.cbLV + 1, 1 );
+        if ( NULL == pbt->pbData || NULL == pbt->pbLV )
+        {
+            BenchCall( JET_errOutOfMemory );
+        }
+    }
+
+    g_zipf.Init( g_config.cRecords, g_config.dblZipfTheta );
+
+    for ( ULONG iInstance = 0; iInstance < g_config.cInstances; iInstance++ )
+    {
+        printf( "Loading %lu records into instance %lu...\n", g_config.cRecords, iInstance );
+        BenchCall( ErrBenchInitInstance( &rgbinst[ iInstance ], iInstance ) );
+        BenchCall( ErrBenchLoad( &rgbinst[ iInstance ], &rgbt[ iInstance * g_config.cSessionsPerInstance ] ) );
+    }
+
+    for ( cbtStarted = 0; cbtStarted < cbt; cbtStarted++ )
+    {
+        rgbt[ cbtStarted ].hThread = CreateThread( NULL, 0, BenchThreadProc, &rgbt[ cbtStarted ], 0, NULL );
+        if ( NULL == rgbt[ cbtStarted ].hThread )
+        {
+            BenchCall( JET_errOutOfThreads );
+        }
+    }
+
+    printf( "Warming up for %lu s...\n", g_config.csecWarmup );
+    Sleep( g_config.csecWarmup * 1000 );
+
+    printf( "Measuring for %lu s...\n", g_config.csecDuration );
+    QueryPerformanceCounter( &liStart );
+    InterlockedExchange( &g_fMeasure, TRUE );
+    Sleep( g_config.csecDuration * 1000 );
+    InterlockedExchange( &g_fStop, TRUE );
+    QueryPerformanceCounter( &liEnd );
+
+HandleError:
+    InterlockedExchange( &g_fStop, TRUE );
+    for ( ULONG ibt = 0; ibt < cbtStarted; ibt++ )
+    {
+        WaitForSingleObject( rgbt[ ibt ].hThread, INFINITE );
+        CloseHandle( rgbt[ ibt ].hThread );
+        if ( rgbt[ ibt ].errFatal < JET_errSuccess && err >= JET_errSuccess )
+        {
+            err = rgbt[ ibt ].errFatal;
+        }
+    }
+
+    if ( err >= JET_errSuccess )
+    {
+        BenchReport( rgbt, cbt, (double)CusecElapsed( liStart, liEnd ) / 1000000.0 );
+    }
+
+    for ( ULONG iInstance = 0; rgbinst && iInstance < g_config.cInstances; iInstance++ )
+    {
+        if ( rgbinst[ iInstance ].inst )
+        {
+            (void)JetTerm2( rgbinst[ iInstance ].inst, JET_bitTermComplete );
+        }
+    }
+    for ( ULONG ibt = 0; rgbt && ibt < cbt; ibt++ )
+    {
+        free( rgbt[ ibt ].pbData );
+        free( rgbt[ ibt ].pbLV );
+    }
+    free( rgbt );
+    free( rgbinst );
+
+    return err;
+}
+
+
+
+void PrintHelpEseBench( _In_ const char* szExecutable )
+{
+    printf( "Usage: %s [options]\n", szExecutable );
+    printf( "   -dir <path>          Directory for databases and logs (default: .)\n"
+            "   -instances <n>       Number of instances (default: 1)\n"
+            "   -sessions <n>        Sessions (threads) per instance (default: 8)\n"
+            "   -records <n>         Records loaded per instance (default: 100000)\n"
+            "   -data <cb>           Bytes in the fixed data column (default: 100, max 255)\n"
+            "   -lv <cb>             Bytes in the long value column (default: 2048)\n"
+            "   -scan <n>            Maximum records per range scan (default: 100)\n"
+            "   -trx <n>             Updates per long transaction (default: 50)\n"
+            "   -cache <pages>       JET_paramCacheSizeMax (default: engine default)\n"
+            "   -zipf <theta>        Key skew in [0, 1), 0 for uniform (default: 0.99)\n"
+            "   -warmup <sec>        Seconds before measuring (default: 5)\n"
+            "   -duration <sec>      Seconds to measure (default: 30)\n"
+            "   -workload <name>     A, B, C, D, E (YCSB core mixes) or mixed (default)\n"
+            "   -mix <op>=<pct>,...  Custom mix of seek, scan, insert, update, lvread,\n"
+            "                        lvwrite, longtrx; percentages must add up to 100\n"
+            "   -json <file>         Append one JSON result line to <file>\n"
+            "\n" );
+}
+
+BOOL FBenchParseMix( const char * const szMix )
+{
+    ULONG rgpct[ benchopMax ] = { 0 };
+    ULONG pctTotal = 0;
+    const char * sz = szMix;
+
+    while ( *sz )
+    {
+        INT iop;
+        for ( iop = 0; iop < benchopMax; iop++ )
+        {
+            const size_t cch = strlen( g_rgszBenchOp[ iop ] );
+            if ( 0 == _strnicmp( sz, g_rgszBenchOp[ iop ], cch ) && '=' == sz[ cch ] )
+            {
+                sz += cch + 1;
+                break;
+            }
+        }
+        if ( iop == benchopMax )
+        {
+            return FALSE;
+        }
+
+        char * szEnd = NULL;
+        rgpct[ iop ] = strtoul( sz, &szEnd, 10 );
+        pctTotal += rgpct[ iop ];
+        sz = szEnd;
+        if ( ',' == *sz )
+        {
+            sz++;
+        }
+        else if ( *sz )
+        {
+            return FALSE;
+        }
+    }
+
+    if ( 100 != pctTotal )
+    {
+        return FALSE;
+    }
+
+    memcpy( g_config.rgpctMix, rgpct, sizeof( rgpct ) );
+    return TRUE;
+}
+
+BOOL FBenchParseArgs( INT argc, __in_ecount(argc) char * argv[] )
+{
+    for ( INT iarg = 1; iarg < argc; iarg++ )
+    {
+        const char * const szArg = argv[ iarg ];
+        const char * const szVal = ( iarg + 1 < argc ) ? argv[ iarg + 1 ] : NULL;
+
+        if ( 0 == _stricmp( szArg, "-?" ) || 0 == _stricmp( szArg, "/?" ) || NULL == szVal )
+        {
+            return FALSE;
+        }
+        iarg++;
+
+        if ( 0 == _stricmp( szArg, "-dir" ) )
+        {
+            swprintf_s( g_config.wszDir, _countof( g_config.wszDir ), L"%hs", szVal );
+        }
+        else if ( 0 == _stricmp( szArg, "-instances" ) )
+        {
+            g_config.cInstances = max( 1, strtoul( szVal, NULL, 10 ) );
+        }
+        else if ( 0 == _stricmp( szArg, "-sessions" ) )
+        {
+            g_config.cSessionsPerInstance = max( 1, strtoul( szVal, NULL, 10 ) );
+        }
+        else if ( 0 == _stricmp( szArg, "-records" ) )
+        {
+            g_config.cRecords = max( 1, strtoul( szVal, NULL, 10 ) );
+        }
+        else if ( 0 == _stricmp( szArg, "-data" ) )
+        {
+            g_config.cbData = min( 255, max( 8, strtoul( szVal, NULL, 10 ) ) );
+        }
+        else if ( 0 == _stricmp( szArg, "-lv" ) )
+        {
+            g_config.cbLV = strtoul( szVal, NULL, 10 );
+        }
+        else if ( 0 == _stricmp( szArg, "-scan" ) )
+        {
+            g_config.cScanMax = max( 1, strtoul( szVal, NULL, 10 ) );
+        }
+        else if ( 0 == _stricmp( szArg, "-trx" ) )
+        {
+            g_config.cOpsLongTrx = max( 1, strtoul( szVal, NULL, 10 ) );
+        }
+        else if ( 0 == _stricmp( szArg, "-cache" ) )
+        {
+            g_config.cpgCacheMax = strtoul( szVal, NULL, 10 );
+        }
+        else if ( 0 == _stricmp( szArg, "-zipf" ) )
+        {
+            g_config.dblZipfTheta = atof( szVal );
+            if ( !( g_config.dblZipfTheta >= 0.0 && g_config.dblZipfTheta < 1.0 ) )
+            {
+                printf( "Invalid zipf theta '%s', it must be at least 0 and below 1\n", szVal );
+                return FALSE;
+            }
+        }
+        else if ( 0 == _stricmp( szArg, "-warmup" ) )
+        {
+            g_config.csecWarmup = strtoul( szVal, NULL, 10 );
+        }
+        else if ( 0 == _stricmp( szArg, "-duration" ) )
+        {
+            g_config.csecDuration = max( 1, strtoul( szVal, NULL, 10 ) );
+        }
+        else if ( 0 == _stricmp( szArg, "-workload" ) )
+        {
+            INT iworkload;
+            for ( iworkload = 0; iworkload < _countof( g_rgworkload ); iworkload++ )
+            {
+                if ( 0 == _stricmp( szVal, g_rgworkload[ iworkload ].szName ) )
+                {
+                    memcpy( g_config.rgpctMix, g_rgworkload[ iworkload ].rgpct, sizeof( g_config.rgpctMix ) );
+                    break;
+                }
+            }
+            if ( iworkload == _countof( g_rgworkload ) )
+            {
+                printf( "Unknown workload '%s'\n", szVal );
+                return FALSE;
+            }
+        }
+        else if ( 0 == _stricmp( szArg, "-mix" ) )
+        {
+            if ( !FBenchParseMix( szVal ) )
+            {
+                printf( "Invalid mix '%s'\n", szVal );
+                return FALSE;
+            }
+        }
+        else if ( 0 == _stricmp( szArg, "-json" ) )
+        {
+            g_config.szJsonFile = szVal;
+        }
+        else
+        {
+            printf( "Unknown option '%s'\n", szArg );
+            return FALSE;
+        }
+    }
+
+    if ( g_config.cbLV == 0 && ( g_config.rgpctMix[ benchopLVRead ] || g_config.rgpctMix[ benchopLVWrite ] ) )
+    {
+        printf( "The lvread and lvwrite operations need -lv greater than zero\n" );
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+INT __cdecl main( INT argc, __in_ecount(argc) char * argv[] )
+{
+    if ( !FBenchParseArgs( argc, argv ) )
+    {
+        PrintHelpEseBench( argv[ 0 ] );
+        return 1;
+    }
+
+    const JET_ERR err = ErrBenchRun();
+    if ( err < JET_errSuccess )
+    {
+        printf( "esebench failed with %ld\n", err );
+    }
+
+    return err;
+}
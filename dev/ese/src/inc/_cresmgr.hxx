@@ -12,6 +12,8 @@ extern DWORD_PTR cbSectionSize;
 class CLookaside;
 class CResourceFreeObjectList;
 class CResourceChunkInfo;
+class CResourceMagazine;
+class CResourceMagazineCache;
 
 template <class T> T AlignDownMask( T const x, DWORD_PTR dwAlign )
     { return (T)( DWORD_PTR( x ) & DWORD_PTR( 0 - dwAlign ) ); }
@@ -113,6 +115,41 @@ private:
             CResourceChunkInfo &operator=( CResourceChunkInfo const & );
 };
 
+class CResourceMagazine
+{
+public:
+    enum { cRoundsMax = 16 };
+
+    CResourceMagazine       *m_pMagazineNext;
+    INT                     m_cRounds;
+    VOID                    *m_rgpv[ cRoundsMax ];
+
+public:
+    INLINE          CResourceMagazine();
+
+    INLINE  BOOL    FEmpty() const  { return 0 == m_cRounds; }
+    INLINE  BOOL    FFull() const   { return cRoundsMax == m_cRounds; }
+
+private:
+            CResourceMagazine( CResourceMagazine const & );
+            CResourceMagazine &operator=( CResourceMagazine const & );
+};
+
+class CResourceMagazineCache
+{
+public:
+    CCriticalSection        m_crit;
+    CResourceMagazine       *m_pMagazineLoaded;
+    CResourceMagazine       *m_pMagazinePrevious;
+
+public:
+    INLINE      CResourceMagazineCache();
+
+private:
+            CResourceMagazineCache( CResourceMagazineCache const & );
+            CResourceMagazineCache &operator=( CResourceMagazineCache const & );
+};
+
 class CResourceSection
 {
 public:
@@ -154,6 +191,16 @@ class CResourceManager
     CCriticalSection    m_critLARefiller;
     DWORD               m_cAvgCount;
 
+    BYTE                *m_rgbMagazineCache;
+    INT                 m_cMagazineCache;
+    INT                 m_cbMagazineCache;
+    CResourceMagazine   *m_pMagazineFullList;
+    CResourceMagazine   *m_pMagazineEmptyList;
+    INT                 m_cMagazineFull;
+    INT                 m_cMagazineFullMax;
+    CCriticalSection    m_critMagazineDepot;
+    INT                 m_iMagazineCacheFixed;
+
     INT                 m_cbSectionHeader;
     INT                 m_cbAlignedObject;
     INT                 m_cObjectsPerSection;
@@ -244,6 +291,15 @@ public:
     INLINE ULONG_PTR CbUsed() const;
     INLINE ULONG_PTR CbQuota() const;
 
+            VOID    MagazineDrain();
+            LONG    CMagazineObjects() const;
+            LONG    CMagazineDepotFull() const  { return m_cMagazineFull; }
+            LONG    CChunkObjectsUsed() const;
+
+            //  tests pin the per-processor magazine cache so a thread migration can't change which one they use
+
+            VOID    SetMagazineCacheFixed( const INT iMagazineCache )   { m_iMagazineCacheFixed = iMagazineCache; }
+
 private:
             CResourceManager( CResourceManager const & );
             CResourceManager &operator=( CResourceManager const & );
@@ -255,6 +311,17 @@ private:
             VOID    *PvAllocFromChunk_( CResourceChunkInfo * const pRCI );
             BOOL    FGetNotFullChunk_();
             BOOL    FAllocateNewChunk_();
+            VOID    FreeToChunk_( VOID * const pv );
+
+            ERR     ErrMagazineInit_();
+            VOID    MagazineTerm_();
+    INLINE  CResourceMagazineCache *PMagazineCache_( const INT iMagazineCache ) const;
+    INLINE  CResourceMagazineCache *PMagazineCacheCurrent_() const;
+            CResourceMagazine *PMagazineDepotGet_( const BOOL fFull );
+            CResourceMagazine *PMagazineDepotPut_( CResourceMagazine * const pMagazine, const BOOL fFull );
+            VOID    *PvMagazineAlloc_();
+            BOOL    FMagazineFree_( VOID * const pv );
+            VOID    *PvMagazineFlush_();
 
 #ifdef MEM_CHECK
             #define MarkAsAllocated_( pv, option, szFile, lLine ) MarkAsAllocated__( pv, option, szFile, (LONG)lLine )
@@ -460,6 +527,23 @@ INLINE CResourceChunkInfo::CResourceChunkInfo( CResourceManager *pRMOwner ) :
 
 
 
+INLINE CResourceMagazine::CResourceMagazine() :
+        m_pMagazineNext( NULL ),
+        m_cRounds( 0 )
+{
+}
+
+
+
+INLINE CResourceMagazineCache::CResourceMagazineCache() :
+        m_crit( CLockBasicInfo( CSyncBasicInfo( "CResourceMagazineCache::m_crit" ), 0, 2 ) ),
+        m_pMagazineLoaded( NULL ),
+        m_pMagazinePrevious( NULL )
+{
+}
+
+
+
 INLINE CResourceSection::CResourceSection() :
         m_pRCI( NULL ),
         m_cbSectionHeader( 0 )
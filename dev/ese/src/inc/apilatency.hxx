@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _APILATENCY_HXX_INCLUDED
+#define _APILATENCY_HXX_INCLUDED
+
+
+//  log-linear microsecond buckets, one set of counts per processor
+
+class CApiLatencyHistograms
+{
+    public:
+        enum { cBucketLinear = 8 };
+        enum { cBucketPerOctave = 2 };
+        enum { iOctaveMin = 3 };
+        enum { iOctaveMax = 26 };
+        enum { cBucket = cBucketLinear + ( iOctaveMax - iOctaveMin + 1 ) * cBucketPerOctave };
+
+        static INLINE ULONG IBucketFromCusec( const QWORD cusec );
+        static QWORD CusecMaxFromIBucket( const ULONG iBucket );
+
+    public:
+        CApiLatencyHistograms() :
+            m_cproc( 0 ),
+            m_cbPerProc( 0 ),
+            m_rgb( NULL ),
+            m_iInstance( 0 )
+        {
+        }
+
+        ~CApiLatencyHistograms()
+        {
+            Term();
+        }
+
+        ERR ErrInit( const size_t cproc, const INT iInstance );
+        VOID Term();
+
+        INLINE VOID Record( const INT op, const QWORD cusec );
+
+        QWORD CSamples( const INT op, QWORD * const rgcBucket ) const;
+        static QWORD CusecPercentile( const QWORD * const rgcBucket, const QWORD cSamples, const ULONG ulPermille );
+
+    private:
+        CApiLatencyHistograms( const CApiLatencyHistograms& );
+        CApiLatencyHistograms& operator=( const CApiLatencyHistograms& );
+
+        DWORD * RgcBucket_( const size_t iProc, const INT op ) const
+        {
+            return (DWORD *)( m_rgb + iProc * m_cbPerProc ) + op * cBucket;
+        }
+
+        VOID RefreshPerfCounters_( const INT op );
+
+        size_t          m_cproc;
+        size_t          m_cbPerProc;
+        BYTE *          m_rgb;
+        INT             m_iInstance;
+        TICK            m_rgtickPerfRefresh[ opMax ];
+};
+
+INLINE ULONG CApiLatencyHistograms::IBucketFromCusec( const QWORD cusec )
+{
+    if ( cusec < cBucketLinear )
+    {
+        return (ULONG)cusec;
+    }
+
+    //  check the top octave before narrowing, Log2 only takes a ULONG on every platform
+
+    if ( cusec >> ( iOctaveMax + 1 ) )
+    {
+        return cBucket - 1;
+    }
+
+    const ULONG iOctave = Log2( (ULONG)cusec );
+
+    const ULONG iSub = (ULONG)( ( cusec >> ( iOctave - 1 ) ) & 1 );
+    return cBucketLinear + ( iOctave - iOctaveMin ) * cBucketPerOctave + iSub;
+}
+
+INLINE VOID CApiLatencyHistograms::Record( const INT op, const QWORD cusec )
+{
+    Assert( op >= 0 && op < opMax );
+
+    if ( NULL == m_rgb )
+    {
+        return;
+    }
+
+    const size_t iProc = OSSyncGetCurrentProcessor() % m_cproc;
+    AtomicIncrement( (LONG *)&RgcBucket_( iProc, op )[ IBucketFromCusec( cusec ) ] );
+
+    if ( TickOSTimeCurrent() - m_rgtickPerfRefresh[ op ] >= 1000 )
+    {
+        RefreshPerfCounters_( op );
+    }
+}
+
+#endif
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef _ARENA_HXX_INCLUDED
+#define _ARENA_HXX_INCLUDED
+
+
+class CArena
+{
+    private:
+        struct BLOCK
+        {
+            BLOCK *         pblockPrev;
+            size_t          cb;
+            size_t          ibFree;
+        };
+
+        enum { cbAlign = 16 };
+        enum { cbBlockHeader = ( sizeof( BLOCK ) + cbAlign - 1 ) & ~( cbAlign - 1 ) };
+        enum { cbBlockDefault = 16 * 1024 };
+
+        struct HEAPALLOC
+        {
+            HEAPALLOC *     pheapallocNext;
+        };
+
+        enum { cbHeapAllocHeader = ( sizeof( HEAPALLOC ) + cbAlign - 1 ) & ~( cbAlign - 1 ) };
+
+    public:
+
+        //  the outermost scope makes its thread the owner of the arena until it closes. A scope opened
+        //  on another thread meanwhile (e.g. a parallel index build worker sharing the PIB) doesn't
+        //  touch the arena and serves its allocations from the heap instead, freeing them at scope exit
+
+        class CScope
+        {
+            public:
+                CScope( CArena * const parena ) :
+                    m_parena( parena->FTryEnterScope_() ? parena : NULL ),
+                    m_pblock( m_parena ? m_parena->m_pblockCurr : NULL ),
+                    m_ibFree( m_pblock ? m_pblock->ibFree : 0 ),
+                    m_pheapalloc( NULL )
+                {
+                }
+
+                ~CScope()
+                {
+                    if ( m_parena )
+                    {
+                        m_parena->Rewind_( m_pblock, m_ibFree );
+                    }
+                    FreeHeapAllocs_( m_pheapalloc );
+                }
+
+                VOID * PvAlloc( const size_t cb )      { return m_parena ? m_parena->PvAlloc( cb ) : PvAllocFromHeap_( cb ); }
+
+            private:
+                CScope( const CScope& );
+                CScope& operator=( const CScope& );
+
+                VOID * PvAllocFromHeap_( const size_t cb );
+                static VOID FreeHeapAllocs_( HEAPALLOC * pheapalloc );
+
+                CArena * const      m_parena;
+                BLOCK * const       m_pblock;
+                const size_t        m_ibFree;
+                HEAPALLOC *         m_pheapalloc;
+        };
+
+    public:
+        CArena() :
+            m_pblockCurr( NULL ),
+            m_pblockSpare( NULL ),
+            m_cScope( 0 ),
+            m_dwOwnerThreadId( 0 ),
+            m_iInstance( 0 ),
+            m_cAlloc( 0 ),
+            m_cAllocReported( 0 ),
+            m_cHeapAlloc( 0 )
+        {
+        }
+
+        ~CArena()
+        {
+            Term();
+        }
+
+        VOID SetPerfInstance( const INT iInstance )    { m_iInstance = iInstance; }
+
+        INLINE VOID * PvAlloc( const size_t cb );
+        VOID Term();
+
+        QWORD CAlloc() const        { return m_cAlloc; }
+        QWORD CHeapAlloc() const    { return m_cHeapAlloc; }
+
+    private:
+        CArena( const CArena& );
+        CArena& operator=( const CArena& );
+
+        BOOL FTryEnterScope_();
+        VOID * PvAllocFromNewBlock_( const size_t cb );
+        VOID Rewind_( BLOCK * const pblock, const size_t ibFree );
+
+        BLOCK *         m_pblockCurr;
+        BLOCK *         m_pblockSpare;
+        INT             m_cScope;
+        volatile DWORD  m_dwOwnerThreadId;
+        INT             m_iInstance;
+        QWORD           m_cAlloc;
+        QWORD           m_cAllocReported;
+        QWORD           m_cHeapAlloc;
+};
+
+INLINE VOID * CArena::PvAlloc( const size_t cb )
+{
+    Assert( m_cScope > 0 );
+    Assert( DwUtilThreadId() == m_dwOwnerThreadId );
+
+    const size_t cbAligned = ( cb + cbAlign - 1 ) & ~size_t( cbAlign - 1 );
+    if ( cbAligned < cb )
+    {
+        return NULL;
+    }
+
+    m_cAlloc++;
+
+    BLOCK * const pblock = m_pblockCurr;
+    if ( NULL != pblock && cbAligned <= pblock->cb - pblock->ibFree )
+    {
+        VOID * const pv = (BYTE *)pblock + pblock->ibFree;
+        pblock->ibFree += cbAligned;
+        return pv;
+    }
+
+    return PvAllocFromNewBlock_( cbAligned );
+}
+
+#endif
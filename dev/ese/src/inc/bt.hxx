@@ -142,7 +142,12 @@ ERR ErrBTInsert( FUCB *pfucb, const KEY& key, const DATA& data, DIRFLAG dirflags
 ERR ErrBTAppend( FUCB *pfucb, const KEY& key, const DATA& data, DIRFLAG dirflags );
 
 ERR ErrBTFlagDelete( FUCB *pfucb, DIRFLAG dirflags, RCE *prcePrimary = prceNil );
-ERR ErrBTDelete( FUCB *pfucb, const BOOKMARK& bm );
+ERR ErrBTDelete(
+    FUCB            *pfucb,
+    const BOOKMARK& bm,
+    const BOOKMARK  * const rgbmNext = NULL,
+    const INT       cbmNext = 0,
+    INT             * const pcbmNextCleaned = NULL );
 
 ERR ErrBTCopyTree( FUCB * pfucbSrc, FUCB * pfucbDest, DIRFLAG dirflag );
 
@@ -232,17 +232,20 @@ const INT rankDBMScanSignalControl      = 10;
 const INT rankBFCacheSizeSet            = 10;
 const INT rankFMPRedoMaps               = 10;
 const INT rankRBSFirstValidGen          = 10;
+const INT rankChangedPageMap            = 10;
 const INT rankFlushMapAccess            = 13;
 const INT rankFlushMapGrowth            = 15;
 const INT rankFlushMapAsyncWrite        = 15;
 const INT rankShadowLogBuff             = 18;
 const INT rankShadowLogConsume          = 19;
+const INT rankRBSStage                  = 19;
 const INT rankCallbacks                 = 20;
 const INT rankBucketGlobal              = 20;
 const INT rankLGBuf                     = 20;
 const INT rankDBMScanSerializer         = 20;
 const INT rankRBSBuf                    = 20;
 const INT rankAsynchIOExecuting         = 21;
+const INT rankBucketSlot                = 21;
 const INT rankLGTrace                   = 22;
 const INT rankPRL                       = 23;
 const INT rankBFDUI                     = 23;
@@ -265,6 +268,7 @@ const INT rankFMP                       = 60;
 const INT rankBFOB0                     = 65;
 const INT rankBFLgposModifyHist         = 65;
 const INT rankBFFMPContext              = 66;
+const INT rankRBSStageDrain             = 68;
 const INT rankBFLRUK                    = 70;
 const INT rankRBSWrite                  = 70;
 const INT rankFMPDetaching              = 75;
@@ -326,6 +330,7 @@ const char szFMPRedoMaps[]          = "FMPRedoMaps";
 const char szDBGPrint[]             = "DBGPrint";
 const char szRCEClean[]             = "RCEClean";
 const char szBucketGlobal[]         = "BucketGlobal";
+const char szBucketSlot[]           = "BucketSlot";
 const char szRCEChain[]             = "RCEChain";
 const char szPIBTrx[]               = "PIBTrx";
 const char szPIBLogBeginTrx[]       = "PIBLogBeginTrx";
@@ -367,7 +372,10 @@ const char szOpenDbCheck[]          = "OpenDbCheck";
 const char szCompact[]              = "JetCompact";
 const char szRBSBuf[]               = "RBSBuffer";
 const char szRBSWrite[]             = "RBSWrite";
+const char szRBSStage[]             = "RBSStage";
+const char szRBSStageDrain[]        = "RBSStageDrain";
 const char szRBSFirstValidGen[]     = "RBSFirstValidGen";
+const char szChangedPageMap[]       = "ChangedPageMap";
 
 const DWORD OCUSER_UNINIT           = ( OC_bitInternalUser );
 const DWORD OCUSER_INTERNAL         = ( OC_bitInternalUser | 1 );
@@ -3395,6 +3395,7 @@ class SCRUBDB;
 typedef struct tagLGSTATUSINFO LGSTATUSINFO;
 PERSISTED struct CHECKPOINT_FIXED;
 struct LOG_VERIFY_STATE;
+struct READPAGE_DATA;
 
 typedef struct
 {
@@ -3608,6 +3609,7 @@ private:
 
     BOOL            m_fStopBackup;
     BOOL            m_fBackupFull;
+    BOOL            m_fBackupChangedPages;
 
     PIB             *m_ppibBackup;
 
@@ -3636,6 +3638,17 @@ private:
     RHF             m_rgrhf[crhfMax];
     INT             m_crhfMac;
 
+    READPAGE_DATA   *m_preaddataReadAhead;
+    BYTE            *m_pbReadAhead;
+    CPG             m_cpgReadAheadBuffer;
+    IFMP            m_ifmpReadAhead;
+    PGNO            m_pgnoReadAheadBase;
+    PGNO            m_pgnoReadAheadNext;
+    PGNO            m_pgnoReadAheadLast;
+    BOOL            m_fReadAheadPending;
+    TICK            m_tickReadAheadIssued;
+    INT             m_cReadAheadDepth;
+
 #ifdef DEBUG
     BOOL            m_fDBGTraceBR;
     LONG            m_cbDBGCopied;
@@ -3660,6 +3673,15 @@ private:
 #endif
                 );
 
+    BOOL FBKIReadAheadConsume( const IFMP ifmp, const PGNO pgnoStart, const PGNO pgnoEnd, BYTE * const pbDest );
+    VOID BKIReadAheadIssue( const IFMP ifmp, const PGNO pgnoFirst, const INT cpage );
+    VOID BKIReadAheadComplete();
+    VOID BKIReadAheadTerm();
+
+    ERR ErrBKIBeginChangedPageEpochs();
+    VOID BKIEndChangedPageEpochs( const BOOL fNormal );
+    VOID BKIZeroUnchangedPages( const IFMP ifmp, const PGNO pgnoStart, const PGNO pgnoEnd, BYTE * const pbPages );
+
     ERR ErrBKICopyFile(
         const WCHAR *wszFileName,
         const WCHAR *wszBackup,
@@ -4229,6 +4251,8 @@ public:
     size_t              m_cpls;
     PLS*                m_rgpls;
 
+    CApiLatencyHistograms   m_apilatency;
+
     PLS* Ppls();
     PLS* Ppls( const size_t iProc );
 
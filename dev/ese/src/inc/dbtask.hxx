@@ -112,6 +112,8 @@ class RECTASK : public DBTASK
 
         static bool FBookmarkIsLessThan( const RECTASK * ptask1, const RECTASK * ptask2 );
 
+        virtual BOOL FPageBatchable() const { return fFalse; }
+
     protected:
 
         ERR ErrOpenCursor( PIB * const ppib, FUCB ** ppfucb );
@@ -140,6 +142,14 @@ class DELETERECTASK : public RECTASK
         ERR ErrExecuteDbTask( PIB * const ppib );
         VOID HandleError( const ERR err );
 
+        BOOL FPageBatchable() const { return fTrue; }
+        VOID SetPageBatch( const BOOKMARK * const rgbmNext, const INT cbmNext, INT * const pcbmNextCleaned );
+
+    private:
+        const BOOKMARK *    m_rgbmNext;
+        INT                 m_cbmNext;
+        INT *               m_pcbmNextCleaned;
+
     private:
         DELETERECTASK( const DELETERECTASK& );
         DELETERECTASK& operator=( const DELETERECTASK& );
@@ -222,9 +232,13 @@ class BATCHRECTASK : public DBTASK
 
         ERR ErrAddTask( RECTASK * const prectask );
 
+        enum { cbmPageBatchMax = 32 };
+
     protected:
         VOID SortTasksByBookmark();
 
+        INT CtasksDispatchNext( PIB * const ppib, const INT iptask );
+
         VOID PrereadTaskBookmarks( PIB * const ppib, const INT itaskStart, __out LONG * pctasksPreread );
 
     protected:
@@ -95,11 +95,13 @@ using namespace std;
 #include "tls.hxx"
 #include "taskmgr.hxx"
 #include "cresmgr.hxx"
+#include "apilatency.hxx"
 #include "daedef.hxx"
 #include "dbutil.hxx"
 #include "sysinit.hxx"
 #include "bf.hxx"
 #include "log.hxx"
+#include "arena.hxx"
 #include "pib.hxx"
 #include "kvpstore.hxx"
 #include "cpage.hxx"
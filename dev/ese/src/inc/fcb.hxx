@@ -552,7 +552,8 @@ private:
 
         TABLECLASS  m_tableclass;
         BYTE        m_fcbtype;
-        BYTE        rgbReserved[2];
+        BYTE        m_fAvailPoolsEmpty;
+        BYTE        m_fAvailPoolsProbed;
 
         USHORT      m_crefDomainDenyRead;
         USHORT      m_crefDomainDenyWrite;
@@ -996,6 +997,11 @@ private:
         PGNO PgnoNextAvailSE() const;
         VOID SetPgnoNextAvailSE( const PGNO pgno );
 
+        BOOL FAvailPoolProbed( const ULONG ispp ) const;
+        BOOL FAvailPoolEmpty( const ULONG ispp ) const;
+        VOID SetAvailPoolProbed( const ULONG ispp, const BOOL fEmpty );
+        VOID ResetAvailPoolProbed( const ULONG ispp );
+
         SPLIT_BUFFER *Psplitbuf( const BOOL fAvailExt );
         ERR ErrEnableSplitbuf( const BOOL fAvailExt );
         VOID DisableSplitbuf( const BOOL fAvailExt );
@@ -1172,8 +1178,9 @@ INLINE VOID FCB::VerifyOptimalPacking()
     static_assert( NoWastedSpace( FCB, m_ifmp,                 m_ulFCBFlags) );
     static_assert( NoWastedSpace( FCB, m_ulFCBFlags,           m_tableclass) );
     static_assert( NoWastedSpace( FCB, m_tableclass,           m_fcbtype) );
-    static_assert( NoWastedSpace( FCB, m_fcbtype,              rgbReserved) );
-    static_assert( NoWastedSpace( FCB, rgbReserved,            m_crefDomainDenyRead) );
+    static_assert( NoWastedSpace( FCB, m_fcbtype,              m_fAvailPoolsEmpty) );
+    static_assert( NoWastedSpace( FCB, m_fAvailPoolsEmpty,     m_fAvailPoolsProbed) );
+    static_assert( NoWastedSpace( FCB, m_fAvailPoolsProbed,    m_crefDomainDenyRead) );
     static_assert( NoWastedSpace( FCB, m_crefDomainDenyRead,   m_crefDomainDenyWrite) );
     static_assert( NoWastedSpace( FCB, m_crefDomainDenyWrite,  m_prceNewest) );
     static_assert( NoWastedSpace( FCB, m_prceNewest,           m_prceOldest) );
@@ -1857,6 +1864,36 @@ INLINE VOID FCB::SetPgnoNextAvailSE( const PGNO pgno )
     m_pgnoNextAvailSE = pgno;
 }
 
+INLINE BOOL FCB::FAvailPoolProbed( const ULONG ispp ) const
+{
+    Assert( ispp < 8 * sizeof( m_fAvailPoolsProbed ) );
+    return !!( m_fAvailPoolsProbed & ( 1 << ispp ) );
+}
+INLINE BOOL FCB::FAvailPoolEmpty( const ULONG ispp ) const
+{
+    Assert( ispp < 8 * sizeof( m_fAvailPoolsEmpty ) );
+    return !!( m_fAvailPoolsEmpty & ( 1 << ispp ) );
+}
+INLINE VOID FCB::SetAvailPoolProbed( const ULONG ispp, const BOOL fEmpty )
+{
+    Assert( ispp < 8 * sizeof( m_fAvailPoolsProbed ) );
+    m_fAvailPoolsProbed |= BYTE( 1 << ispp );
+    if ( fEmpty )
+    {
+        m_fAvailPoolsEmpty |= BYTE( 1 << ispp );
+    }
+    else
+    {
+        m_fAvailPoolsEmpty &= BYTE( ~( 1 << ispp ) );
+    }
+}
+INLINE VOID FCB::ResetAvailPoolProbed( const ULONG ispp )
+{
+    Assert( ispp < 8 * sizeof( m_fAvailPoolsProbed ) );
+    m_fAvailPoolsProbed &= BYTE( ~( 1 << ispp ) );
+    m_fAvailPoolsEmpty &= BYTE( ~( 1 << ispp ) );
+}
+
 
 INLINE SPLITBUF_DANGLING *FCB::Psplitbufdangling_() const
 {
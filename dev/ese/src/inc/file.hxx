@@ -102,6 +102,7 @@ ERR ErrFILECloseTable( PIB *ppib, FUCB *pfucb );
 
 
 const ULONG cFILEIndexBatchSizeDefault  = 16;
+const CPG   cpgFILEIndexAppendReserveMax    = 8192;
 
 ERR ErrFILEIndexBatchInit(
     PIB         * const ppib,
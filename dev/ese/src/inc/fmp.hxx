@@ -104,6 +104,47 @@ private:
 };
 
 
+class CChangedPageMap
+{
+public:
+    CChangedPageMap();
+    ~CChangedPageMap();
+
+    static const CPG s_cpgChunk = 16;
+
+    ERR ErrBeginEpoch( const PGNO pgnoLast );
+    VOID EndEpoch( const BOOL fSucceeded );
+    VOID Term();
+
+    BOOL FTracking() const      { return NULL != m_rgulActive; }
+    BOOL FInEpoch() const       { return m_fInEpoch; }
+
+    VOID SetRangeChanged( const PGNO pgnoFirst, const CPG cpg );
+    VOID SetResized( const PGNO pgnoLastOld, const PGNO pgnoLastNew );
+    BOOL FEpochRangeChanged( const PGNO pgnoFirst, const CPG cpg ) const;
+
+private:
+    static size_t CulForPgnoMax_( const PGNO pgnoMax )      { return ( pgnoMax / s_cpgChunk ) / 32 + 1; }
+    static BOOL FChunkSet_( const ULONG * const rgul, const size_t ichunk )
+                                                            { return !!( rgul[ ichunk / 32 ] & ( 1 << ( ichunk % 32 ) ) ); }
+
+    CReaderWriterLock   m_rwl;
+
+    ULONG *             m_rgulActive;
+    PGNO                m_pgnoMaxActive;
+    BOOL                m_fActiveValid;
+
+    ULONG *             m_rgulEpoch;
+    PGNO                m_pgnoMaxEpoch;
+    BOOL                m_fEpochValid;
+    BOOL                m_fInEpoch;
+
+private:
+    CChangedPageMap( const CChangedPageMap& );
+    CChangedPageMap& operator=( const CChangedPageMap& );
+};
+
+
 
 class FMP
     :   public CZeroInit
@@ -233,6 +274,10 @@ class FMP
         QWORD               m_cbOwnedFileSize;      
         QWORD               m_cbFsFileSizeAsyncTarget; 
         CSemaphore          m_semIOSizeChange;      
+        TICK                m_tickLastDbExtension;
+        LONG                m_cDbExtensionLead;
+
+        CChangedPageMap     m_cpm;
 
         UINT                m_cPin;                 
         INT                 m_crefWriteLatch;       
@@ -485,6 +530,7 @@ public:
         CKVPStore * PkvpsMSysLocales() const;
 
         CFlushMapForAttachedDb * PFlushMap() const;
+        CChangedPageMap& ChangedPageMap();
     
         LIDMAP * Plidmap() const;
 
@@ -541,6 +587,8 @@ public:
         VOID SetPpibWriteLatch( PIB * ppib);
         VOID SetOwnedFileSize( const QWORD cb );
         VOID SetFsFileSizeAsyncTarget( const QWORD cb );
+        CPG CpgDbExtensionLead( const CPG cpgExtension, const CPG cpgHeadroom );
+        VOID ResetDbExtensionLead();
         VOID SetPfapi( IFileAPI *const pfapi );
         VOID SetDbtimeCurrentDuringRecovery( DBTIME dbtime );
         VOID SetLgposAttach( const LGPOS &lgposAttach );
@@ -1127,6 +1175,7 @@ INLINE LONG FMP::LGenMaxCommittedAttachedDuringRecovery() const { return m_lGenM
 INLINE CKVPStore * FMP::PkvpsMSysLocales() const { return m_pkvpsMSysLocales; }
 
 INLINE CFlushMapForAttachedDb * FMP::PFlushMap() const  { return m_pflushmap; }
+INLINE CChangedPageMap& FMP::ChangedPageMap()              { return m_cpm; }
 
 inline IFileAPI::FileModeFlags FMP::FmfDbDefault() const
 {
@@ -1300,6 +1349,32 @@ INLINE VOID FMP::SetFsFileSizeAsyncTarget( const QWORD cb )
     Assert( !FIOSizeChangeLatchAvail() );
     (VOID)AtomicExchange( (__int64*)&m_cbFsFileSizeAsyncTarget, (__int64)cb );
 }
+
+const LONG  cDbExtensionLeadMax         = 16;
+const LONG  dtickDbExtensionBurst       = 10 * 1000;
+
+INLINE CPG FMP::CpgDbExtensionLead( const CPG cpgExtension, const CPG cpgHeadroom )
+{
+    const TICK  tickNow     = TickOSTimeCurrent();
+
+    if ( m_tickLastDbExtension != 0 && DtickDelta( m_tickLastDbExtension, tickNow ) < dtickDbExtensionBurst )
+    {
+        m_cDbExtensionLead = min( m_cDbExtensionLead * 2, cDbExtensionLeadMax );
+    }
+    else
+    {
+        m_cDbExtensionLead = max( m_cDbExtensionLead / 2, 1 );
+    }
+    m_tickLastDbExtension = tickNow;
+
+    const QWORD cpgLead     = max( (QWORD)cpgExtension * m_cDbExtensionLead, (QWORD)max( cpgHeadroom, 0 ) );
+    return (CPG)min( cpgLead, (QWORD)lMax );
+}
+INLINE VOID FMP::ResetDbExtensionLead()
+{
+    m_tickLastDbExtension = 0;
+    m_cDbExtensionLead = 0;
+}
 INLINE VOID FMP::SetPfapi( IFileAPI *const pfapi ) { m_pfapi = pfapi; }
 INLINE VOID FMP::SetDbtimeCurrentDuringRecovery( DBTIME dbtime )    { m_dbtimeCurrentDuringRecovery = dbtime; }
 INLINE VOID FMP::SetLgposAttach( const LGPOS &lgposAttach ) { m_lgposAttach = lgposAttach; }
@@ -74,7 +74,41 @@ const static __int64 cioAllowLogRollHeaderUpdates = 4;
 BOOL FIOCheckUserDbNonFlushedIos( const INST * const pinst, const __int64 cioPerDbOutstandingLimit = 0, IFMP ifmpTargetedDB = ifmpNil );
 #endif
 
+struct READPAGE_DATA
+{
+    volatile ERR            err;
+    volatile LONG           cRead;
+    volatile TICK           tickCompleted;
+    BOOL                    fWait;
+    CAutoResetSignal        asigDone;
+    BOOL                    fCheckPagesOffset;
+    BOOL                    fExtensiveChecks;
+    IFMP                    ifmp;
+    LONG                    pgnoMost;
+    volatile BOOL           fRangeLocked;
+    PGNO                    pgnoRangeLockFirst;
+    PGNO                    pgnoRangeLockLast;
+
+    READPAGE_DATA()
+        :   err( JET_errSuccess ),
+            cRead( 0 ),
+            tickCompleted( 0 ),
+            fWait( fFalse ),
+            asigDone( CSyncBasicInfo( _T( "READPAGE_DATA::asigDone" ) ) ),
+            fCheckPagesOffset( fFalse ),
+            fExtensiveChecks( fFalse ),
+            ifmp( ifmpNil ),
+            pgnoMost( 0 ),
+            fRangeLocked( fFalse ),
+            pgnoRangeLockFirst( pgnoNull ),
+            pgnoRangeLockLast( pgnoNull )
+    {
+    }
+};
+
 ERR ErrIOReadDbPages( IFMP ifmp, IFileAPI *pfapi, BYTE *pbData, LONG pgnoStart, LONG pgnoEnd, BOOL fCheckPagesOffset, LONG pgnoMost, const TraceContext& tc, BOOL fExtensiveChecks );
+VOID IOReadDbPagesIssue( IFMP ifmp, IFileAPI *pfapi, BYTE *pbData, LONG pgnoStart, LONG pgnoEnd, BOOL fCheckPagesOffset, LONG pgnoMost, const TraceContext& tc, BOOL fExtensiveChecks, const OSFILEQOS qos, READPAGE_DATA * const preaddata );
+ERR ErrIOReadDbPagesWait( READPAGE_DATA * const preaddata );
 
 ERR ISAMAPI   ErrIsamGetInstanceInfo( ULONG *pcInstanceInfo, JET_INSTANCE_INFO_W ** paInstanceInfo, const CESESnapshotSession * pSnapshotSession );
 
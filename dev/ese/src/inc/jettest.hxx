@@ -54,7 +54,7 @@ class JetUnitTestResult
 class JetUnitTest
 {
     public:
-        static INT RunTests( const char * const szTest, const IFMP ifmpTest );
+        static INT RunTests( const char * const szTest, const IFMP ifmpTest, const bool fBenchmarks = false );
         static void PrintTests();
 
     private:
@@ -70,6 +70,7 @@ class JetUnitTest
         virtual bool FNeedsBF();
         virtual bool FNeedsDB();
         virtual bool FRunByDefault();
+        virtual bool FBenchmark();
         virtual void SetTestIfmp( const IFMP ifmpTest );
 
         virtual void Run( JetUnitTestResult * const presult ) = 0;
@@ -177,6 +178,50 @@ class JetSimpleDbUnitTest : public JetSimpleUnitTest
         JetUnitTestResult * m_presult;
 };
 
+class JetUnitBenchmark : public JetSimpleUnitTest
+{
+    public:
+        static void Configure( const char * const szJsonFile, const INT cRun );
+
+    protected:
+        JetUnitBenchmark( const char * const szName );
+        JetUnitBenchmark( const char * const szName, const DWORD dwFacilities );
+        virtual ~JetUnitBenchmark();
+
+        bool FBenchmark() { return true; }
+        void Run( JetUnitTestResult * const presult );
+
+        bool FIterate_()
+        {
+            if ( m_cIterLeft > 0 )
+            {
+                m_cIterLeft--;
+                return true;
+            }
+            return FIterateNextRun_();
+        }
+
+    private:
+        enum BENCHSTATE { benchstateNotStarted, benchstateWarmup, benchstateMeasure, benchstateDone };
+
+        bool FIterateNextRun_();
+        void StartRun_();
+        void Report_();
+
+        static const char * s_szJsonFile;
+        static INT          s_cRun;
+
+        const char * const  m_szName;
+        BENCHSTATE          m_benchstate;
+        QWORD               m_cIterPerRun;
+        QWORD               m_cIterLeft;
+        INT                 m_iRun;
+        HRT                 m_hrtRunStart;
+        QWORD               m_ccycRunStart;
+        HRT *               m_rgdhrtRun;
+        QWORD *             m_rgdccycRun;
+};
+
 class JetTestFixture
 {
     public:
@@ -236,6 +281,33 @@ Test##component##test Test##component##test::s_instance;                \
 void Test##component##test::Run_()
 
 
+#define JETUNITBENCHMARK(component,bench) \
+class Bench##component##bench : public JetUnitBenchmark                 \
+{                                                                       \
+protected:                                                              \
+    void Run_();                                                        \
+private:                                                                \
+    Bench##component##bench() : JetUnitBenchmark(#component "." #bench) {}\
+    static Bench##component##bench s_instance;                          \
+};                                                                      \
+Bench##component##bench Bench##component##bench::s_instance;            \
+void Bench##component##bench::Run_()
+
+#define JETUNITBENCHMARKEX(component,bench,facilities) \
+class Bench##component##bench : public JetUnitBenchmark                 \
+{                                                                       \
+protected:                                                              \
+    void Run_();                                                        \
+private:                                                                \
+    Bench##component##bench() : JetUnitBenchmark(#component "." #bench, facilities) {}\
+    static Bench##component##bench s_instance;                          \
+};                                                                      \
+Bench##component##bench Bench##component##bench::s_instance;            \
+void Bench##component##bench::Run_()
+
+#define BENCHMARK_ITERATE()     while ( FIterate_() )
+
+
 #define FAIL(_reason)          \
     Fail_(__FILE__, __LINE__, _reason)
 
@@ -261,6 +333,9 @@ void Test##component##test::Run_()
 #define JETUNITTEST(component,test)         VOID DisabledTest##component##test( VOID )
 #define JETUNITTESTEX(component,test,facilities)    VOID DisabledTest##component##test( VOID )
 #define JETUNITTESTDB(component,test,facilities)    VOID DisabledTest##component##test( const IFMP ifmpTest, const WCHAR * const wszTable, JET_SESID * const psesid, JET_DBID * const pdbid, JET_TABLEID * pcursor )
+#define JETUNITBENCHMARK(component,bench)           VOID DisabledBench##component##bench( VOID )
+#define JETUNITBENCHMARKEX(component,bench,facilities)  VOID DisabledBench##component##bench( VOID )
+#define BENCHMARK_ITERATE()         while ( fFalse )
 #define IfmpTest()                  ((IFMP)ifmpNil)
 
 #define CHECK( expr )
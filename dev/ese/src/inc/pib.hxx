@@ -272,6 +272,11 @@ private:
 private:
     MACRO               *m_pMacroNext;
 
+    //  owned by one thread at a time, see CArena::CScope
+    CArena              m_arena;
+
+    JET_OPSTATS         m_opstatsLast;
+
     ERR                 m_errRollbackFailure;
 
     TrxidStack          m_trxidstack;
@@ -311,6 +316,11 @@ public:
     VOID                *PvLogrec( DBTIME dbtime )      const;
     SIZE_T              CbSizeLogrec( DBTIME dbtime )   const;
 
+    CArena *            Parena()                        { return &m_arena; }
+
+    const JET_OPSTATS&  OpstatsLast() const             { return m_opstatsLast; }
+    VOID                SetOpstatsLast( const JET_OPSTATS& opstats )   { m_opstatsLast = opstats; }
+
     RCE                 * PrceOldest();
 
     VOID                PIBSetTrxContext();
@@ -10,6 +10,8 @@
 #define cbRBSAttach                     4480
 #define cRBSSegmentMax                  0x7fff0000
 #define cbRBSSegmentsInBuffer           (cbRBSBufferSize/cbRBSSegmentSize)
+#define cbRBSStageBufferSize            (2*cbRBSBufferSize)
+#define cRBSStagedPosMax                1024
 #define csecSpaceUsagePeriodicLog       3600
 
 C_ASSERT( cbRBSSegmentSizeMask == cbRBSSegmentSize - 1 );
@@ -165,6 +167,38 @@ const ULONG ulRBSVersionMinor         = 2;
 
 class CRevertSnapshot;
 
+//  Records are staged uncompressed in a ring and appended to the snapshot buffers by
+//  a background drain. Until then a record only has an upper bound on its segment.
+
+struct RBSSTAGEDREC
+{
+    ULONG   cbEntry;
+    LONG    isegBound;
+    IFMP    ifmp;
+    USHORT  cbRec;
+    USHORT  cbData;
+};
+
+C_ASSERT( sizeof( RBSSTAGEDREC ) == 16 );
+C_ASSERT( cbRBSStageBufferSize % sizeof( RBSSTAGEDREC ) == 0 );
+
+struct RBSSTAGEDPOS
+{
+    LONG    isegActual;
+    LONG    isegBound;
+};
+
+INLINE ULONG CbRBSStagedEntry( const ULONG cbRecord )
+{
+    return roundup( sizeof( RBSSTAGEDREC ) + cbRecord, sizeof( RBSSTAGEDREC ) );
+}
+
+INLINE LONG CsegRBSStagedRecordMax( const ULONG cbRecord )
+{
+    const ULONG cbContinuation = cbRBSSegmentSize - sizeof( RBSSEGHDR ) - sizeof( RBSFragContinue );
+    return ( cbRecord + cbContinuation - 1 ) / cbContinuation;
+}
+
 struct CSnapshotBuffer
 {
 #pragma push_macro( "new" )
@@ -578,13 +612,14 @@ class CRevertSnapshot : public CZeroInit
     {
         RBS_POS pos;
         pos.lGeneration = m_prbsfilehdrCurrent->rbsfilehdr.le_lGeneration;
-        pos.iSegment = m_cNextFlushSegment - 1;
+        pos.iSegment = max( (LONG)m_cNextFlushSegment - 1, AtomicRead( (LONG *)&m_isegStagedDurable ) );
         return pos;
     }
     ERR ErrFlushAll();
     VOID AssertAllFlushed()
     {
         Assert( m_cNextFlushSegment == m_cNextWriteSegment &&
+                m_cbStaged == 0 &&
                 ( m_pActiveBuffer == NULL || m_pActiveBuffer->m_ibNextRecord <= sizeof(RBSSEGHDR) ) );
     }
 
@@ -640,6 +675,21 @@ class CRevertSnapshot : public CZeroInit
     CSnapshotBuffer *m_pBuffersToWriteLast;
     CCriticalSection m_critWriteLock;
 
+    BYTE            *m_pbStage;
+    ULONG           m_ibStageHead;
+    ULONG           m_ibStageTail;
+    ULONG           m_cbStaged;
+    LONG            m_isegStagedBound;
+    volatile LONG   m_isegStagedDurable;
+    BOOL            m_fStageDrainInProgress;
+    ERR             m_errStage;
+    CCriticalSection m_critStageLock;
+    CCriticalSection m_critStageDrain;
+
+    RBSSTAGEDPOS    m_rgstagedpos[ cRBSStagedPosMax ];
+    ULONG           m_istagedposFirst;
+    ULONG           m_cstagedpos;
+
     CSnapshotReadBuffer *m_pReadBuffer;
 
     CResource       m_cresRBSBuf;
@@ -656,11 +706,23 @@ class CRevertSnapshot : public CZeroInit
     ERR ErrCaptureDbHeader( FMP * const pfmp );
     ERR ErrCaptureDbAttach( FMP * const pfmp );
     ERR ErrCaptureRec(
+            const IFMP        ifmp,
             const RBSRecord * prec,
             const DATA      * pExtraData,
                   RBS_POS   * prbsposRecord );
+    ERR ErrAppendRec(
+            const RBSRecord * prec,
+            const DATA      * pExtraData,
+            const LONG        isegBound );
     ERR ErrQueueCurrentAndAllocBuffer();
 
+    static DWORD DrainStaged_( VOID * pvThis );
+    ERR ErrDrainStaged();
+    ERR ErrAppendStaged( RBSSTAGEDREC * const pstaged, BYTE * const pbDataDehydrated, BYTE * const pbDataCompressed );
+    VOID ResetStagedPositions();
+    VOID AddStagedPosition( const LONG isegActual, const LONG isegBound );
+    VOID PublishStagedPositions();
+
     static DWORD WriteBuffers_( VOID * pvThis );
     ERR ErrWriteBuffers();
     ERR ErrFlush();
@@ -806,6 +868,10 @@ private:
     CArray< CPagePointer >*     m_rgRBSDbPage;        
     IBitmapAPI*                 m_psbmDbPages;
 
+    IBitmapAPI**                m_rgpsbmGenPages;
+    LONG                        m_lGenPagesMin;
+    LONG                        m_cGenPages;
+
     DBTIME                      m_dbTimePrevDirtied;
     
     CFlushMapForUnattachedDb*   m_pfm;
@@ -842,6 +908,9 @@ public:
     ERR ErrResetSbmDbPages();
     ERR ErrFlushDBPages( USHORT cbDbPageSize, BOOL fFlushDbHdr, CPG* pcpgReverted );
     BOOL FPageAlreadyCaptured( PGNO pgno );
+    ERR ErrInitGenPages( LONG lGenMin, LONG cGen );
+    VOID SetGenPage( LONG lGen, PGNO pgno );
+    BOOL FPageInOlderGen( PGNO pgno, LONG lGen );
     ERR ErrBeginTracingToIRS();
 
 public:
@@ -882,6 +951,8 @@ private:
 
     LONG                    m_lRBSMinGenToApply;
     LONG                    m_lRBSMaxGenToApply;
+    LONG                    m_lRBSGenApplying;
+    volatile LONG           m_lRBSGenNextToScan;
 
     _int64                  m_ftRevertLastUpdate;
 
@@ -891,6 +962,7 @@ private:
 
     LOGTIME                 m_ltRevertTo;
     QWORD                   m_cPagesRevertedCurRBSGen;
+    QWORD                   m_cPagesSkippedCurRBSGen;
 
     BOOL FRBSDBRC( PCWSTR wszDatabaseName, IRBSDBRC* pirbsdbrc );
 
@@ -898,6 +970,9 @@ private:
     ERR ErrComputeRBSRangeToApply( LOGTIME ltRevertExpected, LOGTIME* pltRevertActual );
     ERR ErrRBSGenApply( LONG lRBSGen, BOOL fDbHeaderOnly );
     ERR ErrApplyRBSRecord( RBSRecord* prbsrec, BOOL fCaptureDBHdrFromRBS, BOOL fDbHeaderOnly, BOOL* pfGivenDbfilehdrCaptured );
+    ERR ErrScanRBSGens();
+    ERR ErrScanRBSGenPages( LONG lRBSGen );
+    static DWORD DwScanRBSGensThreadProc( DWORD_PTR dwContext );
 
     ERR ErrRevertCheckpointInit();
     ERR ErrRevertCheckpointCleanup();
@@ -911,6 +986,7 @@ private:
     ERR ErrAddPageRecord( void* pvPage, DBID dbid, PGNO pgno );
     ERR ErrFlushPages( BOOL fFlushDbHdr );
     BOOL FPageAlreadyCaptured( DBID dbid, PGNO pgno );
+    BOOL FPageInOlderGen( DBID dbid, PGNO pgno );
 
     ERR ErrBeginRevertTracing( bool fDeleteOldTraceFile );
 
@@ -16,12 +16,16 @@ const LONG cbResidentTTMax = ( 64 * 1024 );
 
 const LONG cspairQSortMin = 32;
 
+const LONG cspairRadixSortMin = 64;
+
 const LONG cpartQSortMax = 16;
 
 const LONG crunFanInMax = 16;
 
 const LONG cpgClusterSize = 16;
 
+const CPG cpgMergePrereadMax = 512;
+
 #include <pshpack1.h>
 
 PERSISTED
@@ -223,6 +227,7 @@ public:
     INT         fFlags;
 
     QWORD       cRecords;
+    QWORD       cbRecords;
 
     SPAIR       *rgspair;
     LONG        ispairMac;
@@ -380,6 +385,7 @@ struct RCB
     RUNINFO         runinfo;
     BFLatch         rgbfl[cpgClusterSize];
     LONG            ipbf;
+    LONG            cclusterPreread;
     BYTE            *pbInMac;
     BYTE            *pbInMax;
     VOID            *pvAssy;
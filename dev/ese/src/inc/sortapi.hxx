@@ -9,6 +9,7 @@ ERR ErrSORTNext     ( FUCB *pfucb );
 ERR ErrSORTPrev     ( FUCB *pfucb );
 ERR ErrSORTSeek     ( FUCB * const pfucb, const KEY& key );
 ERR ErrSORTOpen     ( PIB *ppib, FUCB **ppfucb, const BOOL fRemoveDuplicateKey, const BOOL fRemoveDuplicateKeyData );
+QWORD CbSORTRecords ( FUCB *pfucb );
 VOID SORTClose      ( FUCB *pfucb );
 VOID SORTICloseRun  ( PIB * const ppib, SCB * const pscb );
 VOID SORTClosePscb  ( SCB *pscb );
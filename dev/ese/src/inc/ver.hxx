@@ -1048,6 +1048,39 @@ private:
         RCE*                prceChain;
     };
 
+public:
+    struct BUCKETSLOT
+    {
+        BUCKETSLOT() :
+            crit( CLockBasicInfo( CSyncBasicInfo( szBucketSlot ), rankBucketSlot, 0 ) ),
+            pbucketActive( NULL )
+        {
+        }
+
+        CCriticalSection    crit;
+        BUCKET*             pbucketActive;
+        BYTE                rgbPad[ 256 - sizeof( CCriticalSection ) - sizeof( BUCKET* ) ];
+    };
+
+    enum { cbucketslotMax = 16 };
+
+    //  cleanup position within one bucket slot, the slots are merged on RCEID so
+    //  RCEs are cleaned in creation order no matter which slot they went to
+
+    struct BUCKETSLOTCLEAN
+    {
+        BUCKET *            pbucket;
+        RCE *               prce;
+        BOOL                fSkippedRCEInBucket;
+    };
+
+    static INT IbucketslotVERICleanNext(
+            const BOOL * const  rgfRceid,
+            const RCEID * const rgrceid,
+            const INT           cbucketslot,
+            BOOL * const        pfLimit,
+            RCEID * const       prceidLimit );
+
 public:
     VER( INST *pinst );
     ~VER();
@@ -1074,6 +1107,9 @@ public:
     BUCKET              *m_pbucketGlobalHead;
     BUCKET              *m_pbucketGlobalTail;
 
+    INT                 m_cbucketslot;
+    BUCKETSLOT          m_rgbucketslot[ cbucketslotMax ];
+
     CResource           m_cresBucket;
     DWORD_PTR           m_cbBucket;
 
@@ -1110,7 +1146,19 @@ public:
     enum { cbrcehead = sizeof( VER::RCEHEAD ) };
     enum { cbrceheadLegacy = sizeof( VER::RCEHEADLEGACY ) };
 
+    enum { chashsegmentMax = 16 };
+    enum { cbucketHashTableLimit = 0x10000000 };
+    enum { crceHashChainGrowThreshold = 8 };
+    enum { cbucketHashSplitPerPass = 4096 };
+
+    volatile ULONG      m_cbucketHashTable;
+    ULONG               m_cbucketHashTableMax;
+    volatile LONG       m_fHashTableGrowthRequested;
+    volatile LONG       m_crceHashChainLongest;
+    QWORD               m_cHashBucketSplits;
+
 private:
+    RCE **              m_rgprceHashSegment[ chashsegmentMax ];
     BOOL                m_frceHashTableInited;
     RCEHEAD             m_rgrceheadHashTable[ 0 ];
 
@@ -1124,11 +1172,17 @@ private:
     INLINE size_t CbBUFree( const BUCKET * pbucket );
     INLINE BOOL FVERICleanWithoutIO();
     INLINE BOOL FVERICleanDiscardDeletes();
-    INLINE ERR ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash );
+    INLINE ERR ErrVERIBUAllocBucket( const INT cbRCE, const UINT uiHash, BUCKETSLOT * const pbucketslot );
     INLINE BUCKET *PbucketVERIGetOldest( );
     BUCKET *PbucketVERIFreeAndGetNextOldestBucket( BUCKET * pbucket );
-
-    ERR ErrVERIAllocateRCE( INT cbRCE, RCE ** pprce, const UINT uiHash );
+    INLINE BUCKETSLOT *PbucketslotVERI( const IFMP ifmp, const PGNO pgnoFDPTable );
+    INLINE BUCKETSLOT *PbucketslotVERI( const FCB * const pfcb );
+    INLINE BUCKETSLOT *PbucketslotVERI( const RCE * const prce );
+    INLINE BOOL FVERIBucketActive( const BUCKET * const pbucket ) const;
+    BUCKET *PbucketVERINextInSlot( const BUCKET * const pbucket ) const;
+    BOOL FVERICleanPositionRCE( BUCKETSLOTCLEAN * const pbucketslotclean, RCEID * const prceid );
+
+    ERR ErrVERIAllocateRCE( INT cbRCE, RCE ** pprce, const UINT uiHash, BUCKETSLOT * const pbucketslot );
     ERR ErrVERIMoveRCE( RCE * prce );
     ERR ErrVERICreateRCE(
             INT         cbNewRCE,
@@ -1144,7 +1198,8 @@ private:
             UINT        uiHash,
             RCE         **pprce,
             const BOOL  fProxy = fFalse,
-            RCEID       rceid = rceidNull
+            RCEID       rceid = rceidNull,
+            const PGNO  pgnoFDPTableSlot = pgnoNull
             );
     ERR ErrVERICreateDMLRCE(
             FUCB            * pfucb,
@@ -1199,10 +1254,18 @@ public:
     RCEID RceidLast();
     RCEID RceidLastIncrement();
 
+    VOID VERUnallocateLastRCE( RCE * const prce );
+#ifdef DEBUG
+    BOOL FInCritBucketSlot() const;
+#endif
+
     VOID IncrementCAsyncCleanupDispatched();
     VOID IncrementCSyncCleanupDispatched();
     VOID IncrementCCleanupFailed();
     VOID IncrementCCleanupDiscarded( const RCE * const prce );
+    VOID IncrementCCleanupPending();
+    VOID DecrementCCleanupPending();
+    VOID IncrementCCleanupCoalesced();
 
 #ifdef DEBUGGER_EXTENSION
     VOID Dump( CPRINTF * pcprintf, DWORD_PTR dwOffset = 0 ) const;
@@ -1212,6 +1275,19 @@ public:
     INLINE RCE *GetChain( UINT ui ) const;
     INLINE RCE **PGetChain( UINT ui );
     INLINE VOID SetChain( UINT ui, RCE * );
+    INLINE BOOL FChainEmptyNoLock( UINT ui ) const;
+    INLINE ULONG IbucketHashTable( UINT ui ) const;
+
+    INLINE VOID VERNoteHashChainLength( const INT crceChain );
+    VOID VERIGrowHashTable();
+
+private:
+    INLINE ULONG CbucketIHashLevel_( const ULONG cbucket ) const;
+    INLINE ULONG IbucketIHash_( const UINT ui, const ULONG cbucket ) const;
+    INLINE RCE **PprceIBucket_( const ULONG ibucket ) const;
+    VOID VERIFreeHashSegments();
+
+public:
 
 #ifdef RTM
 #else
@@ -1219,8 +1295,8 @@ public:
     ERR ErrInternalCheck();
 
 protected:
-    ERR ErrCheckRCEHashList( const RCE * const prce, const UINT uiHash ) const;
-    ERR ErrCheckRCEChain( const RCE * const prce, const UINT uiHash ) const;
+    ERR ErrCheckRCEHashList( const RCE * const prce, const ULONG ibucket ) const;
+    ERR ErrCheckRCEChain( const RCE * const prce, const ULONG ibucket ) const;
 #endif
 };
 
@@ -1254,7 +1330,8 @@ struct BUCKETHDR
             pbucketNext( NULL ),
             prceNextNew( (RCE *)rgb ),
             prceOldest( (RCE*)rgb ),
-            pbLastDelete( rgb )
+            pbLastDelete( rgb ),
+            ibucketslot( 0 )
     {
     }
 
@@ -1264,6 +1341,7 @@ struct BUCKETHDR
     RCE         *prceNextNew;
     RCE         *prceOldest;
     BYTE        *pbLastDelete;
+    INT         ibucketslot;
 };
 
 
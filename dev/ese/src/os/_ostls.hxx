@@ -50,6 +50,7 @@ struct OSTLS
 
     TICK                        dtickTaskThreadIdle;
     CTaskManager::PfnCompletion pfnTaskThreadIdle;
+    VOID *                      pvTaskThreadContext;
 
     COSTimerTaskEntry *         posttExecuting;
 
@@ -11709,9 +11709,15 @@ DEBUG_EXT( EDBGHash )
         const ULONG ulVERChecksum = UiVERHash( IFMP( ifmp ), PGNO( pgnoFDP ), bookmark, crcehead );
         dprintf( "VER checksum is: %u (0x%08X)\n", ulVERChecksum, ulVERChecksum );
 
+        const ULONG cbucketHashTable = pver->m_cbucketHashTable;
+
         Unfetch( pver );
         pver = NULL;
-        if ( FFetchVariable( (BYTE *)( pinst->m_pver ), (BYTE **)&pver, sizeof(VER) + ( VER::cbrcehead * crcehead ) ) )
+        if ( cbucketHashTable != crcehead )
+        {
+            dprintf( "VER hash table has grown to %u buckets; chain lookup is only supported on the initial table.\n", cbucketHashTable );
+        }
+        else if ( FFetchVariable( (BYTE *)( pinst->m_pver ), (BYTE **)&pver, sizeof(VER) + ( VER::cbrcehead * crcehead ) ) )
         {
             RCE * prceHead  = pver->GetChain( ulVERChecksum );
             dprintf( "Head of RCE hash chain: 0x%p\n", prceHead );
@@ -13550,7 +13556,7 @@ VOID EDBGVerHashSum( INST * pinstDebuggee, BOOL fVerbose )
             }
 
 
-            AssertEDBG( prceCurr->UiHash() == ( ircehead % pver->m_crceheadHashTable ) );
+            AssertEDBG( ( prceCurr->UiHash() % pver->m_crceheadHashTable ) == (UINT)ircehead );
             INT cnodeRCEs = 0;
             RCE * prceCurrNode = NULL;
             for ( RCE * prceCurrNodeDebuggee = prceCurrDebuggee; prceCurrNodeDebuggee; prceCurrNodeDebuggee = prceCurrNode->m_prcePrevOfNode )
@@ -16962,6 +16968,8 @@ VOID VER::Dump( CPRINTF * pcprintf, DWORD_PTR dwOffset ) const
     (*pcprintf)( FORMAT_VOID( VER, this, m_critBucketGlobal, dwOffset ) );
     (*pcprintf)( FORMAT_POINTER( VER, this, m_pbucketGlobalHead, dwOffset ) );
     (*pcprintf)( FORMAT_POINTER( VER, this, m_pbucketGlobalTail, dwOffset ) );
+    (*pcprintf)( FORMAT_INT( VER, this, m_cbucketslot, dwOffset ) );
+    (*pcprintf)( FORMAT_VOID( VER, this, m_rgbucketslot, dwOffset ) );
     (*pcprintf)( FORMAT_VOID( VER, this, m_cresBucket, dwOffset ) );
     (*pcprintf)( FORMAT_UINT( VER, this, m_cbBucket, dwOffset ) );
 
@@ -16974,6 +16982,10 @@ VOID VER::Dump( CPRINTF * pcprintf, DWORD_PTR dwOffset ) const
     (*pcprintf)( FORMAT_BOOL( VER, this, m_fSyncronousTasks, dwOffset ) );
 
     (*pcprintf)( FORMAT_UINT( VER, this, m_crceheadHashTable, dwOffset ) );
+    (*pcprintf)( FORMAT_UINT( VER, this, m_cbucketHashTable, dwOffset ) );
+    (*pcprintf)( FORMAT_UINT( VER, this, m_cbucketHashTableMax, dwOffset ) );
+    (*pcprintf)( FORMAT_UINT( VER, this, m_cHashBucketSplits, dwOffset ) );
+    (*pcprintf)( FORMAT_INT( VER, this, m_crceHashChainLongest, dwOffset ) );
     (*pcprintf)( FORMAT_VOID( VER, this, m_rectaskbatcher, dwOffset ) );
 }
 
@@ -17015,6 +17027,12 @@ VOID CResourceManager::Dump( CPRINTF * pcprintf, DWORD_PTR dwOffset ) const
     (*pcprintf)( FORMAT_BOOL_BF( CResourceManager, this, m_fPreserveFreed, dwOffset ) );
     (*pcprintf)( FORMAT_BOOL_BF( CResourceManager, this, m_fAllocFromHeap, dwOffset ) );
     (*pcprintf)( FORMAT_VOID( CResourceManager, this, m_critLARefiller, dwOffset ) );
+    (*pcprintf)( FORMAT_POINTER( CResourceManager, this, m_rgbMagazineCache, dwOffset ) );
+    (*pcprintf)( FORMAT_INT( CResourceManager, this, m_cMagazineCache, dwOffset ) );
+    (*pcprintf)( FORMAT_POINTER( CResourceManager, this, m_pMagazineFullList, dwOffset ) );
+    (*pcprintf)( FORMAT_POINTER( CResourceManager, this, m_pMagazineEmptyList, dwOffset ) );
+    (*pcprintf)( FORMAT_INT( CResourceManager, this, m_cMagazineFull, dwOffset ) );
+    (*pcprintf)( FORMAT_VOID( CResourceManager, this, m_critMagazineDepot, dwOffset ) );
     (*pcprintf)( FORMAT_VOID( CResourceManager, this, m_critInitTerm, dwOffset ) );
 }
 
@@ -8089,7 +8089,7 @@ ERR ErrOSDiskIIOThreadInit( void )
         err = ErrERRCheck( JET_errOutOfMemory );
         goto HandleError;
     }
-    Call( g_postaskmgrFile->ErrTMInit( 1 ) );
+    Call( g_postaskmgrFile->ErrTMInit( 1, NULL, fFalse, fTrue ) );
 
     return JET_errSuccess;
 
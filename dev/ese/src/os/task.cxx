@@ -4,8 +4,6 @@
 #include "osstd.hxx"
 
 
-LOCAL const BOOL            fCanUseIOCP         = fTrue;
-
 LOCAL const CHAR * const    szCritTaskList      = "CTaskManager::m_critTask";
 LOCAL const CHAR * const    szCritActiveThread  = "CTaskManager::m_critActiveThread";
 
@@ -23,6 +21,9 @@ CTaskManager::CTaskManager()
             m_critActivateThread( CLockBasicInfo( CSyncBasicInfo( szCritActiveThread ), rankCritTaskList, 0 ) ),
             m_semTaskDispatch( CSyncBasicInfo( szSemTaskDispatch ) ),
             m_rgpTaskNode( NULL ),
+            m_fUseIOCP( fFalse ),
+            m_ptaskringGlobal( NULL ),
+            m_cTaskOverflow( 0 ),
             m_cThread( 0 ),
             m_cThreadMax( 0 ),
             m_cPostedTasks( 0 ),
@@ -49,9 +50,87 @@ CTaskManager::~CTaskManager()
 
 
 
+template< ULONG cSlot >
+CTaskManager::CTaskRing< cSlot >::CTaskRing()
+    :   m_ulTail( 0 ),
+        m_ulHead( 0 )
+{
+    for ( ULONG iSlot = 0; iSlot < cSlot; iSlot++ )
+    {
+        m_rgslot[ iSlot ].ulSeq = iSlot;
+    }
+}
+
+template< ULONG cSlot >
+BOOL CTaskManager::CTaskRing< cSlot >::FTryPush( const TASK& task )
+{
+    ULONG ulPos = m_ulTail;
+
+    for ( ; ; )
+    {
+        SLOT * const    pslot   = &m_rgslot[ ulPos & ( cSlot - 1 ) ];
+        const LONG      lDiff   = LONG( pslot->ulSeq - ulPos );
+
+        if ( 0 == lDiff )
+        {
+            const ULONG ulPosT = AtomicCompareExchange( (ULONG *)&m_ulTail, ulPos, ulPos + 1 );
+            if ( ulPosT == ulPos )
+            {
+                pslot->task = task;
+                AtomicExchange( (LONG *)&pslot->ulSeq, LONG( ulPos + 1 ) );
+                return fTrue;
+            }
+            ulPos = ulPosT;
+        }
+        else if ( lDiff < 0 )
+        {
+            return fFalse;
+        }
+        else
+        {
+            ulPos = m_ulTail;
+        }
+    }
+}
+
+template< ULONG cSlot >
+BOOL CTaskManager::CTaskRing< cSlot >::FTryPop( TASK * const ptask )
+{
+    ULONG ulPos = m_ulHead;
+
+    for ( ; ; )
+    {
+        SLOT * const    pslot   = &m_rgslot[ ulPos & ( cSlot - 1 ) ];
+        const LONG      lDiff   = LONG( pslot->ulSeq - ( ulPos + 1 ) );
+
+        if ( 0 == lDiff )
+        {
+            const ULONG ulPosT = AtomicCompareExchange( (ULONG *)&m_ulHead, ulPos, ulPos + 1 );
+            if ( ulPosT == ulPos )
+            {
+                *ptask = pslot->task;
+                AtomicExchange( (LONG *)&pslot->ulSeq, LONG( ulPos + cSlot ) );
+                return fTrue;
+            }
+            ulPos = ulPosT;
+        }
+        else if ( lDiff < 0 )
+        {
+            return fFalse;
+        }
+        else
+        {
+            ulPos = m_ulHead;
+        }
+    }
+}
+
+
+
 ERR CTaskManager::ErrTMInit(    const ULONG                     cThread,
                                 const DWORD_PTR *const          rgThreadContext,
-                                const BOOL                      fForceMaxThreads )
+                                const BOOL                      fForceMaxThreads,
+                                const BOOL                      fUseIOCP )
 {
     ERR err;
 
@@ -61,13 +140,16 @@ ERR CTaskManager::ErrTMInit(    const ULONG                     cThread,
     Assert( 0 == m_semTaskDispatch.CAvail() );
     Assert( !m_rgpTaskNode );
     Assert( !m_hIOCPTaskDispatch );
+    Assert( !m_ptaskringGlobal );
+    Assert( 0 == m_cTaskOverflow );
 
 
+    m_fUseIOCP = fUseIOCP;
     m_cThread = 0;
     Alloc( m_rgThreadContext = new THREADCONTEXT[cThread] );
     memset( m_rgThreadContext, 0, sizeof( THREADCONTEXT ) * cThread );
 
-    if ( !fCanUseIOCP )
+    if ( !m_fUseIOCP )
     {
         ULONG iThread;
 
@@ -78,6 +160,9 @@ ERR CTaskManager::ErrTMInit(    const ULONG                     cThread,
         {
             Alloc( m_rgpTaskNode[iThread] = new CTaskNode() );
         }
+
+
+        Alloc( m_ptaskringGlobal = new TaskRingGlobal() );
     }
     else
     {
@@ -93,6 +178,11 @@ ERR CTaskManager::ErrTMInit(    const ULONG                     cThread,
     {
         m_rgThreadContext[iThread].dwThreadContext = rgThreadContext ? rgThreadContext[iThread] : NULL;
         m_rgThreadContext[iThread].ptm = this;
+
+        if ( !m_fUseIOCP )
+        {
+            Alloc( m_rgThreadContext[iThread].ptaskring = new TaskRingLocal() );
+        }
     }
 
     Assert( 0 == m_cThread );
@@ -121,9 +211,11 @@ VOID CTaskManager::TMTerm()
 {
     ULONG iThread;
     ULONG cThread;
+    ULONG cThreadContext;
 
 
     m_critActivateThread.Enter();
+    cThreadContext      = m_cThreadMax;
     m_cTasksThreshold   = 0xffffffff;
     m_cThreadMax        = 0;
     m_critActivateThread.Leave();
@@ -136,7 +228,7 @@ VOID CTaskManager::TMTerm()
 
         for ( iThread = 0; iThread < cThread; iThread++ )
         {
-            if ( fCanUseIOCP )
+            if ( m_fUseIOCP )
             {
                 ERR     errPost;
 
@@ -160,6 +252,7 @@ VOID CTaskManager::TMTerm()
 
                 m_critTask.Enter();
                 m_ilTask.InsertAsNextMost( m_rgpTaskNode[iThread] );
+                AtomicIncrement( (LONG *)&m_cTaskOverflow );
                 m_critTask.Leave();
                 m_semTaskDispatch.Release();
 
@@ -178,6 +271,19 @@ VOID CTaskManager::TMTerm()
         }
 
 
+        for ( iThread = 0; iThread < cThreadContext; iThread++ )
+        {
+            TaskRingLocal * const ptaskring = m_rgThreadContext[iThread].ptaskring;
+            if ( ptaskring )
+            {
+                TASK        task;
+                const BOOL  fTaskLeft = ptaskring->FTryPop( &task );
+                Assert( !fTaskLeft );
+                delete ptaskring;
+            }
+        }
+
+
         delete[] m_rgThreadContext;
     }
     m_rgThreadContext = NULL;
@@ -201,6 +307,16 @@ VOID CTaskManager::TMTerm()
 
         m_critTask.Leave();
     }
+    m_cTaskOverflow = 0;
+
+    if ( m_ptaskringGlobal )
+    {
+        TASK        task;
+        const BOOL  fTaskLeft = m_ptaskringGlobal->FTryPop( &task );
+        Assert( !fTaskLeft );
+        delete m_ptaskringGlobal;
+    }
+    m_ptaskringGlobal = NULL;
 
     Assert( 0 == m_semTaskDispatch.CAvail() );
     while ( m_semTaskDispatch.FTryAcquire() )
@@ -251,7 +367,7 @@ ERR CTaskManager::ErrTMPost(    CTaskManager::PfnCompletion pfnCompletion,
     }
 
 
-    if ( fCanUseIOCP )
+    if ( m_fUseIOCP )
     {
 
 
@@ -271,23 +387,11 @@ ERR CTaskManager::ErrTMPost(    CTaskManager::PfnCompletion pfnCompletion,
     }
     else
     {
-
-
-        CTaskNode *ptn = new CTaskNode();
-        if ( !ptn )
-        {
-            Error( ErrERRCheck( JET_errOutOfMemory ) );
-        }
-        ptn->m_pfnCompletion = pfnCompletion;
-        ptn->m_dwCompletionKey1 = dwCompletionKey1;
-        ptn->m_dwCompletionKey2 = dwCompletionKey2;
+        const TASK task = { pfnCompletion, dwCompletionKey1, dwCompletionKey2 };
 
         ETTaskManagerPost( this, pfnCompletion, dwCompletionKey1, (void*)dwCompletionKey2 );
 
-
-        m_critTask.Enter();
-        m_ilTask.InsertAsNextMost( ptn );
-        m_critTask.Leave();
+        Call( ErrTMIPush( task ) );
         m_semTaskDispatch.Release();
     }
 
@@ -312,7 +416,7 @@ BOOL CTaskManager::FTMRegisterFile( VOID *hFile, CTaskManager::PfnCompletion pfn
     Assert( m_pfnFileIOCompletion == NULL || m_pfnFileIOCompletion == pfnCompletion );
 
 
-    if ( !fCanUseIOCP )
+    if ( !m_fUseIOCP )
     {
         return fTrue;
     }
@@ -384,19 +488,21 @@ DWORD CTaskManager::TMDispatch( DWORD_PTR dwContext )
     ptc = (THREADCONTEXT *)dwContext;
 
 
-    ptc->ptm->TMIDispatch( ptc->dwThreadContext );
+    ptc->ptm->TMIDispatch( ptc );
 
     return 0;
 }
 
 
-VOID CTaskManager::TMIDispatch( const DWORD_PTR dwThreadContext )
+VOID CTaskManager::TMIDispatch( THREADCONTEXT * const ptc )
 {
     COMPLETIONPACKETINFO     cpi = { 0 };
+    const DWORD_PTR          dwThreadContext = ptc->dwThreadContext;
 
 
     Assert( !Postls()->fIsTaskThread );
     Postls()->fIsTaskThread = fTrue;
+    Postls()->pvTaskThreadContext = ptc;
 
 
     while ( Postls()->fIsTaskThread )
@@ -414,7 +520,7 @@ VOID CTaskManager::TMIDispatch( const DWORD_PTR dwThreadContext )
         OnNonRTM( cpi.dtickIdle     = Postls()->dtickTaskThreadIdle );
         OnNonRTM( cpi.pfnIdle       = Postls()->pfnTaskThreadIdle );
 
-        if ( fCanUseIOCP )
+        if ( m_fUseIOCP )
         {
 
 
@@ -507,28 +613,19 @@ VOID CTaskManager::TMIDispatch( const DWORD_PTR dwThreadContext )
         }
         else
         {
-            CTaskNode *ptn;
-
-
             if ( m_semTaskDispatch.FAcquire( Postls()->dtickTaskThreadIdle ? Postls()->dtickTaskThreadIdle : cmsecInfiniteNoDeadlock ) )
             {
+                TASK task;
 
-                m_critTask.Enter();
-                ptn = m_ilTask.PrevMost();
-                Assert( ptn );
-                m_ilTask.Remove( ptn );
-                m_critTask.Leave();
+                TMIPop( ptc, &task );
 
 
-                cpi.pfnCompletion       = ptn->m_pfnCompletion;
-                cpi.dwCompletionKey1    = ptn->m_dwCompletionKey1;
-                cpi.dwCompletionKey2    = ptn->m_dwCompletionKey2;
+                cpi.pfnCompletion       = task.pfnCompletion;
+                cpi.dwCompletionKey1    = task.dwCompletionKey1;
+                cpi.dwCompletionKey2    = task.dwCompletionKey2;
                 cpi.fDequeued           = fTrue;
                 cpi.gle                 = ERROR_SUCCESS;
                 cpi.tickComplete        = TickOSTimeCurrent();
-
-
-                delete ptn;
             }
             else
             {
@@ -589,6 +686,108 @@ VOID CTaskManager::TMIDispatch( const DWORD_PTR dwThreadContext )
 
     }
 
+    Postls()->pvTaskThreadContext = NULL;
+}
+
+
+
+//  tasks posted from one of our own workers go to its local ring, others to the global ring, and
+//  only when a ring is full do we fall back to the locked overflow list
+
+ERR CTaskManager::ErrTMIPush( const TASK& task )
+{
+    THREADCONTEXT * const ptc = (THREADCONTEXT *)Postls()->pvTaskThreadContext;
+
+    Assert( !m_fUseIOCP );
+
+    if ( ptc && ptc->ptm == this && ptc->ptaskring->FTryPush( task ) )
+    {
+        return JET_errSuccess;
+    }
+
+    if ( m_ptaskringGlobal->FTryPush( task ) )
+    {
+        return JET_errSuccess;
+    }
+
+    CTaskNode * const ptn = new CTaskNode();
+    if ( !ptn )
+    {
+        return ErrERRCheck( JET_errOutOfMemory );
+    }
+    ptn->m_pfnCompletion = task.pfnCompletion;
+    ptn->m_dwCompletionKey1 = task.dwCompletionKey1;
+    ptn->m_dwCompletionKey2 = task.dwCompletionKey2;
+
+    m_critTask.Enter();
+    m_ilTask.InsertAsNextMost( ptn );
+    AtomicIncrement( (LONG *)&m_cTaskOverflow );
+    m_critTask.Leave();
+
+    return JET_errSuccess;
+}
+
+
+
+//  our own ring first, then the global ring, then steal from the other workers, and finally the
+//  overflow list, which is also where TMTerm() queues the termination tasks
+
+VOID CTaskManager::TMIPop( THREADCONTEXT * const ptc, TASK * const ptask )
+{
+    const ULONG iThreadSelf = ULONG( ptc - m_rgThreadContext );
+
+    Assert( !m_fUseIOCP );
+
+    for ( ULONG cAttempt = 0; ; cAttempt++ )
+    {
+        if ( ptc->ptaskring->FTryPop( ptask ) )
+        {
+            return;
+        }
+
+        if ( m_ptaskringGlobal->FTryPop( ptask ) )
+        {
+            return;
+        }
+
+        const ULONG cThread = m_cThread;
+        for ( ULONG diThread = 1; diThread < cThread; diThread++ )
+        {
+            if ( m_rgThreadContext[ ( iThreadSelf + diThread ) % cThread ].ptaskring->FTryPop( ptask ) )
+            {
+                return;
+            }
+        }
+
+        if ( AtomicRead( (LONG *)&m_cTaskOverflow ) > 0 )
+        {
+            CTaskNode * ptn = NULL;
+
+            m_critTask.Enter();
+            if ( !m_ilTask.FEmpty() )
+            {
+                ptn = m_ilTask.PrevMost();
+                m_ilTask.Remove( ptn );
+                AtomicDecrement( (LONG *)&m_cTaskOverflow );
+            }
+            m_critTask.Leave();
+
+            if ( ptn )
+            {
+                ptask->pfnCompletion    = ptn->m_pfnCompletion;
+                ptask->dwCompletionKey1 = ptn->m_dwCompletionKey1;
+                ptask->dwCompletionKey2 = ptn->m_dwCompletionKey2;
+                delete ptn;
+                return;
+            }
+        }
+
+
+        //  the semaphore says a task has been published for us but a slot ahead of it in a ring
+        //  may still be in the middle of being published, so we just try again
+
+        UtilSleep( cAttempt < 64 ? 0 : 1 );
+    }
 }
 
 
@@ -641,17 +840,23 @@ ERR CTaskManager::ErrAddThreadCheck( const BOOL fForceMaxThreads )
         {
             do
             {
+                //  publish the new thread before it starts so that the other threads steal from its
+                //  local ring as soon as it can hold tasks
+
+                const ULONG iThread = m_cThread;
+                AtomicIncrement( (LONG *)&m_cThread );
+
                 err = ErrUtilThreadCreate(
                                 PUTIL_THREAD_PROC( TMDispatch ),
                                 OSMemoryPageReserveGranularity(),
                                 priorityNormal,
-                                &m_rgThreadContext[m_cThread].thread,
-                                DWORD_PTR( m_rgThreadContext + m_cThread ) );
+                                &m_rgThreadContext[iThread].thread,
+                                DWORD_PTR( m_rgThreadContext + iThread ) );
                 if ( err < JET_errSuccess )
+                {
+                    AtomicDecrement( (LONG *)&m_cThread );
                     break;
-
-
-                AtomicIncrement( (LONG *)&m_cThread );
+                }
 
 
                 if ( m_cThread == m_cThreadMax )
@@ -925,23 +1130,73 @@ void TaskInfoGeneric::NotifyPost ()
 {
     m_dwPostTick = TickOSTimeCurrent( );
     m_dwDispatchTick = m_dwEndTick = 0;
+    m_hrtPost = HrtHRTCount();
+    m_hrtDispatch = m_hrtEnd = 0;
 }
 
 void TaskInfoGeneric::NotifyDispatch ()
 {
     m_dwDispatchTick = TickOSTimeCurrent( );
+    m_hrtDispatch = HrtHRTCount();
 }
 
 void TaskInfoGeneric::NotifyEnd()
 {
     m_dwEndTick = TickOSTimeCurrent( );
+    m_hrtEnd = HrtHRTCount();
     m_pTaskInfoGenericStats->ReportTaskInfo( *this );
     delete this;
 }
 
 
+ULONG TaskInfoGenericStats::IBucketFromCusec( const QWORD cusec )
+{
+    if ( 0 == cusec )
+    {
+        return 0;
+    }
+
+    //  every latency past 2^32 usec lands in the last bucket anyway
+
+    return min( (ULONG)cLatencyBucket - 1, Log2( (ULONG)min( cusec, (QWORD)ulMax ) ) + 1 );
+}
+
+QWORD TaskInfoGenericStats::CusecPercentile( const LONG * const rgcBucket, const ULONG ulPermille )
+{
+    QWORD cSamples = 0;
+    for ( ULONG iBucket = 0; iBucket < cLatencyBucket; iBucket++ )
+    {
+        cSamples += (ULONG)rgcBucket[ iBucket ];
+    }
+
+    if ( 0 == cSamples )
+    {
+        return 0;
+    }
+
+    const QWORD cTarget = max( QWORD( 1 ), ( cSamples * ulPermille + 999 ) / 1000 );
+
+    QWORD cSeen = 0;
+    ULONG iBucket;
+    for ( iBucket = 0; iBucket < cLatencyBucket - 1; iBucket++ )
+    {
+        cSeen += (ULONG)rgcBucket[ iBucket ];
+        if ( cSeen >= cTarget )
+        {
+            break;
+        }
+    }
+
+    return iBucket ? ( QWORD( 1 ) << iBucket ) - 1 : 0;
+}
+
 void TaskInfoGenericStats::ReportTaskInfo(const TaskInfoGeneric & taskInfo)
 {
+    const QWORD cusecDispatch   = CusecHRTFromDhrt( taskInfo.m_hrtDispatch - taskInfo.m_hrtPost );
+    const QWORD cusecExecute    = CusecHRTFromDhrt( taskInfo.m_hrtEnd - taskInfo.m_hrtDispatch );
+
+    AtomicIncrement( (LONG *)&m_rgcDispatch[ IBucketFromCusec( cusecDispatch ) ] );
+    AtomicIncrement( (LONG *)&m_rgcExecute[ IBucketFromCusec( cusecExecute ) ] );
 
     Assert( taskInfo.m_dwDispatchTick >= taskInfo.m_dwPostTick);
     Assert( taskInfo.m_dwEndTick >= taskInfo.m_dwDispatchTick);
@@ -519,6 +519,17 @@ const DWORD DwUtilThreadId()
 }
 
 
+const QWORD CcycUtilThreadCPU()
+{
+    ULONG64 ccyc = 0;
+    if ( !QueryThreadCycleTime( GetCurrentThread(), &ccyc ) )
+    {
+        return 0;
+    }
+    return ccyc;
+}
+
+
 
 void OSThreadPostterm()
 {
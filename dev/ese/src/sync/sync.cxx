@@ -82,6 +82,91 @@ SYNCDeadLockTimeOutState g_sdltosState = sdltosEnabled;
 INT g_cSpinMax;
 
 
+const INT cSpinEstimate         = 4096;
+const INT cSpinAdaptiveMin      = 16;
+INT g_cSpinAdaptiveMax;
+volatile USHORT g_rgcSpinEstimate[ cSpinEstimate ];
+
+const INT cLockContentionStripe     = 16;
+const INT cLockContentionSample     = 256;
+
+struct LockContentionSample
+{
+    const void*     pvLock;
+    const void*     pvCallSite;
+    QWORD           dhrtWait;
+};
+
+struct LockContentionStripe
+{
+    volatile LONG           cCountdown;
+    volatile LONG           iSampleNext;
+    LockContentionSample    rgsample[ cLockContentionSample ];
+};
+
+volatile DWORD g_cLockContentionSampleRate = 1024;
+LockContentionStripe g_rglcstripe[ cLockContentionStripe ];
+
+const BOOL FOSSyncILockContentionSample();
+void OSSyncILockContentionRecord( const void* const pvLock, const void* const pvCallSite, const QWORD dhrtWait );
+
+
+#ifdef SYNC_ANALYZE_PERFORMANCE
+
+const INT cSpinHistoBucket      = 16;
+volatile QWORD g_rgcSpinAcquireHisto[ cSpinHistoBucket ];
+volatile QWORD g_cSpinPark;
+
+#endif
+
+
+inline volatile USHORT& CSpinEstimate( const void* const pv )
+{
+    const ULONG_PTR ul = ULONG_PTR( pv );
+    return g_rgcSpinEstimate[ ( ( ul >> 3 ) ^ ( ul >> 15 ) ) % cSpinEstimate ];
+}
+
+
+inline INT CSpinAdaptiveBudget( const void* const pv )
+{
+    if ( !g_cSpinMax )
+    {
+        return 0;
+    }
+
+    return min( 2 * INT( CSpinEstimate( pv ) ) + cSpinAdaptiveMin, g_cSpinAdaptiveMax );
+}
+
+
+inline void SpinAdaptiveAcquired( const void* const pv, const INT cSpun )
+{
+    volatile USHORT& cSpinEst = CSpinEstimate( pv );
+    const INT cSpinEstCur = cSpinEst;
+    cSpinEst = USHORT( cSpinEstCur + ( cSpun - cSpinEstCur ) / 8 );
+
+#ifdef SYNC_ANALYZE_PERFORMANCE
+    INT iBucket = 0;
+    for ( INT cSpunT = cSpun; cSpunT && iBucket < cSpinHistoBucket - 1; cSpunT >>= 1 )
+    {
+        iBucket++;
+    }
+    AtomicAdd( (QWORD*)&g_rgcSpinAcquireHisto[ iBucket ], 1 );
+#endif
+}
+
+
+inline void SpinAdaptiveParked( const void* const pv )
+{
+    volatile USHORT& cSpinEst = CSpinEstimate( pv );
+    const INT cSpinEstCur = cSpinEst;
+    cSpinEst = USHORT( cSpinEstCur - cSpinEstCur / 4 );
+
+#ifdef SYNC_ANALYZE_PERFORMANCE
+    AtomicAdd( (QWORD*)&g_cSpinPark, 1 );
+#endif
+}
+
+
 
 void* PvPageAlloc( const size_t cbSize, void* const pv );
 void* PvPageReserve( const size_t cbSize, void* const pv );
@@ -355,8 +440,33 @@ void CSemaphore::ReleaseAllWaiters()
 
 const BOOL CSemaphore::_FAcquire( const INT cmsecTimeout )
 {
+    return _FAcquire( cmsecTimeout, this, _ReturnAddress() );
+}
 
-    INT cSpin = g_cSpinMax;
+
+const BOOL CSemaphore::_FAcquire( const INT cmsecTimeout, const void* const pvLock, const void* const pvCallSite )
+{
+    if ( !FOSSyncILockContentionSample() )
+    {
+        return _FAcquireWait( cmsecTimeout );
+    }
+
+    const QWORD hrtStart = QwOSSyncIHRTCount();
+    const BOOL fAcquire = _FAcquireWait( cmsecTimeout );
+    if ( fAcquire )
+    {
+        OSSyncILockContentionRecord( pvLock, pvCallSite, QwOSSyncIHRTCount() - hrtStart );
+    }
+
+    return fAcquire;
+}
+
+
+const BOOL CSemaphore::_FAcquireWait( const INT cmsecTimeout )
+{
+
+    const INT cSpinBudget = CSpinAdaptiveBudget( this );
+    INT cSpin = cSpinBudget;
 
 
     CKernelSemaphorePool::IRKSEM irksemAlloc = CKernelSemaphorePool::irksemNil;
@@ -380,6 +490,9 @@ const BOOL CSemaphore::_FAcquire( const INT cmsecTimeout )
                 }
 
 
+                SpinAdaptiveAcquired( this, cSpinBudget - cSpin );
+
+
                 State().SetAcquire();
                 return fTrue;
             }
@@ -406,6 +519,8 @@ const BOOL CSemaphore::_FAcquire( const INT cmsecTimeout )
             if ( State().FChange( stateCur, CSemaphoreState( 1, irksemAlloc ) ) )
             {
 
+                SpinAdaptiveParked( this );
+
                 State().StartWait();
                 const BOOL fCompleted = g_ksempoolGlobal.Ksem( irksemAlloc, this ).FAcquire( cmsecTimeout );
                 State().StopWait();
@@ -586,7 +701,7 @@ const BOOL CSemaphore::_FAcquire( const INT cmsecTimeout )
 
 const BOOL CSemaphore::_FWait( const INT cmsecTimeout )
 {
-    if ( _FAcquire( cmsecTimeout ) )
+    if ( _FAcquire( cmsecTimeout, this, _ReturnAddress() ) )
     {
         Release();
         return fTrue;
@@ -2070,7 +2185,7 @@ void CReaderWriterLock::_EnterAsWriter( const ControlWord cwBIOld )
     State().AddAsWaiter( 0 );
     State().StartWait( 0 );
 
-    State().m_semWriter.Acquire();
+    State().m_semWriter.AcquireForLock( this, _ReturnAddress() );
 
     State().StopWait( 0 );
     State().RemoveAsWaiter( 0 );
@@ -2090,7 +2205,7 @@ void CReaderWriterLock::_EnterAsReader( const ControlWord cwBIOld )
     State().AddAsWaiter( 1 );
     State().StartWait( 1 );
 
-    State().m_semReader.Acquire();
+    State().m_semReader.AcquireForLock( this, _ReturnAddress() );
 
     State().StopWait( 1 );
     State().RemoveAsWaiter( 1 );
@@ -2803,7 +2918,6 @@ void* OSSYNCAPI OSSyncGetProcessorLocalStorage( const size_t iProc )
     return iProc < g_cProcessorMax ? g_rgPLS[ iProc ] : NULL;
 }
 
-#ifdef SYNC_ANALYZE_PERFORMANCE
 
 
 #if defined( _M_IX86 ) && defined( SYNC_USE_X86_ASM )
@@ -2838,10 +2952,8 @@ QWORD qwSyncHRTFreq;
 
 #define rdtsc __asm _emit 0x0f __asm _emit 0x31
 
-#endif
-
 
-BOOL IsRDTSCAvailable()
+static BOOL IsRDTSCAvailable()
 {
     static BOOL                     fRDTSCAvailable                 = fFalse;
 
@@ -2886,6 +2998,8 @@ NoIsProcessorFeaturePresent:
     return fRDTSCAvailable;
 }
 
+#endif
+
 
 static void OSSyncHRTIInit()
 {
@@ -2959,7 +3073,7 @@ static void OSSyncHRTIInit()
 }
 
 
-static QWORD OSSYNCAPI QwOSSyncIHRTFreq()
+QWORD OSSYNCAPI QwOSSyncIHRTFreq()
 {
     if ( g_hrttSync == hrttUninit )
     {
@@ -2970,7 +3084,7 @@ static QWORD OSSYNCAPI QwOSSyncIHRTFreq()
 }
 
 
-static QWORD OSSYNCAPI QwOSSyncIHRTCount()
+QWORD OSSYNCAPI QwOSSyncIHRTCount()
 {
     QWORD qw    = 0;
 
@@ -3013,11 +3127,135 @@ static QWORD OSSYNCAPI QwOSSyncIHRTCount()
     return qw;
 }
 
-#endif
 
 
 
 
+
+const BOOL FOSSyncILockContentionSample()
+{
+    const DWORD cSampleRate = g_cLockContentionSampleRate;
+    if ( !cSampleRate )
+    {
+        return fFalse;
+    }
+
+    LockContentionStripe* const plcstripe = &g_rglcstripe[ OSSyncGetCurrentProcessor() % cLockContentionStripe ];
+    if ( AtomicDecrement( (LONG*)&plcstripe->cCountdown ) > 0 )
+    {
+        return fFalse;
+    }
+
+    AtomicExchange( (LONG*)&plcstripe->cCountdown, LONG( cSampleRate ) );
+    return fTrue;
+}
+
+
+void OSSyncILockContentionRecord( const void* const pvLock, const void* const pvCallSite, const QWORD dhrtWait )
+{
+    LockContentionStripe* const plcstripe = &g_rglcstripe[ OSSyncGetCurrentProcessor() % cLockContentionStripe ];
+    const ULONG iSample = ULONG( AtomicIncrement( (LONG*)&plcstripe->iSampleNext ) - 1 ) % cLockContentionSample;
+
+    plcstripe->rgsample[ iSample ].pvLock       = pvLock;
+    plcstripe->rgsample[ iSample ].pvCallSite   = pvCallSite;
+    plcstripe->rgsample[ iSample ].dhrtWait     = dhrtWait;
+}
+
+
+void OSSYNCAPI OSSyncSetLockContentionSampleRate( const DWORD cSampleRate )
+{
+    AtomicExchange( (LONG*)&g_cLockContentionSampleRate, LONG( cSampleRate ) );
+}
+
+
+static INT __cdecl LockContentionICmpSite( const void* pv1, const void* pv2 )
+{
+    const OSSYNCLOCKCONTENTION* const plc1 = (const OSSYNCLOCKCONTENTION*)pv1;
+    const OSSYNCLOCKCONTENTION* const plc2 = (const OSSYNCLOCKCONTENTION*)pv2;
+
+    if ( plc1->pvLock != plc2->pvLock )
+    {
+        return plc1->pvLock < plc2->pvLock ? -1 : 1;
+    }
+    if ( plc1->pvCallSite != plc2->pvCallSite )
+    {
+        return plc1->pvCallSite < plc2->pvCallSite ? -1 : 1;
+    }
+    return 0;
+}
+
+
+static INT __cdecl LockContentionICmpWait( const void* pv1, const void* pv2 )
+{
+    const OSSYNCLOCKCONTENTION* const plc1 = (const OSSYNCLOCKCONTENTION*)pv1;
+    const OSSYNCLOCKCONTENTION* const plc2 = (const OSSYNCLOCKCONTENTION*)pv2;
+
+    if ( plc1->cusecWaitTotal != plc2->cusecWaitTotal )
+    {
+        return plc1->cusecWaitTotal > plc2->cusecWaitTotal ? -1 : 1;
+    }
+    return 0;
+}
+
+
+size_t OSSYNCAPI COSSyncGetLockContention( OSSYNCLOCKCONTENTION* const rglc, const size_t clcMax )
+{
+    const size_t clcSampleMax = cLockContentionStripe * cLockContentionSample;
+    OSSYNCLOCKCONTENTION* const rglcSample = (OSSYNCLOCKCONTENTION*)PvPageAlloc( sizeof( OSSYNCLOCKCONTENTION ) * clcSampleMax, NULL );
+    if ( !rglcSample )
+    {
+        return 0;
+    }
+
+    const QWORD qwHRTFreq = QwOSSyncIHRTFreq();
+
+    size_t clcSample = 0;
+    for ( INT ilcstripe = 0; ilcstripe < cLockContentionStripe; ilcstripe++ )
+    {
+        for ( INT iSample = 0; iSample < cLockContentionSample; iSample++ )
+        {
+            const LockContentionSample sample = g_rglcstripe[ ilcstripe ].rgsample[ iSample ];
+            if ( sample.pvLock )
+            {
+                const QWORD cusecWait = ( sample.dhrtWait * 1000000 ) / qwHRTFreq;
+                rglcSample[ clcSample ].pvLock          = sample.pvLock;
+                rglcSample[ clcSample ].pvCallSite      = sample.pvCallSite;
+                rglcSample[ clcSample ].cSamples        = 1;
+                rglcSample[ clcSample ].cusecWaitTotal  = cusecWait;
+                rglcSample[ clcSample ].cusecWaitMax    = cusecWait;
+                clcSample++;
+            }
+        }
+    }
+
+
+    qsort( rglcSample, clcSample, sizeof( OSSYNCLOCKCONTENTION ), LockContentionICmpSite );
+    size_t clcAggregate = 0;
+    for ( size_t ilcSample = 0; ilcSample < clcSample; ilcSample++ )
+    {
+        if ( clcAggregate && LockContentionICmpSite( &rglcSample[ clcAggregate - 1 ], &rglcSample[ ilcSample ] ) == 0 )
+        {
+            OSSYNCLOCKCONTENTION* const plc = &rglcSample[ clcAggregate - 1 ];
+            plc->cSamples++;
+            plc->cusecWaitTotal += rglcSample[ ilcSample ].cusecWaitTotal;
+            plc->cusecWaitMax = max( plc->cusecWaitMax, rglcSample[ ilcSample ].cusecWaitMax );
+        }
+        else
+        {
+            rglcSample[ clcAggregate++ ] = rglcSample[ ilcSample ];
+        }
+    }
+
+
+    qsort( rglcSample, clcAggregate, sizeof( OSSYNCLOCKCONTENTION ), LockContentionICmpWait );
+    const size_t clcReturned = min( clcAggregate, clcMax );
+    memcpy( rglc, rglcSample, sizeof( OSSYNCLOCKCONTENTION ) * clcReturned );
+
+    PageFree( rglcSample );
+    return clcReturned;
+}
+
+
 DWORD OSSYNCAPI DwOSSyncITickTime()
 {
 #pragma prefast(suppress:28159, "ESE has fixed all known 49-day-rollover problems, and GetTickCount64() is slower.")
@@ -5041,6 +5279,74 @@ void CReaderWriterLock::Dump( const CDumpContext& dc ) const
 
 
 
+CBigReaderWriterLock::CBigReaderWriterLock( const CLockBasicInfo& lbi )
+    :   m_fWriter( fFalse ),
+        m_rwlWriter( lbi ),
+        m_asigReadersDrained( CSyncBasicInfo( "CBigReaderWriterLock::m_asigReadersDrained" ) )
+{
+    C_ASSERT( sizeof( CReaderStripe ) == cbStripe );
+    OSSYNCAssert( 0 == DWORD_PTR( m_rgstripe ) % cbStripe );
+
+    for ( INT iStripe = 0; iStripe < cStripe; iStripe++ )
+    {
+        m_rgstripe[ iStripe ].m_cReader = 0;
+    }
+}
+
+
+CBigReaderWriterLock::~CBigReaderWriterLock()
+{
+    OSSYNCAssert( !m_fWriter );
+    OSSYNCAssert( _FReadersDrained() );
+}
+
+
+const BOOL CBigReaderWriterLock::_FReadersDrained() const
+{
+    for ( INT iStripe = 0; iStripe < cStripe; iStripe++ )
+    {
+        if ( m_rgstripe[ iStripe ].m_cReader != 0 )
+        {
+            return fFalse;
+        }
+    }
+
+    return fTrue;
+}
+
+
+void CBigReaderWriterLock::_WaitForReadersToDrain()
+{
+    OSSYNCAssert( m_fWriter );
+
+
+    for ( INT iStripe = 0; iStripe < cStripe; iStripe++ )
+    {
+        while ( m_rgstripe[ iStripe ].m_cReader != 0 )
+        {
+            m_asigReadersDrained.Wait();
+        }
+    }
+}
+
+
+void CBigReaderWriterLock::_WaitForWriter()
+{
+
+    m_rwlWriter.EnterAsReader();
+    m_rwlWriter.LeaveAsReader();
+}
+
+
+void CBigReaderWriterLock::Dump( const CDumpContext& dc ) const
+{
+    DumpMember( dc, m_fWriter );
+    DumpMember( dc, m_rgstripe );
+    DumpMember( dc, m_rwlWriter );
+    DumpMember( dc, m_asigReadersDrained );
+}
+
+
 void CMeteredSection::Dump( const CDumpContext& dc ) const
 {
     DumpMember( dc, m_pfnPartitionComplete );
@@ -5155,6 +5461,21 @@ void OSSyncStatsDump(   const char*         szTypeName,
 }
 
 
+#ifdef SYNC_DUMP_PERF_DATA
+
+void OSSyncSpinStatsDump()
+{
+    (*g_piprintfPerfData)( "\r\nSpin Count\tAcquire Count\r\n" );
+    for ( INT iBucket = 0; iBucket < cSpinHistoBucket; iBucket++ )
+    {
+        (*g_piprintfPerfData)( "%d\t%I64d\r\n", iBucket ? ( 1 << ( iBucket - 1 ) ) : 0, g_rgcSpinAcquireHisto[ iBucket ] );
+    }
+    (*g_piprintfPerfData)( "Park\t%I64d\r\n", g_cSpinPark );
+}
+
+#endif
+
+
 void CInitTermLock::SleepAwayQuanta()
 {
     Sleep( 0 );
@@ -5174,6 +5495,12 @@ static void OSSYNCAPI OSSyncICleanup()
 #ifdef SYNC_DUMP_PERF_DATA
 
 
+    if ( NULL != g_piprintfPerfData )
+    {
+        OSSyncSpinStatsDump();
+    }
+
+
     if ( NULL != g_piprintfPerfData )
     {
         ((CIPrintF*)g_piprintfPerfData)->~CIPrintF();
@@ -5339,6 +5666,15 @@ static BOOL FOSSyncIInit()
 
 
         g_cSpinMax = g_cProcessor == 1 ? 0 : 256;
+        g_cSpinAdaptiveMax = 4 * g_cSpinMax;
+        for ( INT ilcstripe = 0; ilcstripe < cLockContentionStripe; ilcstripe++ )
+        {
+            g_rglcstripe[ ilcstripe ].cCountdown = LONG( g_cLockContentionSampleRate );
+        }
+        for ( INT iSpinEstimate = 0; iSpinEstimate < cSpinEstimate; iSpinEstimate++ )
+        {
+            g_rgcSpinEstimate[ iSpinEstimate ] = USHORT( g_cSpinMax / 2 );
+        }
 
 #ifdef SYNC_DUMP_PERF_DATA
 